@@ -8,17 +8,55 @@
 
 // http://www.microsoft.com/msj/0797/win320797.aspx
 
+#include <glib.h>
+
 #include "Mutex.h"
 
 class GTKMutex : public Mutex {
 private:
-	virtual void Lock() {}
-	virtual void Unlock() {}
-	GTKMutex() {}
-	virtual ~GTKMutex() {}
+	GMutex *m;
+	virtual void Lock() { g_mutex_lock(m); }
+	virtual void Unlock() { g_mutex_unlock(m); }
+	GTKMutex() : m(g_mutex_new()) {}
+	virtual ~GTKMutex() { g_mutex_free(m); }
 	friend class Mutex;
 };
 
 Mutex *Mutex::Create() {
    return new GTKMutex();
 }
+
+class GTKEvent : public Event {
+private:
+	GMutex *m;
+	GCond *cond;
+	bool signalled;
+	virtual void Signal() {
+		g_mutex_lock(m);
+		signalled = true;
+		g_cond_signal(cond);
+		g_mutex_unlock(m);
+	}
+	virtual bool Wait(int milliseconds) {
+		GTimeVal end;
+		g_get_current_time(&end);
+		g_time_val_add(&end, milliseconds * 1000L);
+		g_mutex_lock(m);
+		while (!signalled && g_cond_timed_wait(cond, m, &end)) {
+		}
+		const bool wasSignalled = signalled;
+		signalled = false;
+		g_mutex_unlock(m);
+		return wasSignalled;
+	}
+	GTKEvent() : m(g_mutex_new()), cond(g_cond_new()), signalled(false) {}
+	virtual ~GTKEvent() {
+		g_cond_free(cond);
+		g_mutex_free(m);
+	}
+	friend class Event;
+};
+
+Event *Event::Create() {
+   return new GTKEvent();
+}
@@ -150,18 +150,28 @@ void Menu::Show(Point pt, Window &) {
 		gtk_get_current_event_time());
 }
 
-ElapsedTime::ElapsedTime() {
+// Seconds and microseconds from a clock that is not changed by setting the time of day
+static void CurrentTime(long &seconds, long &microseconds) {
+#if GLIB_CHECK_VERSION(2,28,0)
+	const gint64 now = g_get_monotonic_time();
+	seconds = static_cast<long>(now / G_USEC_PER_SEC);
+	microseconds = static_cast<long>(now % G_USEC_PER_SEC);
+#else
 	GTimeVal curTime;
 	g_get_current_time(&curTime);
-	bigBit = curTime.tv_sec;
-	littleBit = curTime.tv_usec;
+	seconds = curTime.tv_sec;
+	microseconds = curTime.tv_usec;
+#endif
+}
+
+ElapsedTime::ElapsedTime() {
+	CurrentTime(bigBit, littleBit);
 }
 
 double ElapsedTime::Duration(bool reset) {
-	GTimeVal curTime;
-	g_get_current_time(&curTime);
-	long endBigBit = curTime.tv_sec;
-	long endLittleBit = curTime.tv_usec;
+	long endBigBit;
+	long endLittleBit;
+	CurrentTime(endBigBit, endLittleBit);
 	double result = 1000000.0 * (endBigBit - bigBit);
 	result += endLittleBit - littleBit;
 	result /= 1000000.0;
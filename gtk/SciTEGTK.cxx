@@ -63,6 +63,7 @@
 #include "Widget.h"
 #include "Cookie.h"
 #include "Worker.h"
+#include "StartupProfile.h"
 #include "SciTEBase.h"
 #include "SciTEKeys.h"
 #include "StripDefinition.h"
@@ -1180,6 +1181,8 @@ void SciTEGTK::ReadPropertiesInitial() {
 void SciTEGTK::ReadProperties() {
 	SciTEBase::ReadProperties();
 
+	RecordingReads recording(readsOther);
+
 	CallChildren(SCI_SETRECTANGULARSELECTIONMODIFIER,
 		props.GetInt("rectangular.selection.modifier", SCMOD_CTRL));
 
@@ -2493,7 +2496,7 @@ void SciTEGTK::ResetExecution() {
 	icmd = 0;
 	jobQueue.SetExecuting(false);
 	if (needReadProperties)
-		ReadProperties();
+		ReadChangedProperties();
 	CheckReload();
 	CheckMenus();
 	jobQueue.ClearJobs();
@@ -3847,6 +3850,8 @@ void SciTEGTK::CreateMenu() {
 	                                      {"/Search/Incrementa_l Search", "<control><alt>I", menuSig, IDM_INCSEARCH, 0},
 	                                      {"/Search/sep3", NULL, NULL, 0, "<Separator>"},
 	                                      {"/Search/_Go To...", "<control>G", menuSig, IDM_GOTO, 0},
+	                                      {"/Search/Go To _Definition", "<control><shift>G", menuSig, IDM_GOTODEFINITION, 0},
+	                                      {"/Search/_Tags...", "", menuSig, IDM_LISTTAGS, 0},
 	                                      {"/Search/Next Book_mark", "F2", menuSig, IDM_BOOKMARK_NEXT, 0},
 	                                      {"/Search/Pre_vious Bookmark", "<shift>F2", menuSig, IDM_BOOKMARK_PREV, 0},
 	                                      {"/Search/Toggle Bookmar_k", "<control>F2", menuSig, IDM_BOOKMARK_TOGGLE, 0},
@@ -5196,13 +5201,19 @@ void SciTEGTK::Run(int argc, char *argv[]) {
 		}
 	}
 
-	CreateUI();
+	{
+		StartupPhase phase("CreateUI");
+		CreateUI();
+	}
 	if ((props.Get("ipc.director.name").size() == 0) && props.GetInt ("check.if.already.open"))
 		unlink(uniqueInstance); // Unlock.
 
 	// Process remaining switches and files
 	gdk_threads_enter();
-	ProcessCommandLine(args, 1);
+	{
+		StartupPhase phase("ProcessCommandLine");
+		ProcessCommandLine(args, 1);
+	}
 	gdk_threads_leave();
 
 	CheckMenus();
@@ -5210,6 +5221,8 @@ void SciTEGTK::Run(int argc, char *argv[]) {
 	SetFocus(wEditor);
 	gtk_widget_grab_focus(GTK_WIDGET(PWidget(wSciTE)));
 
+	StartupProfile::Report();
+
 	gdk_threads_enter();
 	gtk_main();
 	gdk_threads_leave();
@@ -17,6 +17,7 @@ SciTEGTK.o: SciTEGTK.cxx \
  ../src/Extender.h DirectorExtension.h ../src/LuaExtension.h \
  ../src/SciTE.h ../src/Mutex.h ../src/JobQueue.h pixmapsGNOME.h SciIcon.h \
  Widget.h ../src/Cookie.h ../src/Worker.h ../src/SciTEBase.h \
+ ../src/StartupProfile.h \
  ../src/SciTEKeys.h
 Widget.o: Widget.cxx \
  ../../scintilla/include/Scintilla.h ../src/GUI.h ../src/StringHelpers.h \
@@ -46,36 +47,51 @@ JobQueue.o: ../src/JobQueue.cxx ../../scintilla/include/Scintilla.h \
  ../src/GUI.h ../src/SString.h ../src/FilePath.h ../src/SciTE.h \
  ../src/Mutex.h ../src/JobQueue.h
 LuaExtension.o: ../src/LuaExtension.cxx \
- ../../scintilla/include/Scintilla.h ../src/GUI.h ../src/SString.h \
+ ../../scintilla/include/Scintilla.h ../../scintilla/include/ILexer.h \
+ ../src/GUI.h ../src/SString.h \
  ../src/FilePath.h ../src/StyleWriter.h ../src/Extender.h \
  ../src/LuaExtension.h ../src/IFaceTable.h ../src/SciTEKeys.h \
  ../lua/include/lua.h ../lua/include/luaconf.h ../lua/include/lualib.h \
- ../lua/include/lua.h ../lua/include/lauxlib.h
+ ../lua/include/lua.h ../src/StartupProfile.h \
+ ../src/Cookie.h \
+ ../src/Mutex.h \
+ ../src/Worker.h \
+ ../src/FileWorker.h \
+ ../lua/include/lauxlib.h
 MultiplexExtension.o: ../src/MultiplexExtension.cxx \
  ../../scintilla/include/Scintilla.h ../src/GUI.h \
  ../src/MultiplexExtension.h ../src/Extender.h
 PropSetFile.o: ../src/PropSetFile.cxx ../../scintilla/include/Scintilla.h \
- ../src/GUI.h ../src/SString.h ../src/FilePath.h ../src/PropSetFile.h
+ ../src/GUI.h ../src/SString.h ../src/FilePath.h ../src/StartupProfile.h \
+ ../src/Mutex.h ../src/Worker.h ../src/ImportPrefetch.h ../src/PropSetFile.h
 SciTEBase.o: ../src/SciTEBase.cxx \
  ../../scintilla/include/Scintilla.h ../../scintilla/include/SciLexer.h \
  ../../scintilla/include/ILexer.h ../src/GUI.h ../src/SString.h \
  ../src/StringList.h ../src/StringHelpers.h ../src/FilePath.h \
  ../src/PropSetFile.h ../src/StyleWriter.h ../src/Extender.h \
  ../src/SciTE.h ../src/Mutex.h ../src/JobQueue.h ../src/Cookie.h \
- ../src/Worker.h ../src/FileWorker.h ../src/SciTEBase.h
+ ../src/Worker.h ../src/FileWorker.h ../src/WordIndex.h \
+ ../src/FuzzyMatch.h \
+ ../src/APICache.h \
+ ../src/MappedFile.h \
+ ../src/TagFile.h \
+ ../src/ImportPrefetch.h \
+ ../src/SciTEBase.h
 SciTEBuffers.o: ../src/SciTEBuffers.cxx \
  ../../scintilla/include/Scintilla.h ../../scintilla/include/SciLexer.h \
  ../../scintilla/include/ILexer.h ../src/GUI.h ../src/SString.h \
  ../src/StringList.h ../src/StringHelpers.h ../src/FilePath.h \
  ../src/PropSetFile.h ../src/StyleWriter.h ../src/Extender.h \
  ../src/SciTE.h ../src/Mutex.h ../src/JobQueue.h ../src/Cookie.h \
- ../src/Worker.h ../src/FileWorker.h ../src/SciTEBase.h
+ ../src/Worker.h ../src/FileWorker.h ../src/StartupProfile.h \
+ ../src/SciTEBase.h
 SciTEIO.o: ../src/SciTEIO.cxx \
  ../../scintilla/include/Scintilla.h ../../scintilla/include/ILexer.h \
  ../src/GUI.h ../src/SString.h ../src/StringList.h ../src/StringHelpers.h \
  ../src/FilePath.h ../src/PropSetFile.h ../src/StyleWriter.h \
  ../src/Extender.h ../src/SciTE.h ../src/Mutex.h ../src/JobQueue.h \
  ../src/Cookie.h ../src/Worker.h ../src/FileWorker.h ../src/SciTEBase.h \
+ ../src/TagFile.h \
  ../src/Utf8_16.h
 SciTEProps.o: ../src/SciTEProps.cxx ../../scintilla/include/Scintilla.h \
  ../../scintilla/include/SciLexer.h ../../scintilla/include/ILexer.h \
@@ -83,10 +99,40 @@ SciTEProps.o: ../src/SciTEProps.cxx ../../scintilla/include/Scintilla.h \
  ../src/StringList.h ../src/StringHelpers.h ../src/FilePath.h \
  ../src/PropSetFile.h ../src/StyleWriter.h ../src/Extender.h \
  ../src/SciTE.h ../src/IFaceTable.h ../src/Mutex.h ../src/JobQueue.h \
- ../src/Cookie.h ../src/Worker.h ../src/SciTEBase.h
+ ../src/Cookie.h ../src/Worker.h ../src/FuzzyMatch.h \
+ ../src/APICache.h \
+ ../src/MappedFile.h \
+ ../src/PropertiesCache.h \
+ ../src/StartupProfile.h \
+ ../src/ImportPrefetch.h \
+ ../src/SciTEBase.h
 StringHelpers.o: ../src/StringHelpers.cxx \
  ../../scintilla/include/Scintilla.h ../src/GUI.h ../src/StringHelpers.h
 StringList.o: ../src/StringList.cxx ../src/SString.h ../src/StringList.h
+WordIndex.o: ../src/WordIndex.cxx ../src/Mutex.h ../src/FuzzyMatch.h \
+ ../src/WordIndex.h
+FuzzyMatch.o: ../src/FuzzyMatch.cxx ../src/FuzzyMatch.h
+APICache.o: ../src/APICache.cxx ../../scintilla/include/Scintilla.h \
+ ../src/GUI.h ../src/SString.h ../src/StringList.h ../src/MappedFile.h \
+ ../src/APICache.h
+MappedFile.o: ../src/MappedFile.cxx ../../scintilla/include/Scintilla.h \
+ ../src/GUI.h ../src/MappedFile.h
+TagFile.o: ../src/TagFile.cxx ../../scintilla/include/Scintilla.h \
+ ../../scintilla/include/ILexer.h ../src/GUI.h ../src/SString.h \
+ ../src/FilePath.h ../src/Cookie.h ../src/Worker.h ../src/FileWorker.h \
+ ../src/MappedFile.h ../src/Mutex.h \
+ ../src/TagFile.h
+PropertiesCache.o: ../src/PropertiesCache.cxx \
+ ../../scintilla/include/Scintilla.h ../src/GUI.h ../src/SString.h \
+ ../src/FilePath.h ../src/PropSetFile.h ../src/MappedFile.h \
+ ../src/PropertiesCache.h ../src/SciTE.h
+StartupProfile.o: ../src/StartupProfile.cxx \
+ ../../scintilla/include/Scintilla.h ../src/GUI.h \
+ ../src/StartupProfile.h ../src/SciTE.h
+ImportPrefetch.o: ../src/ImportPrefetch.cxx \
+ ../../scintilla/include/Scintilla.h ../src/GUI.h ../src/SString.h \
+ ../src/FilePath.h ../src/PropSetFile.h ../src/Mutex.h ../src/Worker.h \
+ ../src/ImportPrefetch.h
 StyleWriter.o: ../src/StyleWriter.cxx ../../scintilla/include/Scintilla.h \
  ../src/GUI.h ../src/StyleWriter.h
 Utf8_16.o: ../src/Utf8_16.cxx ../src/Utf8_16.h
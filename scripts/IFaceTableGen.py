@@ -174,6 +174,121 @@ properties - a sorted list of (name, property), where property is a
 	return (constants, funclist, proplist)
 
 
+def HashBytes(seed, data):
+	"""FNV-1a hash of a sequence of byte values with a final mix, matching HashBytes in IFaceTable.cxx."""
+	h = seed or 0x811C9DC5
+	for b in data:
+		h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+	# Mix the bits so that keys differing in only a few bits spread over the table
+	h ^= h >> 16
+	h = (h * 0x85EBCA6B) & 0xFFFFFFFF
+	h ^= h >> 13
+	h = (h * 0xC2B2AE35) & 0xFFFFFFFF
+	h ^= h >> 16
+	return h
+
+def HashName(seed, name):
+	return HashBytes(seed, bytearray(name.encode("ascii")))
+
+def HashValue(seed, value):
+	value = value & 0xFFFFFFFF
+	return HashBytes(seed, [value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, value >> 24])
+
+def PerfectHash(keys, hashFunction):
+	"""Returns (displacements, slots) for a minimal perfect hash of keys by "hash and displace".
+A key hashes with seed 0 to a displacement d.  When d is negative the key is in
+slot -d-1, otherwise it hashes with seed d to its slot.  Each slot holds the index
+of its key so a lookup need only compare against one key."""
+	size = len(keys)
+	assert len(set(keys)) == size, "keys must be unique"
+	buckets = [[] for i in range(size)]
+	for i, key in enumerate(keys):
+		buckets[hashFunction(0, key) % size].append(i)
+	displacements = [0] * size
+	slots = [-1] * size
+	order = sorted(range(size), key=lambda b: (-len(buckets[b]), b))
+	for b in order:
+		items = buckets[b]
+		if len(items) <= 1:
+			break
+		d = 1
+		while True:
+			tried = [hashFunction(d, keys[i]) % size for i in items]
+			if len(set(tried)) == len(items) and all(slots[t] == -1 for t in tried):
+				break
+			d += 1
+		displacements[b] = d
+		for i, t in zip(items, tried):
+			slots[t] = i
+	free = [t for t in range(size) if slots[t] == -1]
+	for b in order:
+		if len(buckets[b]) == 1:
+			t = free.pop(0)
+			displacements[b] = -t-1
+			slots[t] = buckets[b][0]
+	return displacements, slots
+
+def printIntArray(name, values, out):
+	out.write("\nstatic const int %s[] = {" % name)
+	for i, v in enumerate(values):
+		if i % 16 == 0:
+			out.write("\n\t")
+		else:
+			out.write(" ")
+		out.write("%d," % v)
+	out.write("\n};\n")
+
+def printIFaceHashTables(constants, functions, properties, out):
+	"""Write perfect hash tables so that names and values are found without searching."""
+
+	out.write("\n// The SCI_ constant of each function, used instead of upper-casing its name.\n")
+	out.write("static const char * const ifaceFunctionConstants[] = {")
+	for name, features in functions:
+		out.write('\n\t"SCI_%s",' % name.upper())
+	out.write("\n};\n")
+
+	names = [name for name, features in constants]
+	displacements, slots = PerfectHash(names, HashName)
+	printIntArray("constantDisplacements", displacements, out)
+	printIntArray("constantSlots", slots, out)
+
+	names = [name for name, features in functions]
+	displacements, slots = PerfectHash(names, HashName)
+	printIntArray("functionDisplacements", displacements, out)
+	printIntArray("functionSlots", slots, out)
+
+	names = ["SCI_" + name.upper() for name, features in functions]
+	displacements, slots = PerfectHash(names, HashName)
+	printIntArray("functionConstantDisplacements", displacements, out)
+	printIntArray("functionConstantSlots", slots, out)
+
+	names = [name for name, prop in properties]
+	displacements, slots = PerfectHash(names, HashName)
+	printIntArray("propertyDisplacements", displacements, out)
+	printIntArray("propertySlots", slots, out)
+
+	# Each value has the first function with that value or, when there is none,
+	# the first constant.  Functions are stored as their index and constants as -1-index.
+	valueNames = {}
+	values = []
+	for i, (name, features) in enumerate(functions):
+		value = int(features["Value"], 0)
+		if value not in valueNames:
+			valueNames[value] = i
+			values.append(value)
+	for i, (name, features) in enumerate(constants):
+		value = int(features["Value"], 0)
+		if value not in valueNames:
+			valueNames[value] = -1-i
+			values.append(value)
+	displacements, slots = PerfectHash(values, HashValue)
+	printIntArray("valueDisplacements", displacements, out)
+	printIntArray("valueSlots", [valueNames[values[t]] for t in slots], out)
+
+	out.write("\nenum {\n")
+	out.write("\tvalueCount = %d\n" % len(values))
+	out.write("};\n\n")
+
 def printIFaceTableCXXFile(faceAndIDs, out):
 	f, ids = faceAndIDs
 	(constants, functions, properties) = GetScriptableInterface(f)
@@ -247,7 +362,9 @@ def printIFaceTableCXXFile(faceAndIDs, out):
 	out.write("\tifaceFunctionCount = %d,\n" % len(functions))
 	out.write("\tifaceConstantCount = %d,\n" % len(constants))
 	out.write("\tifacePropertyCount = %d\n" % len(properties))
-	out.write("};\n\n")
+	out.write("};\n")
+
+	printIFaceHashTables(constants, functions, properties, out)
 
 def convertStringResult(s):
 	if s == "stringresult":
@@ -414,9 +531,10 @@ def ReadMenuIDs(filename):
 		f.close()
 	return ids
 
-f = Face.Face()
-f.ReadFromFile(srcRoot + "/scintilla/include/Scintilla.iface")
-menuIDs  = ReadMenuIDs(srcRoot + "/scite/src/SciTE.h")
-idsInOrder = idsFromDocumentation(srcRoot + "/scintilla/doc/ScintillaDoc.html")
-Regenerate(srcRoot + "/scite/src/IFaceTable.cxx", printIFaceTableCXXFile, [f, menuIDs])
-Regenerate(srcRoot + "/scite/doc/PaneAPI.html", printIFaceTableHTMLFile, [f, menuIDs, idsInOrder])
+if __name__ == "__main__":
+	f = Face.Face()
+	f.ReadFromFile(srcRoot + "/scintilla/include/Scintilla.iface")
+	menuIDs  = ReadMenuIDs(srcRoot + "/scite/src/SciTE.h")
+	idsInOrder = idsFromDocumentation(srcRoot + "/scintilla/doc/ScintillaDoc.html")
+	Regenerate(srcRoot + "/scite/src/IFaceTable.cxx", printIFaceTableCXXFile, [f, menuIDs])
+	Regenerate(srcRoot + "/scite/doc/PaneAPI.html", printIFaceTableHTMLFile, [f, menuIDs, idsInOrder])
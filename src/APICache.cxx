@@ -0,0 +1,198 @@
+// SciTE - Scintilla based Text Editor
+/** @file APICache.cxx
+ ** Implementation of a memory mapped cache of the words of a set of API files.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+// Turn off MS dislike of POSIX
+#pragma warning(disable: 4996)
+#endif
+
+#include "Scintilla.h"
+
+#include "GUI.h"
+#include "SString.h"
+#include "StringList.h"
+#include "MappedFile.h"
+#include "APICache.h"
+
+static const char cacheMagic[8] = { 'S', 'c', 'i', 'T', 'E', 'A', 'P', 'I' };
+// Increment when the layout changes
+static const unsigned int cacheVersion = 1;
+// Differs when read on a machine with other byte order
+static const unsigned int cacheByteOrder = 0x01020304;
+
+/**
+ * The file starts with this header followed by the signature, the text of the words
+ * separated by NULs and then the offsets of the words sorted with and without case.
+ * Each section starts at a multiple of 4 bytes.
+ */
+struct CacheHeader {
+	char magic[8];
+	unsigned int version;
+	unsigned int byteOrder;
+	unsigned int signatureLength;
+	unsigned int listLength;
+	unsigned int words;
+	unsigned int onlyLineEnds;
+};
+
+static inline size_t RoundUp4(size_t length) {
+	return (length + 3) & ~static_cast<size_t>(3);
+}
+
+static inline size_t ListStart(const CacheHeader &header) {
+	return RoundUp4(sizeof(CacheHeader) + header.signatureLength);
+}
+
+static inline size_t OffsetsStart(const CacheHeader &header) {
+	return RoundUp4(ListStart(header) + header.listLength);
+}
+
+static bool WritePadded(FILE *fp, const void *data, size_t length) {
+	static const char padding[4] = { 0, 0, 0, 0 };
+	const size_t lengthPadding = RoundUp4(length) - length;
+	return (fwrite(data, 1, length, fp) == length) &&
+		(fwrite(padding, 1, lengthPadding, fp) == lengthPadding);
+}
+
+static bool WriteOffsets(FILE *fp, char **words, int len, const char *list) {
+	std::vector<unsigned int> offsets(len);
+	for (int i = 0; i < len; i++)
+		offsets[i] = static_cast<unsigned int>(words[i] - list);
+	return (len == 0) || (fwrite(&offsets[0], sizeof(unsigned int), len, fp) == static_cast<size_t>(len));
+}
+
+/// Point to each word, rejecting offsets outside the list as the file may be damaged.
+static char **WordsFromOffsets(const unsigned int *offsets, unsigned int words, char *list, unsigned int listLength) {
+	char **wordPointers = new char *[words + 1];
+	for (unsigned int i = 0; i < words; i++) {
+		if (offsets[i] >= listLength) {
+			delete []wordPointers;
+			return 0;
+		}
+		wordPointers[i] = list + offsets[i];
+	}
+	// Sentinel points at the terminating NUL as from StringList::SetFromAllocated
+	wordPointers[words] = list + listLength - 1;
+	return wordPointers;
+}
+
+/**
+ * Describe the API files by name, size and modification time so that a cache built
+ * from different files or from earlier versions of the files is not used.
+ */
+std::string APICache::Signature(const std::vector<std::string> &apiFileNames) {
+	std::string signature;
+	for (std::vector<std::string>::const_iterator it = apiFileNames.begin(); it != apiFileNames.end(); ++it) {
+		struct stat statusFile;
+		if (stat(it->c_str(), &statusFile) == -1)
+			continue;
+		char stamp[100];
+		sprintf(stamp, "%ld %ld ", static_cast<long>(statusFile.st_size),
+			static_cast<long>(statusFile.st_mtime));
+		signature += stamp;
+		signature += *it;
+		signature += '\n';
+	}
+	return signature;
+}
+
+void APICache::Close() {
+	file.Close();
+}
+
+/**
+ * Set @a list to the words in the cache file if it was built for the same API files
+ * with the same list options.
+ */
+bool APICache::Load(const char *cacheFileName, const std::string &signature, StringList &list) {
+	// Writable pages so a write through the list's char pointers cannot fault
+	if (!file.Open(GUI::StringFromUTF8(cacheFileName).c_str(), true))
+		return false;
+	char *data = file.Data();
+	const size_t size = file.Size();
+	if (size < sizeof(CacheHeader)) {
+		Close();
+		return false;
+	}
+	CacheHeader header;
+	memcpy(&header, data, sizeof(header));
+	if ((memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0) ||
+		(header.version != cacheVersion) ||
+		(header.byteOrder != cacheByteOrder) ||
+		(header.onlyLineEnds != (list.onlyLineEnds ? 1u : 0u)) ||
+		(header.signatureLength != signature.length()) ||
+		(header.listLength == 0) ||
+		(size < OffsetsStart(header) + 2 * static_cast<size_t>(header.words) * sizeof(unsigned int)) ||
+		(memcmp(data + sizeof(CacheHeader), signature.c_str(), signature.length()) != 0)) {
+		Close();
+		return false;
+	}
+	char *listText = data + ListStart(header);
+	if (listText[header.listLength - 1] != '\0') {
+		Close();
+		return false;
+	}
+	const unsigned int *offsets = reinterpret_cast<const unsigned int *>(data + OffsetsStart(header));
+	char **words = WordsFromOffsets(offsets, header.words, listText, header.listLength);
+	char **wordsNoCase = WordsFromOffsets(offsets + header.words, header.words, listText, header.listLength);
+	if (!words || !wordsNoCase) {
+		delete []words;
+		delete []wordsNoCase;
+		Close();
+		return false;
+	}
+	list.SetFromSorted(listText, words, wordsNoCase, header.words);
+	return true;
+}
+
+/**
+ * Write the words of @a list, sorting it first, to a cache file.
+ * The file is written under a temporary name then renamed so that other
+ * instances never see a partial file.
+ */
+bool APICache::Save(const char *cacheFileName, const std::string &signature, StringList &list) {
+	if (!list.words)
+		return false;
+	list.Sort();
+	CacheHeader header;
+	memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+	header.version = cacheVersion;
+	header.byteOrder = cacheByteOrder;
+	header.signatureLength = static_cast<unsigned int>(signature.length());
+	header.listLength = static_cast<unsigned int>(list.words[list.len] - list.list + 1);
+	header.words = list.len;
+	header.onlyLineEnds = list.onlyLineEnds ? 1 : 0;
+
+	std::string tempName = cacheFileName;
+	tempName += ".new";
+	FILE *fp = fopen(tempName.c_str(), "wb");
+	if (!fp)
+		return false;
+	bool ok = (fwrite(&header, sizeof(header), 1, fp) == 1) &&
+		WritePadded(fp, signature.c_str(), signature.length()) &&
+		WritePadded(fp, list.list, header.listLength) &&
+		WriteOffsets(fp, list.words, list.len, list.list) &&
+		WriteOffsets(fp, list.wordsNoCase, list.len, list.list);
+	if (fclose(fp) != 0)
+		ok = false;
+	if (ok) {
+		remove(cacheFileName);
+		ok = rename(tempName.c_str(), cacheFileName) == 0;
+	}
+	if (!ok)
+		remove(tempName.c_str());
+	return ok;
+}
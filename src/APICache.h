@@ -0,0 +1,27 @@
+// SciTE - Scintilla based Text Editor
+/** @file APICache.h
+ ** Definition of a memory mapped cache of the words of a set of API files.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef APICACHE_H
+#define APICACHE_H
+
+/**
+ * A file holding the words of a set of API files already split and sorted, with and
+ * without case, so they can be used without reading, splitting and sorting the API files.
+ * The file records the size and modification time of each API file and is only used
+ * while they match. It is mapped into memory and the StringList loaded from it points
+ * into the mapping so the APICache must be closed after the StringList is cleared.
+ */
+class APICache {
+	MappedFile file;
+public:
+	static std::string Signature(const std::vector<std::string> &apiFileNames);
+	bool Load(const char *cacheFileName, const std::string &signature, StringList &list);
+	static bool Save(const char *cacheFileName, const std::string &signature, StringList &list);
+	void Close();
+};
+
+#endif
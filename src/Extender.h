@@ -11,6 +11,7 @@
 #include "Scintilla.h"
 
 class StyleWriter;
+struct Worker;
 
 class ExtensionAPI {
 public:
@@ -34,6 +35,8 @@ public:
 	virtual void UserStripSet(int control, const char *value)=0;
 	virtual void UserStripSetList(int control, const char *value)=0;
 	virtual const char *UserStripValue(int control)=0;
+	virtual bool PerformOnNewThread(Worker *pWorker)=0;
+	virtual void PostOnMainThread(int cmd, Worker *pWorker)=0;
 };
 
 /**
@@ -76,6 +79,7 @@ public:
 	virtual bool OnDwellStart(int, const char *) { return false; }
 	virtual bool OnClose(const char *) { return false; }
 	virtual bool OnUserStrip(int /* control */, int /* change */) { return false; }
+	virtual bool OnWorker(Worker *) { return false; }
 };
 
 #endif
@@ -282,6 +282,10 @@ static int unlink(const wchar_t *filename) {
 	return _wunlink(filename);
 }
 
+static int rename(const wchar_t *oldname, const wchar_t *newname) {
+	return _wrename(oldname, newname);
+}
+
 static int access(const wchar_t *path, int mode) {
 	return _waccess(path, mode);
 }
@@ -449,6 +453,11 @@ void FilePath::Remove() const {
 	unlink(AsInternal());
 }
 
+/// Fails when @a newName exists on Windows, so callers replacing a file remove it first.
+bool FilePath::Rename(const FilePath &newName) const {
+	return rename(AsInternal(), newName.AsInternal()) == 0;
+}
+
 #ifndef R_OK
 // Microsoft does not define the constants used to call access
 #define R_OK 4
@@ -692,9 +701,21 @@ std::string CommandExecute(const GUI::gui_char *command, const GUI::gui_char *di
 	::CloseHandle(hWriteSubProcess);
 
 #else
-	FilePath startDirectory= FilePath::GetWorkingDirectory();	// Save
-	FilePath(directoryForRun).SetWorkingDirectory();
-	FILE *fp = popen(command, "r");
+	// Change directory in the shell rather than in this process so that this
+	// may be called from a thread without disturbing other threads
+	std::string commandInDirectory;
+	if (*directoryForRun) {
+		commandInDirectory = "cd '";
+		for (const char *s = directoryForRun; *s; s++) {
+			if (*s == '\'')
+				commandInDirectory += "'\\''";
+			else
+				commandInDirectory += *s;
+		}
+		commandInDirectory += "' && ";
+	}
+	commandInDirectory += command;
+	FILE *fp = popen(commandInDirectory.c_str(), "r");
 	if (fp) {
 		size_t lenData = fread(buffer, 1, sizeof(buffer), fp);
 		while (lenData > 0) {
@@ -703,7 +724,6 @@ std::string CommandExecute(const GUI::gui_char *command, const GUI::gui_char *di
 		}
 		pclose(fp);
 	}
-	startDirectory.SetWorkingDirectory();
 #endif
 	return output;
 }
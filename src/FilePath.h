@@ -72,6 +72,7 @@ public:
 	void List(FilePathSet &directories, FilePathSet &files);
 	FILE *Open(const GUI::gui_char *mode) const;
 	void Remove() const;
+	bool Rename(const FilePath &newName) const;
 	time_t ModifiedTime() const;
 	long GetFileLength() const;
 	bool Exists() const;
@@ -67,5 +67,7 @@ enum {
 	WORK_FILEREAD = 1,
 	WORK_FILEWRITTEN = 2,
 	WORK_FILEPROGRESS = 3,
+	WORK_TAGSREFRESHED = 4,
+	WORK_EXTENSION = 5,
 	WORK_PLATFORM = 100
 };
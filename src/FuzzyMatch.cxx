@@ -0,0 +1,216 @@
+// SciTE - Scintilla based Text Editor
+/** @file FuzzyMatch.cxx
+ ** Implementation of subsequence matching and ranking of completion candidates.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "FuzzyMatch.h"
+
+static inline char MakeLowerCase(char ch) {
+	if (ch < 'A' || ch > 'Z')
+		return ch;
+	else
+		return static_cast<char>(ch - 'A' + 'a');
+}
+
+static inline bool IsLowerCase(char ch) {
+	return (ch >= 'a') && (ch <= 'z');
+}
+
+static inline bool IsUpperCase(char ch) {
+	return (ch >= 'A') && (ch <= 'Z');
+}
+
+static inline bool IsDigit(char ch) {
+	return (ch >= '0') && (ch <= '9');
+}
+
+static inline bool IsAlphaNumeric(char ch) {
+	return IsLowerCase(ch) || IsUpperCase(ch) || IsDigit(ch) ||
+		(static_cast<unsigned char>(ch) >= 0x80);
+}
+
+/**
+ * Summarise the characters of a string as one bit per letter, ignoring case,
+ * with further bits for digits, '_' and groups of other characters.
+ */
+unsigned int FuzzyCharacterMask(const char *s, size_t len) {
+	unsigned int mask = 0;
+	for (size_t i = 0; i < len; i++) {
+		const char ch = MakeLowerCase(s[i]);
+		if (IsLowerCase(ch))
+			mask |= 1u << (ch - 'a');
+		else if (IsDigit(ch))
+			mask |= 1u << 26;
+		else if (ch == '_')
+			mask |= 1u << 27;
+		else
+			mask |= 1u << (28 + (static_cast<unsigned char>(ch) & 3));
+	}
+	return mask;
+}
+
+/// Is the character at @a pos the start of the word or of one of its parts?
+static bool IsHump(const char *word, size_t pos) {
+	if (pos == 0)
+		return true;
+	const char ch = word[pos];
+	const char chPrev = word[pos - 1];
+	if (!IsAlphaNumeric(chPrev))
+		return IsAlphaNumeric(ch);
+	if (IsUpperCase(ch) && IsLowerCase(chPrev))
+		return true;
+	return IsDigit(ch) != IsDigit(chPrev);
+}
+
+FuzzyPattern::FuzzyPattern(const char *pattern_, size_t len) {
+	if (len > maxLength)
+		len = maxLength;
+	pattern.assign(pattern_, len);
+	patternLower = pattern;
+	for (size_t i = 0; i < len; i++)
+		patternLower[i] = MakeLowerCase(patternLower[i]);
+	mask = FuzzyCharacterMask(pattern_, len);
+}
+
+/**
+ * Return -1 when @a word does not contain the pattern as a subsequence,
+ * otherwise a score that is higher for better matches.
+ */
+int FuzzyPattern::Score(const char *word, size_t len) const {
+	const size_t lenPattern = patternLower.length();
+	if (len < lenPattern)
+		return -1;
+	if (lenPattern == 0)
+		return 0;
+
+	// Matching from the end finds the last position each pattern character can take
+	// while still leaving room for the rest. This also rejects non-matches.
+	size_t latest[maxLength];
+	size_t j = len;
+	for (size_t i = lenPattern; i-- > 0;) {
+		do {
+			if (j == 0)
+				return -1;
+			j--;
+		} while (MakeLowerCase(word[j]) != patternLower[i]);
+		latest[i] = j;
+	}
+
+	// Take each character immediately after the previous one when possible, else at
+	// the next hump, else at the next occurrence.
+	int score = 0;
+	size_t pos = 0;
+	for (size_t i = 0; i < lenPattern; i++) {
+		const char chPattern = patternLower[i];
+		size_t chosen = latest[i];
+		if ((i > 0) && (MakeLowerCase(word[pos]) == chPattern)) {
+			chosen = pos;
+		} else {
+			bool found = false;
+			for (size_t p = pos; p <= latest[i]; p++) {
+				if ((MakeLowerCase(word[p]) == chPattern) && IsHump(word, p)) {
+					chosen = p;
+					found = true;
+					break;
+				}
+			}
+			for (size_t q = pos; !found && (q <= latest[i]); q++) {
+				if (MakeLowerCase(word[q]) == chPattern) {
+					chosen = q;
+					found = true;
+				}
+			}
+		}
+		score += 1;
+		if (chosen == 0)
+			score += 8;
+		else if (IsHump(word, chosen))
+			score += 6;
+		if ((i > 0) && (chosen == pos))
+			score += 4;
+		score -= static_cast<int>(std::min<size_t>(chosen - pos, 3));
+		if (word[chosen] == pattern[i])
+			score += 1;
+		pos = chosen + 1;
+	}
+	// Prefer shorter words as less remains to be typed
+	score -= static_cast<int>(std::min<size_t>(len - lenPattern, 16)) / 2;
+	return std::max(score, 0);
+}
+
+void FuzzyCandidates::Add(const char *word, size_t len) {
+	masks.push_back(FuzzyCharacterMask(word, len));
+	words.push_back(word);
+	lengths.push_back(len);
+}
+
+FuzzyRanking::FuzzyRanking(const FuzzyPattern &pattern_, const std::vector<std::string> &recent_) :
+	pattern(pattern_), recent(recent_) {
+}
+
+/// Higher scores first then shorter words then alphabetical so equal words are adjacent.
+bool FuzzyRanking::Better(const Match &a, const Match &b) {
+	if (a.score != b.score)
+		return a.score > b.score;
+	if (a.len != b.len)
+		return a.len < b.len;
+	return memcmp(a.word, b.word, a.len) < 0;
+}
+
+void FuzzyRanking::Consider(const char *word, size_t len, unsigned int mask) {
+	if (!pattern.MayMatch(mask))
+		return;
+	int score = pattern.Score(word, len);
+	if (score < 0)
+		return;
+	// recent is ordered from the most recent
+	for (size_t r = 0; r < recent.size(); r++) {
+		if ((recent[r].length() == len) && (memcmp(recent[r].c_str(), word, len) == 0)) {
+			score += 2 * static_cast<int>(recent.size() - r);
+			break;
+		}
+	}
+	Match match;
+	match.score = score;
+	match.word = word;
+	match.len = len;
+	matches.push_back(match);
+}
+
+void FuzzyRanking::Consider(const FuzzyCandidates &candidates) {
+	const size_t size = candidates.Size();
+	for (size_t i = 0; i < size; i++) {
+		if (pattern.MayMatch(candidates.Mask(i)))
+			Consider(candidates.Word(i), candidates.Length(i), candidates.Mask(i));
+	}
+}
+
+/**
+ * Return up to @a maxWords distinct words, best first.
+ * When @a maxWords is 0, return all of them.
+ */
+std::vector<std::string> FuzzyRanking::Best(size_t maxWords) {
+	// A word may be considered twice, from different sources, so sort enough for that
+	size_t sortLength = matches.size();
+	if (maxWords && (sortLength > 2 * maxWords))
+		sortLength = 2 * maxWords;
+	std::partial_sort(matches.begin(), matches.begin() + sortLength, matches.end(), Better);
+	std::vector<std::string> best;
+	for (size_t i = 0; i < sortLength; i++) {
+		if ((i > 0) && (matches[i].len == matches[i-1].len) &&
+			(memcmp(matches[i].word, matches[i-1].word, matches[i].len) == 0))
+			continue;
+		best.push_back(std::string(matches[i].word, matches[i].len));
+		if (maxWords && (best.size() >= maxWords))
+			break;
+	}
+	return best;
+}
@@ -0,0 +1,86 @@
+// SciTE - Scintilla based Text Editor
+/** @file FuzzyMatch.h
+ ** Definition of subsequence matching and ranking of completion candidates.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef FUZZYMATCH_H
+#define FUZZYMATCH_H
+
+unsigned int FuzzyCharacterMask(const char *s, size_t len);
+
+/**
+ * A pattern typed by the user that matches any word containing its characters
+ * in order, ignoring case. Matches are scored so that those at the start of the
+ * word, at camelCase or snake_case humps and in contiguous runs rank first.
+ */
+class FuzzyPattern {
+	std::string pattern;
+	std::string patternLower;
+	unsigned int mask;
+public:
+	enum { maxLength = 64 };
+	FuzzyPattern(const char *pattern_, size_t len);
+	size_t Length() const {
+		return pattern.length();
+	}
+	/// Quick rejection: a word can only match if it has all of the pattern's characters.
+	bool MayMatch(unsigned int maskWord) const {
+		return (maskWord & mask) == mask;
+	}
+	int Score(const char *word, size_t len) const;
+};
+
+/**
+ * Words to be matched with their character masks computed once.
+ * The masks are kept apart from the words so rejecting candidates reads little memory.
+ * The text of the words is not copied so must outlive the list.
+ */
+class FuzzyCandidates {
+	std::vector<unsigned int> masks;
+	std::vector<const char *> words;
+	std::vector<size_t> lengths;
+public:
+	void Clear() {
+		masks.clear();
+		words.clear();
+		lengths.clear();
+	}
+	void Add(const char *word, size_t len);
+	size_t Size() const {
+		return masks.size();
+	}
+	unsigned int Mask(size_t index) const {
+		return masks[index];
+	}
+	const char *Word(size_t index) const {
+		return words[index];
+	}
+	size_t Length(size_t index) const {
+		return lengths[index];
+	}
+};
+
+/**
+ * Collects the words matching a pattern and returns the best of them.
+ * Words recently chosen by the user are given a bonus.
+ */
+class FuzzyRanking {
+	struct Match {
+		int score;
+		const char *word;
+		size_t len;
+	};
+	static bool Better(const Match &a, const Match &b);
+	const FuzzyPattern &pattern;
+	const std::vector<std::string> &recent;
+	std::vector<Match> matches;
+public:
+	FuzzyRanking(const FuzzyPattern &pattern_, const std::vector<std::string> &recent_);
+	void Consider(const char *word, size_t len, unsigned int mask);
+	void Consider(const FuzzyCandidates &candidates);
+	std::vector<std::string> Best(size_t maxWords);
+};
+
+#endif
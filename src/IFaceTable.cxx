@@ -7,124 +7,6 @@
 
 #include "IFaceTable.h"
 #include <string.h>
-#include <ctype.h>
-
-int IFaceTable::FindConstant(const char *name) {
-	int lo = 0;
-	int hi = IFaceTable::constantCount - 1;
-	do {
-		int idx = (lo+hi)/2;
-		int cmp = strcmp(name, constants[idx].name);
-
-		if (cmp > 0) {
-			lo = idx + 1;
-		} else if (cmp < 0) {
-			hi = idx - 1;
-		} else {
-			return idx;
-		}
-	} while (lo <= hi);
-
-	return -1;
-}
-
-int IFaceTable::FindFunction(const char *name) {
-	int lo = 0;
-	int hi = IFaceTable::functionCount - 1;
-	do {
-		int idx = (lo+hi)/2;
-		int cmp = strcmp(name, functions[idx].name);
-		if (cmp > 0) {
-			lo = idx + 1;
-		} else if (cmp < 0) {
-			hi = idx - 1;
-		} else {
-			return idx;
-		}
-	} while (lo <= hi);
-
-	return -1;
-}
-
-int IFaceTable::FindFunctionByConstantName(const char *name) {
-	if (strncmp(name, "SCI_", 4)==0) {
-		// This looks like a constant for an iface function.  This requires
-		// a sequential search.  Take special care since the function names
-		// are mixed case, whereas the constants are all-caps.
-
-		for (int idx = 0; idx < functionCount; ++idx) {
-			const char *nm = name+4;
-			const char *fn = IFaceTable::functions[idx].name;
-			while (*nm && *fn && (*nm == toupper(*fn))) {
-				++nm;
-				++fn;
-			}
-			if (!*nm && !*fn) {
-				return idx;
-			}
-		}
-	}
-	return -1;
-}
-
-int IFaceTable::FindProperty(const char *name) {
-	int lo = 0;
-	int hi = IFaceTable::propertyCount - 1;
-	do {
-		int idx = (lo+hi)/2;
-		int cmp = strcmp(name, properties[idx].name);
-
-		if (cmp > 0) {
-			lo = idx + 1;
-		} else if (cmp < 0) {
-			hi = idx - 1;
-		} else {
-			return idx;
-		}
-	} while (lo <= hi);
-
-	return -1;
-}
-
-int IFaceTable::GetConstantName(int value, char *nameOut, unsigned nameBufferLen) {
-	if (nameOut && nameBufferLen > 0) {
-		*nameOut = '\0';
-	}
-
-	// Look in both the constants table and the functions table.  Start with functions.
-	for (int funcIdx = 0; funcIdx < functionCount; ++funcIdx) {
-		if (functions[funcIdx].value == value) {
-			int len = static_cast<int>(strlen(functions[funcIdx].name)) + 4;
-			if (nameOut && (static_cast<int>(nameBufferLen) > len)) {
-				strcpy(nameOut, "SCI_");
-				strcat(nameOut, functions[funcIdx].name);
-				// fix case
-				for (char *nm = nameOut + 4; *nm; ++nm) {
-					if (*nm >= 'a' && *nm <= 'z') {
-						*nm = static_cast<char>(*nm - 'a' + 'A');
-					}
-				}
-				return len;
-			} else {
-				return -1 - len;
-			}
-		}
-	}
-
-	for (int constIdx = 0; constIdx < constantCount; ++constIdx) {
-		if (constants[constIdx].value == value) {
-			int len = static_cast<int>(strlen(constants[constIdx].name));
-			if (nameOut && (static_cast<int>(nameBufferLen) > len)) {
-				strcpy(nameOut, constants[constIdx].name);
-				return len;
-			} else {
-				return -1 - len;
-			}
-		}
-	}
-
-	return 0;
-}
 
 #if defined(__GNUC__)
 #if (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 7))
@@ -201,6 +83,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"IDM_FULLSCREEN",961},
 	{"IDM_GO",303},
 	{"IDM_GOTO",220},
+	{"IDM_GOTODEFINITION",264},
 	{"IDM_HELP",901},
 	{"IDM_HELP_SCITE",903},
 	{"IDM_IMPORT",1300},
@@ -209,6 +92,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"IDM_JOIN",248},
 	{"IDM_LANGUAGE",1400},
 	{"IDM_LINENUMBERMARGIN",407},
+	{"IDM_LISTTAGS",265},
 	{"IDM_LOADSESSION",132},
 	{"IDM_LWRCASE",241},
 	{"IDM_MACROLIST",314},
@@ -2968,10 +2852,824 @@ static IFaceProperty ifaceProperties[] = {
 
 enum {
 	ifaceFunctionCount = 270,
-	ifaceConstantCount = 2356,
+	ifaceConstantCount = 2358,
 	ifacePropertyCount = 197
 };
 
+// The SCI_ constant of each function, used instead of upper-casing its name.
+static const char * const ifaceFunctionConstants[] = {
+	"SCI_ADDREFDOCUMENT",
+	"SCI_ADDSELECTION",
+	"SCI_ADDSTYLEDTEXT",
+	"SCI_ADDTEXT",
+	"SCI_ADDUNDOACTION",
+	"SCI_ALLOCATE",
+	"SCI_ANNOTATIONCLEARALL",
+	"SCI_APPENDTEXT",
+	"SCI_ASSIGNCMDKEY",
+	"SCI_AUTOCACTIVE",
+	"SCI_AUTOCCANCEL",
+	"SCI_AUTOCCOMPLETE",
+	"SCI_AUTOCPOSSTART",
+	"SCI_AUTOCSELECT",
+	"SCI_AUTOCSHOW",
+	"SCI_AUTOCSTOPS",
+	"SCI_BACKTAB",
+	"SCI_BEGINUNDOACTION",
+	"SCI_BRACEBADLIGHT",
+	"SCI_BRACEBADLIGHTINDICATOR",
+	"SCI_BRACEHIGHLIGHT",
+	"SCI_BRACEHIGHLIGHTINDICATOR",
+	"SCI_BRACEMATCH",
+	"SCI_CALLTIPACTIVE",
+	"SCI_CALLTIPCANCEL",
+	"SCI_CALLTIPPOSSTART",
+	"SCI_CALLTIPSETHLT",
+	"SCI_CALLTIPSHOW",
+	"SCI_CANPASTE",
+	"SCI_CANREDO",
+	"SCI_CANUNDO",
+	"SCI_CANCEL",
+	"SCI_CHANGELEXERSTATE",
+	"SCI_CHARLEFT",
+	"SCI_CHARLEFTEXTEND",
+	"SCI_CHARLEFTRECTEXTEND",
+	"SCI_CHARPOSITIONFROMPOINT",
+	"SCI_CHARPOSITIONFROMPOINTCLOSE",
+	"SCI_CHARRIGHT",
+	"SCI_CHARRIGHTEXTEND",
+	"SCI_CHARRIGHTRECTEXTEND",
+	"SCI_CHOOSECARETX",
+	"SCI_CLEAR",
+	"SCI_CLEARALL",
+	"SCI_CLEARALLCMDKEYS",
+	"SCI_CLEARCMDKEY",
+	"SCI_CLEARDOCUMENTSTYLE",
+	"SCI_CLEARREGISTEREDIMAGES",
+	"SCI_CLEARSELECTIONS",
+	"SCI_COLOURISE",
+	"SCI_CONTRACTEDFOLDNEXT",
+	"SCI_CONVERTEOLS",
+	"SCI_COPY",
+	"SCI_COPYALLOWLINE",
+	"SCI_COPYRANGE",
+	"SCI_COPYTEXT",
+	"SCI_COUNTCHARACTERS",
+	"SCI_CREATEDOCUMENT",
+	"SCI_CREATELOADER",
+	"SCI_CUT",
+	"SCI_DELLINELEFT",
+	"SCI_DELLINERIGHT",
+	"SCI_DELWORDLEFT",
+	"SCI_DELWORDRIGHT",
+	"SCI_DELWORDRIGHTEND",
+	"SCI_DELETEBACK",
+	"SCI_DELETEBACKNOTLINE",
+	"SCI_DELETERANGE",
+	"SCI_DESCRIBEKEYWORDSETS",
+	"SCI_DESCRIBEPROPERTY",
+	"SCI_DOCLINEFROMVISIBLE",
+	"SCI_DOCUMENTEND",
+	"SCI_DOCUMENTENDEXTEND",
+	"SCI_DOCUMENTSTART",
+	"SCI_DOCUMENTSTARTEXTEND",
+	"SCI_EDITTOGGLEOVERTYPE",
+	"SCI_EMPTYUNDOBUFFER",
+	"SCI_ENCODEDFROMUTF8",
+	"SCI_ENDUNDOACTION",
+	"SCI_ENSUREVISIBLE",
+	"SCI_ENSUREVISIBLEENFORCEPOLICY",
+	"SCI_FINDCOLUMN",
+	"SCI_FINDINDICATORFLASH",
+	"SCI_FINDINDICATORHIDE",
+	"SCI_FINDINDICATORSHOW",
+	"SCI_FINDTEXT",
+	"SCI_FORMFEED",
+	"SCI_FORMATRANGE",
+	"SCI_GETCURLINE",
+	"SCI_GETHOTSPOTACTIVEBACK",
+	"SCI_GETHOTSPOTACTIVEFORE",
+	"SCI_GETLASTCHILD",
+	"SCI_GETLINE",
+	"SCI_GETLINESELENDPOSITION",
+	"SCI_GETLINESELSTARTPOSITION",
+	"SCI_GETRANGEPOINTER",
+	"SCI_GETSELTEXT",
+	"SCI_GETSTYLEDTEXT",
+	"SCI_GETTEXT",
+	"SCI_GETTEXTRANGE",
+	"SCI_GOTOLINE",
+	"SCI_GOTOPOS",
+	"SCI_GRABFOCUS",
+	"SCI_HIDELINES",
+	"SCI_HIDESELECTION",
+	"SCI_HOME",
+	"SCI_HOMEDISPLAY",
+	"SCI_HOMEDISPLAYEXTEND",
+	"SCI_HOMEEXTEND",
+	"SCI_HOMERECTEXTEND",
+	"SCI_HOMEWRAP",
+	"SCI_HOMEWRAPEXTEND",
+	"SCI_INDICATORALLONFOR",
+	"SCI_INDICATORCLEARRANGE",
+	"SCI_INDICATOREND",
+	"SCI_INDICATORFILLRANGE",
+	"SCI_INDICATORSTART",
+	"SCI_INDICATORVALUEAT",
+	"SCI_INSERTTEXT",
+	"SCI_LINECOPY",
+	"SCI_LINECUT",
+	"SCI_LINEDELETE",
+	"SCI_LINEDOWN",
+	"SCI_LINEDOWNEXTEND",
+	"SCI_LINEDOWNRECTEXTEND",
+	"SCI_LINEDUPLICATE",
+	"SCI_LINEEND",
+	"SCI_LINEENDDISPLAY",
+	"SCI_LINEENDDISPLAYEXTEND",
+	"SCI_LINEENDEXTEND",
+	"SCI_LINEENDRECTEXTEND",
+	"SCI_LINEENDWRAP",
+	"SCI_LINEENDWRAPEXTEND",
+	"SCI_LINEFROMPOSITION",
+	"SCI_LINELENGTH",
+	"SCI_LINESCROLL",
+	"SCI_LINESCROLLDOWN",
+	"SCI_LINESCROLLUP",
+	"SCI_LINETRANSPOSE",
+	"SCI_LINEUP",
+	"SCI_LINEUPEXTEND",
+	"SCI_LINEUPRECTEXTEND",
+	"SCI_LINESJOIN",
+	"SCI_LINESSPLIT",
+	"SCI_LOADLEXERLIBRARY",
+	"SCI_LOWERCASE",
+	"SCI_MARGINTEXTCLEARALL",
+	"SCI_MARKERADD",
+	"SCI_MARKERADDSET",
+	"SCI_MARKERDEFINE",
+	"SCI_MARKERDEFINEPIXMAP",
+	"SCI_MARKERDEFINERGBAIMAGE",
+	"SCI_MARKERDELETE",
+	"SCI_MARKERDELETEALL",
+	"SCI_MARKERDELETEHANDLE",
+	"SCI_MARKERENABLEHIGHLIGHT",
+	"SCI_MARKERGET",
+	"SCI_MARKERLINEFROMHANDLE",
+	"SCI_MARKERNEXT",
+	"SCI_MARKERPREVIOUS",
+	"SCI_MARKERSYMBOLDEFINED",
+	"SCI_MOVECARETINSIDEVIEW",
+	"SCI_MOVESELECTEDLINESDOWN",
+	"SCI_MOVESELECTEDLINESUP",
+	"SCI_NEWLINE",
+	"SCI_NULL",
+	"SCI_PAGEDOWN",
+	"SCI_PAGEDOWNEXTEND",
+	"SCI_PAGEDOWNRECTEXTEND",
+	"SCI_PAGEUP",
+	"SCI_PAGEUPEXTEND",
+	"SCI_PAGEUPRECTEXTEND",
+	"SCI_PARADOWN",
+	"SCI_PARADOWNEXTEND",
+	"SCI_PARAUP",
+	"SCI_PARAUPEXTEND",
+	"SCI_PASTE",
+	"SCI_POINTXFROMPOSITION",
+	"SCI_POINTYFROMPOSITION",
+	"SCI_POSITIONAFTER",
+	"SCI_POSITIONBEFORE",
+	"SCI_POSITIONFROMLINE",
+	"SCI_POSITIONFROMPOINT",
+	"SCI_POSITIONFROMPOINTCLOSE",
+	"SCI_PRIVATELEXERCALL",
+	"SCI_PROPERTYNAMES",
+	"SCI_PROPERTYTYPE",
+	"SCI_REDO",
+	"SCI_REGISTERIMAGE",
+	"SCI_REGISTERRGBAIMAGE",
+	"SCI_RELEASEDOCUMENT",
+	"SCI_REPLACESEL",
+	"SCI_REPLACETARGET",
+	"SCI_REPLACETARGETRE",
+	"SCI_ROTATESELECTION",
+	"SCI_SCROLLCARET",
+	"SCI_SCROLLTOEND",
+	"SCI_SCROLLTOSTART",
+	"SCI_SEARCHANCHOR",
+	"SCI_SEARCHINTARGET",
+	"SCI_SEARCHNEXT",
+	"SCI_SEARCHPREV",
+	"SCI_SELECTALL",
+	"SCI_SELECTIONDUPLICATE",
+	"SCI_SETCHARSDEFAULT",
+	"SCI_SETEMPTYSELECTION",
+	"SCI_SETFOLDMARGINCOLOUR",
+	"SCI_SETFOLDMARGINHICOLOUR",
+	"SCI_SETHOTSPOTACTIVEBACK",
+	"SCI_SETHOTSPOTACTIVEFORE",
+	"SCI_SETLENGTHFORENCODE",
+	"SCI_SETSAVEPOINT",
+	"SCI_SETSEL",
+	"SCI_SETSELBACK",
+	"SCI_SETSELFORE",
+	"SCI_SETSELECTION",
+	"SCI_SETSTYLING",
+	"SCI_SETSTYLINGEX",
+	"SCI_SETTEXT",
+	"SCI_SETVISIBLEPOLICY",
+	"SCI_SETWHITESPACEBACK",
+	"SCI_SETWHITESPACEFORE",
+	"SCI_SETXCARETPOLICY",
+	"SCI_SETYCARETPOLICY",
+	"SCI_SHOWLINES",
+	"SCI_STARTRECORD",
+	"SCI_STARTSTYLING",
+	"SCI_STOPRECORD",
+	"SCI_STUTTEREDPAGEDOWN",
+	"SCI_STUTTEREDPAGEDOWNEXTEND",
+	"SCI_STUTTEREDPAGEUP",
+	"SCI_STUTTEREDPAGEUPEXTEND",
+	"SCI_STYLECLEARALL",
+	"SCI_STYLERESETDEFAULT",
+	"SCI_SWAPMAINANCHORCARET",
+	"SCI_TAB",
+	"SCI_TARGETASUTF8",
+	"SCI_TARGETFROMSELECTION",
+	"SCI_TEXTHEIGHT",
+	"SCI_TEXTWIDTH",
+	"SCI_TOGGLECARETSTICKY",
+	"SCI_TOGGLEFOLD",
+	"SCI_UNDO",
+	"SCI_UPPERCASE",
+	"SCI_USEPOPUP",
+	"SCI_USERLISTSHOW",
+	"SCI_VCHOME",
+	"SCI_VCHOMEEXTEND",
+	"SCI_VCHOMERECTEXTEND",
+	"SCI_VCHOMEWRAP",
+	"SCI_VCHOMEWRAPEXTEND",
+	"SCI_VERTICALCENTRECARET",
+	"SCI_VISIBLEFROMDOCLINE",
+	"SCI_WORDENDPOSITION",
+	"SCI_WORDLEFT",
+	"SCI_WORDLEFTEND",
+	"SCI_WORDLEFTENDEXTEND",
+	"SCI_WORDLEFTEXTEND",
+	"SCI_WORDPARTLEFT",
+	"SCI_WORDPARTLEFTEXTEND",
+	"SCI_WORDPARTRIGHT",
+	"SCI_WORDPARTRIGHTEXTEND",
+	"SCI_WORDRIGHT",
+	"SCI_WORDRIGHTEND",
+	"SCI_WORDRIGHTENDEXTEND",
+	"SCI_WORDRIGHTEXTEND",
+	"SCI_WORDSTARTPOSITION",
+	"SCI_WRAPCOUNT",
+	"SCI_ZOOMIN",
+	"SCI_ZOOMOUT",
+};
+
+static const int constantDisplacements[] = {
+	2, 4, 0, 1, 2, 0, 0, 0, 0, -3, 1, 1, 1, 0, 0, 0,
+	-5, 0, 2, 2, 0, 1, -8, 0, 0, 1, 6, -13, 1, 0, -17, -23,
+	1, 0, 0, 2, 0, 0, -25, -26, 0, -28, -34, 2, -35, 1, 1, 1,
+	-42, 0, 0, 0, -46, 0, -51, 1, 3, 2, 0, 0, 0, 1, 0, -57,
+	0, 5, -59, 1, 0, 2, 2, 0, -61, 0, 2, 0, 1, -62, 3, -65,
+	-67, 1, 0, 1, -68, 0, 1, 0, -69, 1, -71, 1, 0, 0, 1, 1,
+	-73, -74, 0, 0, 2, 0, -75, 0, -77, -81, 1, 1, 1, 0, -84, 2,
+	0, 0, 2, 1, -92, -94, 0, 1, 0, 1, -97, 0, -99, 3, -101, 0,
+	-111, 1, 0, 0, -112, 0, -114, 2, 3, 0, 4, 0, 0, -118, 0, 3,
+	0, 4, -121, -122, -123, -125, 1, 2, 0, -127, 1, -130, 0, 0, -131, -132,
+	1, -138, 0, 0, -139, 1, 0, 0, 0, 0, 0, -140, -146, 0, -148, -151,
+	-152, 0, -158, 1, 0, 0, 0, -159, 1, -162, 1, -168, 0, -173, 4, 0,
+	-178, 1, 0, 0, 1, 0, -179, 0, 1, 0, 3, 0, 0, 1, 0, 0,
+	-180, 0, 2, 1, 0, -181, 2, 0, -182, 2, -183, -184, -186, -190, 0, -194,
+	0, -195, -197, 0, -198, -199, -201, 2, 3, -202, 1, -204, -205, 0, 0, 0,
+	0, 1, -216, 2, 0, 0, -221, 0, -222, -223, 0, -231, 1, 0, 0, 0,
+	-232, 0, -236, 0, 8, 0, 0, 0, 1, -239, -244, 1, -246, 0, 0, 2,
+	1, -248, 0, -249, -251, -252, 0, -254, 1, 1, 0, -256, 0, 0, 0, 3,
+	-259, 3, 1, 0, -260, 2, -261, 1, -262, 0, 0, 0, -263, 0, 3, 2,
+	0, 0, -264, 0, 0, 4, 0, -265, -266, 0, 2, -267, -272, 0, -273, 3,
+	5, -282, -283, 2, 2, 0, 0, -285, -289, 0, -292, -294, -296, 0, 0, 0,
+	-299, 0, 1, -301, 0, -302, 1, 0, -305, -308, -315, 3, 0, 0, -316, 0,
+	0, 1, 0, 2, 1, -317, 2, 1, 0, -318, 0, -320, -323, -324, -331, 2,
+	0, 4, -332, -333, 4, -336, 0, 0, 3, -339, -341, -345, -349, 0, 0, 0,
+	0, 0, -351, -353, -359, -362, 0, -364, -366, -367, -372, 0, 0, -374, -380, -384,
+	5, -386, -387, 1, 3, 0, 1, -390, -392, 0, 0, -394, 1, 0, -395, 0,
+	0, 0, 0, 0, -397, -400, 3, -403, 0, 1, 0, 0, 0, -409, -411, 3,
+	-415, 2, 1, -416, 0, -417, 0, 4, 0, -420, 3, -421, 0, 0, 7, 0,
+	-433, 2, 0, 1, -439, 0, 0, 0, -441, -442, 0, 0, 0, -444, 1, 0,
+	1, 1, 0, 0, 0, 0, 10, 0, 0, 1, 0, -446, -452, 0, 0, -456,
+	1, -458, 0, 2, -459, -461, -467, 1, 2, 2, 0, 2, 0, 2, 0, 0,
+	-470, 1, -472, 0, 4, -475, 2, 1, -476, 0, 2, 1, 0, 0, 0, 0,
+	0, 1, -477, -478, -483, -486, -487, 1, 0, 1, -489, 0, -491, 1, -495, 0,
+	-497, 1, 0, 0, 0, 1, 1, 0, -500, 1, 0, -503, -507, -511, -513, -515,
+	0, 0, 1, 1, -521, -523, -526, -531, -534, 0, 0, 0, -537, 1, 7, -540,
+	-542, 0, 1, 1, 0, 2, 0, -544, -546, -548, 0, 0, -552, 0, -557, -559,
+	-560, -561, 0, 2, 1, 1, 2, 0, 1, 2, 0, 2, -567, -568, -570, 1,
+	0, 1, 0, 0, 0, -574, -576, 0, 0, 2, -581, 0, -582, 0, 0, -583,
+	0, 0, 0, -584, 2, 2, -594, -596, -597, -598, 0, 2, -599, -604, 0, -605,
+	0, 1, 0, -615, -619, -620, -622, 1, 0, 3, 1, 0, -625, 4, 0, 3,
+	0, 0, 0, -626, -627, 0, -631, 2, 1, 0, 0, 0, 0, 0, 0, -632,
+	0, -633, -634, 0, 0, -637, 2, -638, -639, -640, 1, 0, 3, 1, 0, 1,
+	0, -641, -642, 0, 1, -645, -648, -649, -654, -668, 1, 0, 3, 2, -669, -673,
+	0, 0, 1, 0, 0, 3, 9, 8, -679, 0, -680, 6, 0, 3, 0, 1,
+	2, 0, -681, 0, 0, 2, -683, 0, 0, 1, 0, 0, 0, 5, -684, 3,
+	0, 0, -685, -686, 3, 0, -688, 0, 0, 1, -689, 0, -692, -694, 3, -695,
+	2, 1, -698, -699, -700, 0, -706, 0, 0, 0, 0, -708, 1, 0, -709, -715,
+	-719, 0, -721, -725, 0, -726, -729, -734, 0, 1, -738, 3, -741, -743, -744, -746,
+	-748, 1, 2, -749, 0, 0, -750, -753, 2, 0, 1, -756, -770, 0, 2, 0,
+	0, -772, 1, 0, 0, 1, -773, 0, -774, 0, 0, -776, 4, -777, -778, 0,
+	-779, 0, 3, 2, 0, 2, -780, 0, -790, -793, 0, -795, -796, 3, -798, 0,
+	-800, 0, 3, 3, -803, -804, 0, 2, 7, -806, 0, -809, 1, 0, -810, -812,
+	0, 2, 1, 7, -814, -815, -816, 0, -818, -819, 1, 0, -821, -823, 0, 0,
+	-825, 0, 0, 1, -828, -835, 0, 4, 0, 2, 3, -842, -843, 3, -844, -846,
+	-848, -849, 0, 0, -850, -852, -854, 0, -863, 0, -864, 1, 1, -866, -873, 6,
+	4, 8, 0, 0, -874, 0, -877, 1, 0, -880, 0, 0, -883, -887, -891, 0,
+	1, 0, 0, -893, 0, 0, 0, 1, 0, -898, 0, -900, 0, 2, 0, -901,
+	-902, -907, 0, 0, -924, -925, 3, -926, 1, 0, 0, 0, 1, 0, 0, 2,
+	3, -928, 5, 2, 6, -929, -930, 0, 0, 0, 0, 1, -931, -932, 0, 1,
+	0, -933, -935, 6, 0, 0, 0, -937, 1, 0, -938, -940, -941, 1, -949, 0,
+	-951, 0, 0, -954, 0, -956, 0, 0, 0, -957, -958, 4, -961, 1, 4, 0,
+	1, 1, -966, 2, 0, 0, -978, 4, 0, -980, 0, 0, 0, -982, 3, -984,
+	0, 0, 4, 1, 0, -985, 0, 0, 0, -986, 11, -990, 1, 0, 0, 0,
+	0, 0, -993, -994, 2, -998, 2, 1, -1001, 0, 0, 0, 0, 1, 0, 2,
+	3, -1002, 0, -1003, 0, 3, -1004, 1, 8, 2, 0, 3, -1008, 0, 0, 0,
+	-1009, 2, 0, 7, 0, 0, -1013, -1017, -1025, -1026, -1028, 2, 1, 0, 3, 1,
+	-1029, -1030, -1031, -1037, -1042, 0, 2, 0, 0, -1044, -1046, 6, 3, -1051, 0, 2,
+	-1055, -1056, 0, 0, 0, 0, -1059, 0, 1, 0, 0, -1060, -1065, 0, 0, 1,
+	-1068, 0, 1, -1071, -1073, 0, 6, 0, 3, -1074, -1079, -1081, 0, 0, 3, -1082,
+	-1084, -1087, -1098, 1, 0, -1101, -1104, -1106, 0, 1, 1, 0, -1107, -1108, 0, -1115,
+	0, 0, 1, 0, -1117, 0, -1122, 0, 3, 2, 3, 6, 0, 1, 0, -1124,
+	0, 1, 0, -1129, 5, -1133, 0, 0, -1134, 0, -1135, 1, -1136, 0, 0, 0,
+	0, 1, 0, -1137, -1138, 0, 0, -1141, 0, 0, 0, 1, 0, 0, 18, -1143,
+	1, 0, 0, 0, 2, 0, -1148, -1151, 0, -1152, 5, -1155, -1156, 0, -1157, -1159,
+	2, -1161, 0, -1162, 1, 0, -1163, -1168, -1170, 5, 5, 0, 3, 4, 0, 0,
+	2, 3, -1174, 0, 0, 0, 0, -1180, 0, 1, 0, 0, 3, -1183, 16, 0,
+	0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, -1187, 0, 0, 0,
+	5, 0, -1188, -1190, -1193, 3, 1, -1196, -1197, 0, -1198, -1202, 0, 0, -1203, -1204,
+	-1206, 3, -1209, -1210, 9, 3, 0, -1212, 0, 1, 3, 0, 0, -1213, 0, 2,
+	-1214, 0, -1215, -1218, -1220, -1222, -1226, 0, -1231, 1, -1233, 0, -1236, 0, 1, 1,
+	-1240, 0, 7, 0, -1242, 5, 3, -1246, -1247, 0, 2, 0, 0, -1248, 1, 0,
+	0, 1, 0, 0, 0, -1252, -1258, -1261, 0, 1, 0, 1, 1, 0, 0, 0,
+	0, 3, 0, 1, 0, -1262, 2, -1263, 0, 1, 0, -1265, 0, 4, 0, 0,
+	0, -1267, 0, -1268, 0, 1, 0, -1273, 0, 1, -1274, -1275, 2, 1, 0, -1281,
+	0, 2, 0, 3, 3, 1, 1, 0, -1282, -1285, -1287, 1, 0, -1289, 3, 2,
+	-1293, 0, -1295, 9, 1, 0, -1298, 0, 0, 0, 0, 0, -1299, 2, -1301, 1,
+	0, -1302, -1303, 0, 0, 0, 0, 0, 0, -1313, -1315, -1316, -1317, 4, 1, -1318,
+	-1319, 0, 3, 0, 3, 0, 1, 1, -1322, 2, -1325, 1, 0, 0, 4, -1328,
+	-1331, 0, -1332, -1333, 0, -1338, 2, -1339, 3, 0, -1342, 0, 5, 3, 0, -1343,
+	1, 1, 5, -1347, -1352, 0, 0, -1353, 4, -1354, 0, 0, 1, 0, 2, 3,
+	1, 1, -1358, -1361, 0, 0, 5, 3, 0, -1366, -1367, 0, 0, 1, -1369, 0,
+	10, 1, 1, -1370, -1375, -1376, 0, -1377, 0, -1378, -1379, 1, -1380, 0, -1381, -1382,
+	-1385, 0, 0, 0, 0, 0, 0, 0, 0, -1387, 15, -1390, -1394, -1396, 0, -1398,
+	-1402, 0, -1404, 0, 1, -1409, 1, -1410, -1419, 0, 0, -1420, 5, -1431, -1433, 0,
+	1, 1, 2, -1434, -1436, 2, 1, 1, -1445, 8, 0, -1446, 2, 5, 0, 4,
+	1, -1451, 0, 1, -1455, -1456, 0, 0, -1457, -1458, 0, 1, -1459, 0, 3, -1460,
+	0, -1461, 1, 5, 10, -1462, 0, 0, 1, 0, 0, 0, 1, 9, -1465, 1,
+	-1466, 6, -1467, -1469, -1472, -1475, -1481, 1, 5, -1482, -1484, 0, 0, -1485, 0, 0,
+	-1487, 13, 0, 0, 1, 0, 5, -1489, 1, -1490, -1491, 0, -1497, -1498, -1499, 0,
+	-1500, 2, 0, 0, -1501, 0, 0, 0, -1504, 1, 1, -1505, 7, 0, -1507, 0,
+	-1508, 1, 0, 0, -1509, -1514, 2, 4, 2, 2, 1, 0, -1515, 0, 3, 2,
+	-1519, -1521, -1523, 2, -1528, 0, 3, 0, 0, -1529, -1530, -1537, 1, -1538, 4, -1541,
+	2, -1544, 0, 0, 0, 0, 12, 0, 0, -1546, 2, -1547, 0, -1548, 8, 0,
+	0, 0, -1549, -1550, -1551, 6, -1557, -1559, 1, -1571, 0, -1572, -1587, -1595, -1596, 0,
+	-1597, 10, 0, 0, -1601, 6, 4, -1611, -1618, -1619, 11, 0, -1625, -1627, 6, 0,
+	-1635, 3, -1636, -1637, -1639, 0, -1640, -1641, 1, 0, 0, -1642, -1646, 1, 0, 1,
+	2, 0, -1648, 2, -1657, -1658, 1, 1, 1, 0, -1660, -1664, 2, -1665, 0, 0,
+	0, 2, -1666, 0, -1667, -1669, 0, -1670, 0, 0, 14, -1672, 1, 5, 11, -1677,
+	1, 0, -1688, 0, 0, 3, -1690, 0, 6, 0, 0, 0, -1692, 0, 0, 1,
+	-1693, -1696, -1697, -1700, -1711, -1719, 1, -1726, 1, 0, 0, -1727, -1735, 2, 1, 0,
+	-1743, 0, 2, -1744, -1748, -1749, -1755, 1, -1756, 3, -1758, -1760, 6, -1764, 0, -1772,
+	0, -1773, -1774, 1, 0, -1777, 1, 6, -1786, -1787, 0, 0, -1792, -1794, -1799, -1803,
+	4, -1807, 0, 0, 0, 7, -1808, -1809, 1, -1810, 0, 2, 4, 0, 0, 0,
+	1, -1823, -1830, -1834, -1839, -1840, 0, 0, -1842, -1843, -1846, -1847, 0, 1, 0, 1,
+	1, -1848, -1854, -1856, 0, 0, -1860, -1864, 1, -1866, 0, 0, 0, 1, -1868, 2,
+	-1869, -1877, -1880, -1884, 5, 0, 0, -1885, -1886, -1891, -1899, 0, 1, 2, 0, 0,
+	0, 0, 0, 0, 0, -1906, -1907, 0, 0, 0, 0, -1909, -1910, 0, -1911, -1915,
+	-1921, -1923, 0, -1928, 1, 1, 1, -1931, 4, 0, -1932, 0, 0, 0, 1, 0,
+	-1933, -1934, 1, -1935, -1937, -1942, 2, 0, 0, 3, -1948, 0, 6, 2, 0, 0,
+	-1949, -1951, 0, -1955, 2, 0, 3, 0, 1, 0, -1956, -1959, -1964, 0, 0, -1965,
+	1, -1967, 0, -1968, 0, 7, 5, 0, 0, 0, 0, -1973, 0, -1974, -1976, 1,
+	9, -1981, 6, 0, 1, -1983, 0, 0, -1985, 1, 8, 4, 11, -1990, 0, 0,
+	0, 0, 5, -1991, 13, 0, 0, -1992, 1, -1994, 0, 0, 21, 0, 2, 1,
+	3, 0, 5, -1996, 0, 5, -1997, -1999, 0, 0, -2000, 2, 0, 0, 0, 7,
+	0, -2001, -2002, 3, -2005, 2, 0, 0, 0, -2008, -2009, -2010, 0, 0, 0, 0,
+	0, 0, 0, 3, 0, -2011, -2012, 0, 0, 0, 0, 9, -2013, 4, 0, 0,
+	2, 0, 1, 1, -2017, 0, 0, -2019, 9, 0, -2023, -2024, 5, 0, 9, -2026,
+	1, -2027, 0, 2, 0, -2029, 1, 3, 1, -2032, 14, -2034, -2039, -2045, 1, 1,
+	-2047, 0, 23, 1, -2048, -2053, -2055, 0, 5, -2056, 0, 2, 2, 0, -2059, -2061,
+	3, -2064, 0, -2066, 10, -2067, -2070, 0, -2071, 0, 0, 2, 0, 0, 0, 0,
+	-2072, 4, 3, 3, 2, 0, 1, -2075, 2, 0, 0, 8, 10, -2081, -2084, -2085,
+	0, 4, 0, -2089, -2090, 2, -2095, -2096, 4, 0, -2099, 0, 3, -2102, 0, -2105,
+	-2106, -2111, 3, 0, -2115, 6, 0, 2, 2, -2123, 0, -2124, 0, 0, -2125, -2129,
+	-2134, 1, 0, 2, 0, 1, -2137, -2138, 0, 0, 3, -2140, 2, 0, 0, 2,
+	0, -2144, -2145, 5, 0, 0, 0, 0, 5, -2149, -2150, -2151, 2, 7, -2155, -2156,
+	0, 0, -2159, 1, 1, 5, 1, 0, 14, 27, -2163, 0, 0, -2165, 0, -2168,
+	-2169, 0, 3, 2, 0, -2172, 0, 0, 11, 0, 0, 0, 7, 0, 0, 0,
+	0, -2179, -2183, 2, 0, 4, -2187, 0, 0, 0, 4, 3, -2190, 0, -2192, -2195,
+	2, -2197, -2205, 5, -2208, 1, 0, -2212, 1, 0, -2214, 1, 1, 0, -2215, -2216,
+	-2217, 0, 0, 3, 0, 0, 0, 15, -2220, 4, -2225, -2228, -2230, 0, 4, -2231,
+	-2232, 14, -2235, 0, -2239, -2241, 0, 2, 0, -2243, 10, -2247, 0, 1, 0, 0,
+	0, 3, 0, -2251, -2254, 0, 0, 0, -2256, -2257, 0, 2, 0, -2260, 0, 0,
+	0, -2263, 3, 2, 0, 0, 0, 0, 2, 0, 1, 1, -2269, 0, 0, 0,
+	0, 12, 0, 0, 4, 14, 0, -2271, -2279, 0, 0, 9, -2280, -2283, 1, 1,
+	-2284, 0, 0, -2286, 8, 3, -2287, 0, -2293, -2297, -2298, 4, 7, 0, 0, 1,
+	0, -2300, -2301, -2303, -2304, 0, -2309, 0, 27, -2311, 49, 5, -2313, 0, 5, 0,
+	-2320, -2321, 4, 1, -2324, 1, -2329, -2331, -2332, -2334, -2336, 0, -2340, 3, -2341, -2342,
+	-2343, -2345, 0, -2357, -2358, 0,
+};
+
+static const int constantSlots[] = {
+	1762, 290, 355, 1994, 1303, 1976, 1002, 126, 299, 1827, 1749, 513, 2082, 1578, 1919, 963,
+	1910, 627, 1353, 492, 611, 1668, 1396, 2326, 601, 456, 1733, 104, 1667, 577, 1173, 1016,
+	646, 373, 2284, 2325, 95, 1551, 1606, 1506, 906, 809, 1729, 2157, 502, 1137, 889, 1162,
+	663, 176, 2319, 964, 1752, 15, 747, 494, 1962, 1713, 537, 1870, 22, 1117, 2294, 483,
+	16, 1817, 1103, 246, 424, 1594, 828, 1183, 75, 319, 2227, 1486, 701, 1350, 1541, 1450,
+	1091, 1514, 2070, 2238, 491, 813, 321, 263, 2023, 171, 1896, 1715, 1288, 1436, 409, 1011,
+	325, 1790, 149, 566, 683, 1312, 1985, 1974, 1947, 996, 1161, 1294, 1717, 426, 1120, 1915,
+	65, 397, 1324, 1608, 118, 1671, 775, 1653, 2345, 700, 1993, 1967, 1829, 1822, 115, 163,
+	1208, 672, 1304, 1329, 386, 849, 792, 2056, 968, 2194, 519, 799, 1385, 1494, 1424, 2031,
+	289, 1692, 1771, 31, 668, 1258, 224, 905, 2182, 1154, 2063, 2134, 510, 1467, 815, 385,
+	1930, 231, 641, 345, 702, 68, 532, 1971, 1224, 587, 1605, 1115, 173, 634, 2253, 2051,
+	2234, 467, 1196, 2158, 1097, 1075, 1149, 2314, 1520, 1728, 17, 53, 1721, 33, 1210, 1876,
+	41, 96, 1153, 526, 1513, 818, 834, 2208, 38, 698, 2118, 466, 1996, 1245, 694, 1726,
+	1019, 462, 1775, 1338, 2081, 619, 404, 1122, 529, 2333, 1924, 919, 707, 598, 599, 1401,
+	381, 316, 1591, 2271, 1404, 983, 199, 1970, 320, 1559, 2037, 2169, 1387, 703, 120, 1637,
+	2179, 2110, 1065, 1643, 1621, 2146, 443, 1451, 830, 960, 735, 763, 778, 1483, 165, 432,
+	1830, 1519, 1932, 2205, 1034, 1112, 1855, 234, 795, 301, 984, 1655, 394, 1039, 1164, 789,
+	2029, 72, 1824, 675, 833, 1489, 457, 2226, 1187, 1624, 1118, 1054, 662, 1748, 563, 90,
+	1687, 1442, 939, 339, 276, 1182, 1503, 1377, 452, 659, 667, 422, 2014, 1191, 2004, 2230,
+	1128, 2165, 230, 739, 1521, 1175, 1711, 2186, 1336, 1200, 2224, 335, 283, 1871, 720, 1146,
+	1280, 312, 1997, 1428, 1935, 1908, 661, 1223, 1382, 635, 64, 879, 2239, 875, 607, 1410,
+	657, 2149, 612, 1134, 88, 1845, 1766, 183, 1566, 56, 1272, 2181, 1096, 1028, 808, 725,
+	1609, 645, 338, 93, 1998, 117, 1676, 140, 1806, 188, 361, 2313, 642, 540, 1188, 260,
+	463, 1587, 1923, 825, 1388, 816, 1001, 1193, 2064, 1498, 1496, 723, 1264, 1642, 541, 2079,
+	300, 503, 112, 1005, 2111, 1560, 2329, 179, 1301, 2054, 785, 1611, 559, 1026, 1306, 952,
+	2034, 1317, 2349, 1819, 1524, 1426, 2028, 1515, 2274, 58, 194, 1042, 141, 2273, 652, 1945,
+	2155, 2008, 1061, 1281, 1780, 1754, 2126, 858, 959, 1647, 1860, 1032, 302, 1938, 614, 1972,
+	44, 1375, 480, 2160, 1969, 750, 340, 1616, 902, 1346, 940, 284, 1802, 1487, 713, 110,
+	1533, 967, 396, 168, 1027, 950, 2256, 2267, 1964, 1219, 272, 2241, 469, 562, 592, 458,
+	535, 478, 1718, 486, 2026, 1165, 2143, 938, 109, 988, 1763, 732, 2252, 1179, 521, 1854,
+	253, 1779, 2202, 2332, 1731, 943, 2304, 584, 2087, 160, 728, 1814, 755, 826, 539, 1745,
+	1861, 1789, 1036, 575, 1478, 80, 2015, 1085, 2044, 125, 446, 1253, 1400, 498, 1298, 62,
+	1127, 1547, 1236, 2355, 549, 1093, 59, 508, 318, 740, 23, 779, 1357, 371, 2120, 2093,
+	748, 2059, 891, 2354, 285, 557, 567, 2337, 2039, 1439, 150, 1556, 2080, 1904, 1800, 2036,
+	571, 1477, 898, 2095, 209, 1981, 2027, 565, 1380, 2341, 2102, 1403, 1673, 2072, 2003, 2218,
+	737, 1645, 1158, 201, 2035, 991, 351, 2352, 273, 1490, 712, 157, 1205, 287, 743, 334,
+	2020, 2268, 531, 2021, 382, 1471, 2129, 2243, 944, 1850, 482, 527, 1818, 1929, 280, 655,
+	450, 518, 605, 721, 1808, 1685, 1081, 2005, 479, 796, 440, 2262, 1622, 1532, 211, 1546,
+	1295, 582, 1739, 974, 900, 2009, 2089, 2016, 1707, 2320, 337, 2296, 1597, 1030, 1332, 915,
+	1761, 947, 1607, 1940, 2161, 1386, 2061, 399, 588, 2343, 322, 2212, 1014, 1913, 1257, 1326,
+	1299, 1482, 697, 37, 1157, 980, 617, 1110, 343, 1119, 1037, 2308, 1561, 1699, 138, 1468,
+	1613, 1129, 1907, 1740, 303, 2219, 1207, 782, 25, 84, 1840, 1803, 501, 1799, 885, 1602,
+	1300, 2306, 2269, 1927, 615, 1228, 1125, 227, 1073, 1724, 1732, 1217, 1631, 1009, 264, 1126,
+	806, 1393, 1449, 2247, 2043, 14, 1141, 2348, 1833, 1658, 1785, 1241, 1627, 802, 506, 1625,
+	1444, 842, 252, 1526, 1619, 1769, 1454, 1420, 2192, 1371, 1198, 1664, 2245, 2038, 2109, 664,
+	27, 1025, 1500, 350, 2084, 1166, 18, 1863, 1247, 1148, 2083, 91, 421, 1106, 2318, 413,
+	1720, 1603, 26, 525, 1553, 6, 368, 398, 1453, 781, 2055, 1905, 2103, 602, 555, 886,
+	152, 1099, 1441, 1323, 238, 923, 1231, 1677, 1842, 1857, 2264, 2141, 1810, 2311, 2312, 481,
+	1582, 114, 1460, 1901, 1856, 613, 449, 798, 847, 1255, 1327, 1181, 1888, 30, 2012, 1600,
+	1230, 680, 606, 814, 1291, 1459, 648, 1759, 39, 973, 248, 1227, 1145, 744, 647, 780,
+	2242, 1804, 439, 1557, 1416, 1013, 1455, 1155, 1555, 128, 751, 1765, 206, 1921, 2193, 2316,
+	1750, 2229, 838, 2170, 1626, 1989, 249, 2151, 2220, 932, 236, 993, 1159, 1679, 1878, 1359,
+	734, 1714, 2062, 1370, 1897, 1124, 790, 1136, 2124, 794, 131, 403, 1185, 298, 417, 804,
+	1589, 845, 1399, 1688, 1601, 894, 784, 673, 610, 2178, 1438, 1867, 1345, 1909, 1598, 1922,
+	2290, 129, 843, 1872, 63, 2183, 859, 538, 1936, 489, 1048, 851, 2147, 1077, 2222, 1321,
+	1686, 1552, 1623, 13, 1569, 270, 2254, 1874, 305, 1744, 2285, 1573, 1942, 1347, 1987, 1558,
+	1738, 1463, 330, 363, 686, 1206, 1742, 2276, 1313, 556, 1954, 1517, 836, 604, 2, 329,
+	1813, 197, 391, 1111, 696, 1683, 1337, 872, 1592, 7, 1286, 296, 2315, 460, 214, 2323,
+	999, 1233, 819, 1542, 1507, 2204, 1094, 1331, 899, 20, 113, 1595, 1041, 1820, 455, 349,
+	155, 896, 1576, 693, 2049, 2188, 1805, 2336, 1782, 1852, 2090, 679, 1108, 2078, 438, 1292,
+	292, 793, 1868, 953, 1367, 2099, 2232, 2214, 681, 2173, 2191, 1583, 1010, 2305, 2251, 1570,
+	1545, 1488, 198, 472, 691, 11, 852, 2091, 2174, 423, 1678, 111, 1352, 1550, 471, 827,
+	766, 442, 1174, 1604, 2258, 237, 1917, 1479, 1862, 346, 220, 1540, 2025, 638, 1130, 1211,
+	586, 568, 986, 1952, 1220, 2302, 1443, 1355, 1015, 1050, 2310, 1950, 1821, 1563, 1900, 1680,
+	288, 850, 451, 1040, 1475, 1079, 245, 1123, 279, 523, 499, 356, 1351, 597, 1757, 186,
+	544, 788, 1584, 684, 1534, 2058, 4, 1571, 1982, 1114, 2033, 897, 731, 1701, 1421, 1109,
+	581, 352, 134, 1504, 1234, 225, 402, 706, 377, 139, 1391, 978, 82, 1221, 1405, 2047,
+	1774, 966, 2041, 1670, 2116, 405, 1330, 1988, 294, 857, 1043, 2207, 1328, 2050, 2096, 1383,
+	2213, 1960, 761, 2330, 1961, 570, 1343, 1956, 1618, 1999, 1147, 2156, 1778, 1238, 2164, 961,
+	1361, 2123, 1727, 883, 1315, 407, 2030, 493, 2119, 1035, 1968, 865, 1056, 132, 348, 1427,
+	2257, 1853, 516, 1525, 1823, 268, 945, 533, 354, 57, 722, 579, 465, 1528, 1033, 1702,
+	1070, 358, 291, 1735, 762, 317, 67, 1177, 558, 1237, 746, 1995, 1018, 2150, 1180, 574,
+	552, 2132, 1493, 1434, 1536, 271, 2340, 928, 102, 1160, 328, 1568, 699, 669, 1946, 1675,
+	1951, 1585, 145, 1425, 2235, 2137, 212, 2098, 911, 870, 2281, 1273, 1575, 182, 626, 903,
+	1694, 2297, 1480, 916, 1885, 1544, 912, 154, 2162, 2280, 1276, 1256, 1741, 1225, 2278, 671,
+	2121, 520, 1086, 729, 687, 522, 933, 2071, 1098, 1456, 1826, 595, 1176, 1349, 1811, 764,
+	791, 1632, 1890, 922, 310, 412, 167, 767, 1397, 1282, 281, 970, 622, 2317, 2092, 1839,
+	130, 1893, 569, 2011, 578, 1983, 347, 1777, 384, 653, 1776, 1469, 1358, 366, 2270, 1875,
+	474, 1333, 133, 2105, 2073, 1828, 314, 753, 866, 2085, 136, 771, 874, 1722, 50, 1215,
+	34, 2298, 1807, 420, 623, 685, 2172, 180, 1640, 2167, 378, 2277, 66, 2293, 603, 123,
+	2356, 2196, 1784, 307, 1914, 2322, 1979, 2177, 2237, 931, 233, 1318, 977, 1156, 590, 1538,
+	2287, 800, 311, 148, 1066, 1368, 468, 1024, 730, 1243, 2189, 2250, 2022, 2338, 1650, 2334,
+	1656, 1812, 9, 105, 477, 1457, 2327, 1880, 1051, 2266, 1703, 1783, 1142, 1636, 777, 2115,
+	1966, 357, 267, 55, 2187, 124, 2065, 2100, 1201, 1472, 243, 144, 1770, 254, 1090, 548,
+	1866, 1363, 992, 1322, 2221, 863, 1270, 1565, 369, 2339, 650, 829, 1689, 1716, 2127, 1265,
+	957, 2094, 1941, 2331, 1239, 2114, 437, 1392, 21, 2321, 705, 1325, 909, 1788, 1986, 99,
+	1254, 1390, 459, 1006, 1614, 2201, 1000, 1531, 2282, 848, 1963, 1815, 1348, 2117, 507, 436,
+	1275, 1422, 1244, 1712, 948, 1062, 435, 1194, 1373, 1978, 2042, 1431, 2018, 425, 2299, 1379,
+	678, 1143, 715, 74, 429, 374, 654, 2128, 48, 688, 2279, 1697, 1414, 1849, 1548, 2307,
+	1955, 200, 1984, 756, 583, 315, 1302, 1269, 1465, 395, 331, 353, 119, 69, 1266, 1651,
+	2075, 1638, 1464, 1398, 2328, 629, 935, 882, 1462, 1537, 47, 1809, 1046, 2086, 674, 1884,
+	362, 379, 3, 464, 153, 2140, 2240, 576, 1252, 1768, 2048, 1170, 210, 995, 1911, 1144,
+	954, 982, 616, 256, 1466, 419, 1289, 387, 12, 240, 207, 904, 1705, 1663, 222, 1535,
+	1470, 375, 965, 1316, 633, 1564, 1577, 1889, 937, 2244, 1682, 1937, 447, 861, 534, 2024,
+	1567, 1052, 1633, 921, 1898, 1150, 28, 232, 32, 431, 1903, 2233, 177, 490, 1407, 2001,
+	805, 2106, 1773, 2265, 1649, 323, 444, 515, 1743, 2301, 433, 1657, 1596, 1662, 1816, 1287,
+	625, 956, 2215, 1022, 1892, 169, 2053, 2045, 2154, 1069, 856, 1894, 164, 772, 1639, 1495,
+	1781, 1216, 388, 925, 1138, 1698, 266, 1610, 835, 1044, 473, 98, 550, 1864, 235, 1580,
+	184, 2216, 2283, 1843, 547, 2144, 1409, 724, 1342, 89, 313, 749, 1755, 52, 1926, 158,
+	1902, 1278, 949, 1499, 2197, 1381, 101, 1415, 2175, 1794, 1285, 742, 2236, 383, 736, 530,
+	2125, 54, 170, 441, 881, 951, 1508, 1004, 2077, 1659, 275, 1965, 1554, 1261, 45, 1474,
+	1502, 2198, 1402, 476, 1246, 1736, 1886, 564, 1505, 1389, 2145, 596, 401, 393, 1452, 1708,
+	1172, 637, 1334, 135, 1274, 1797, 181, 994, 1068, 2010, 895, 585, 812, 1360, 1140, 908,
+	1838, 733, 1877, 1, 1064, 496, 146, 854, 1458, 1530, 1491, 1413, 228, 1734, 1700, 1365,
+	1767, 1562, 1737, 1859, 990, 1135, 1693, 76, 1309, 580, 1579, 71, 1719, 174, 504, 1012,
+	2288, 1131, 797, 1792, 293, 392, 97, 1501, 867, 1953, 1751, 752, 1690, 70, 1725, 2153,
+	2259, 1674, 161, 1851, 376, 2260, 1240, 1107, 2168, 971, 2249, 2000, 801, 545, 415, 196,
+	5, 2184, 156, 1209, 1047, 1199, 955, 1429, 151, 193, 1681, 1007, 416, 1706, 1020, 1672,
+	1072, 372, 692, 1408, 888, 2190, 930, 1764, 695, 215, 418, 49, 853, 1572, 2046, 1433,
+	1934, 1297, 341, 370, 2104, 1432, 643, 2088, 561, 2353, 621, 61, 2291, 1267, 1990, 166,
+	1916, 453, 1163, 704, 1074, 934, 497, 1095, 1588, 1045, 1847, 536, 573, 962, 1132, 229,
+	2295, 1522, 2286, 191, 1516, 1646, 1644, 1629, 40, 873, 121, 2225, 1116, 261, 855, 1772,
+	1581, 1977, 342, 175, 42, 2289, 1133, 1798, 1918, 1920, 824, 2060, 624, 470, 880, 840,
+	546, 844, 1590, 2130, 2159, 259, 776, 572, 1341, 1100, 406, 2261, 1250, 877, 1615, 1168,
+	265, 1634, 251, 202, 223, 2255, 871, 924, 1620, 505, 2195, 77, 631, 1307, 1511, 998,
+	1251, 1029, 1485, 2135, 226, 1730, 2223, 787, 1756, 1139, 333, 108, 1374, 1310, 1445, 427,
+	726, 1484, 1169, 1825, 309, 304, 2142, 35, 1691, 862, 718, 758, 803, 1087, 1527, 711,
+	823, 336, 400, 1213, 1881, 1339, 495, 773, 1529, 250, 666, 786, 958, 190, 2163, 1082,
+	649, 770, 2206, 817, 1354, 1933, 2107, 887, 1067, 1121, 1305, 1290, 927, 946, 1593, 2185,
+	1447, 1481, 10, 1710, 1991, 1102, 676, 454, 709, 609, 1384, 511, 107, 1801, 1076, 1038,
+	1791, 1661, 1080, 1113, 1835, 2211, 2209, 1186, 876, 1476, 975, 2217, 1271, 242, 1171, 979,
+	221, 884, 2112, 1242, 445, 81, 2076, 1928, 1939, 981, 2346, 2303, 2300, 239, 1430, 1641,
+	1092, 1311, 19, 326, 0, 1268, 757, 1948, 1226, 1869, 1723, 1283, 2180, 717, 1406, 2292,
+	741, 630, 1008, 488, 1364, 810, 100, 524, 36, 282, 708, 820, 553, 913, 690, 2069,
+	878, 1617, 2248, 941, 2101, 1793, 1055, 122, 1448, 1279, 868, 216, 1882, 2246, 769, 2347,
+	2007, 907, 1202, 1417, 308, 1344, 1510, 485, 1666, 60, 1895, 85, 448, 1648, 1078, 1746,
+	1887, 608, 1958, 2108, 636, 1423, 783, 864, 1308, 745, 274, 255, 1362, 1214, 1419, 277,
+	94, 1378, 1088, 1262, 83, 1437, 997, 1753, 1841, 893, 1260, 1151, 2002, 917, 591, 2074,
+	2097, 811, 1204, 1284, 1083, 2171, 1178, 1709, 1586, 760, 142, 92, 1017, 765, 380, 1796,
+	484, 2275, 1060, 689, 1473, 1105, 839, 327, 1461, 658, 2019, 1049, 332, 2272, 926, 1229,
+	869, 258, 461, 244, 2350, 942, 2148, 1497, 106, 2067, 1356, 475, 640, 2342, 1058, 528,
+	2263, 430, 1084, 1314, 1335, 1218, 208, 1925, 1249, 512, 306, 807, 2176, 1232, 344, 1879,
+	542, 2122, 1190, 837, 1980, 1235, 2335, 1973, 1760, 390, 127, 985, 1786, 1795, 2203, 1435,
+	1635, 1263, 1704, 1184, 543, 86, 832, 987, 969, 2199, 1248, 1899, 1412, 1665, 203, 2152,
+	1071, 360, 1492, 1834, 2200, 324, 1574, 1440, 2136, 2006, 910, 1296, 1197, 754, 189, 682,
+	593, 716, 295, 219, 428, 1031, 78, 1758, 594, 628, 87, 1943, 410, 1873, 1101, 143,
+	2040, 278, 714, 551, 514, 738, 759, 262, 892, 257, 517, 1848, 247, 821, 719, 389,
+	411, 1369, 1931, 185, 2309, 159, 1212, 972, 1654, 434, 1021, 860, 359, 841, 639, 1394,
+	644, 670, 1089, 1277, 768, 51, 632, 890, 1992, 665, 2131, 217, 1865, 1057, 727, 1975,
+	2068, 1366, 205, 1912, 43, 1411, 1883, 297, 1518, 1836, 2013, 1944, 918, 1053, 1844, 2017,
+	1167, 1222, 73, 1152, 2052, 901, 1787, 1684, 29, 364, 213, 2113, 1846, 560, 600, 1660,
+	936, 1891, 241, 1059, 846, 1695, 1949, 656, 620, 989, 204, 1696, 509, 1104, 1837, 1192,
+	1630, 2057, 1612, 1831, 1509, 1747, 8, 367, 1543, 46, 500, 1957, 831, 554, 269, 1906,
+	2032, 1189, 1023, 1446, 589, 1063, 137, 218, 1195, 1599, 822, 774, 2066, 2324, 365, 147,
+	1376, 618, 1549, 1959, 1320, 929, 1832, 1340, 2228, 79, 1523, 2139, 2344, 1395, 2166, 2357,
+	1259, 677, 651, 103, 1203, 1628, 976, 2351, 187, 2231, 195, 192, 178, 2133, 1003, 172,
+	1293, 1669, 408, 660, 286, 1418, 2210, 1512, 414, 1539, 914, 162, 710, 1858, 116, 2138,
+	24, 487, 1652, 1319, 1372, 920,
+};
+
+static const int functionDisplacements[] = {
+	0, 0, -5, 0, 0, -10, -18, 1, 1, -21, 0, 1, -23, -29, 0, 0,
+	-31, 1, 1, 0, 2, 3, -32, 0, 0, -35, -38, 0, 1, 1, 0, -40,
+	-41, 0, -51, 5, -52, -53, -57, -58, 1, 1, -60, 0, -63, 0, 1, 0,
+	0, -64, -66, -69, -70, -73, 0, 2, 1, -76, -78, -80, 2, 0, 0, 0,
+	0, -84, -86, 1, 0, -87, -88, -89, -90, -93, 7, -95, -96, -97, -98, -99,
+	1, -100, 0, 0, 0, -101, 1, -102, 1, 2, 0, -109, 0, 0, 0, 0,
+	-110, -111, -112, -115, -118, 4, 0, 0, -119, -124, 6, -127, 2, 1, 0, 0,
+	0, -128, 1, 7, -129, 0, -132, -137, 0, 4, 0, 3, 0, 1, 1, -138,
+	-139, 0, 2, -144, -145, 0, 0, 1, -149, 1, 2, 1, -150, 2, 0, 0,
+	3, 0, -151, -154, 0, 0, 0, -155, 1, 2, 2, 4, 4, -156, 0, 1,
+	0, 1, -158, -172, -173, 0, 2, -175, 0, 0, 1, 0, 0, -177, -180, -181,
+	0, 4, -182, -184, 0, 1, 0, 0, 0, 0, 11, -186, 0, 0, 0, 0,
+	0, -187, -191, 6, 0, -193, 6, -198, 5, -202, -209, -211, -214, 0, 0, -215,
+	0, 0, 0, 0, 0, -217, 0, 0, -218, 3, 6, 0, 0, 0, 0, -223,
+	0, -224, 0, 0, 0, 0, -226, 2, -231, -233, -235, -237, -239, -241, -245, 4,
+	7, -246, 0, 1, 0, -249, -254, 0, 0, 0, 15, 1, -258, 1, -261, -264,
+	0, -266, 3, 13, -268, 0, 3, 3, 0, 1, 1, -269, -270, 0,
+};
+
+static const int functionSlots[] = {
+	225, 193, 122, 106, 171, 99, 261, 140, 107, 7, 235, 176, 92, 154, 220, 87,
+	201, 150, 206, 36, 219, 91, 158, 186, 72, 234, 105, 112, 162, 22, 148, 39,
+	79, 38, 67, 265, 56, 52, 199, 37, 146, 205, 23, 100, 132, 77, 263, 249,
+	170, 20, 44, 226, 200, 70, 51, 11, 71, 262, 243, 208, 58, 49, 4, 218,
+	118, 192, 96, 163, 45, 204, 50, 184, 40, 196, 152, 246, 202, 211, 102, 76,
+	24, 61, 65, 68, 15, 73, 13, 14, 223, 109, 82, 18, 5, 2, 33, 188,
+	117, 191, 26, 128, 156, 175, 54, 252, 98, 101, 0, 75, 247, 69, 116, 217,
+	62, 157, 240, 134, 228, 197, 209, 42, 227, 127, 253, 221, 237, 94, 81, 133,
+	143, 78, 149, 30, 8, 181, 136, 123, 57, 111, 245, 254, 172, 250, 264, 232,
+	55, 125, 190, 63, 248, 114, 203, 256, 159, 229, 166, 135, 267, 16, 213, 59,
+	222, 97, 242, 124, 187, 224, 259, 165, 179, 47, 241, 198, 119, 216, 231, 89,
+	167, 183, 32, 103, 151, 90, 180, 113, 108, 182, 139, 161, 31, 239, 129, 19,
+	104, 34, 21, 131, 144, 83, 185, 251, 257, 266, 27, 130, 244, 53, 10, 137,
+	29, 95, 17, 84, 238, 207, 174, 1, 153, 115, 210, 168, 6, 173, 260, 86,
+	169, 215, 28, 121, 46, 147, 12, 177, 85, 35, 110, 212, 189, 214, 236, 195,
+	141, 194, 41, 138, 60, 164, 269, 155, 48, 3, 25, 178, 233, 255, 93, 80,
+	268, 64, 43, 126, 120, 74, 9, 142, 145, 258, 88, 230, 66, 160,
+};
+
+static const int functionConstantDisplacements[] = {
+	-13, -14, -16, -17, -18, 1, 1, -19, 1, 0, 0, 1, 0, -20, 0, -21,
+	-24, 2, -25, 1, 1, -34, -36, 3, -39, 0, -40, 0, 1, -44, 2, -46,
+	-51, 0, 0, -52, 8, -59, -61, 0, -62, 0, 2, -66, 0, -67, 0, 0,
+	-68, -69, 0, 0, -71, -72, 1, 0, 1, -73, 3, 2, 1, 3, -75, 0,
+	2, 0, -78, -79, -80, 0, 0, 0, 7, -81, -82, 0, 0, -83, 0, 0,
+	1, 0, -84, 0, 0, -87, 0, 3, 3, -91, 0, 1, 0, 4, 5, -95,
+	-99, 0, 3, 0, 0, 1, 1, 0, -101, 1, 1, 0, -105, 0, 11, 1,
+	0, 0, 0, 0, 1, 0, 1, -109, -111, 0, -112, -116, -117, -118, 0, 5,
+	0, -121, 8, 2, -125, 0, 5, -126, 1, -139, 1, 5, 1, 0, 3, 0,
+	2, -148, 0, 0, -151, -163, -167, -168, -172, 0, 0, 1, 6, 1, 1, 1,
+	0, -173, -176, 0, -177, -178, 0, 0, 0, 0, 0, 0, 1, 0, -179, -181,
+	0, 0, 2, -182, 0, -184, 2, 10, 4, 3, 1, -188, 0, 0, 7, -189,
+	0, 0, 13, 0, 0, 0, -195, 0, -198, 1, 0, 9, 0, 8, 2, 0,
+	0, -200, 0, -201, -202, -205, 0, 0, 5, 1, -208, -210, 0, -211, 1, 0,
+	-214, 1, 5, 0, -217, 0, 0, -222, 0, 0, -229, -233, -234, 0, 0, 9,
+	0, 28, 4, -238, 0, -242, 0, -244, 4, 3, 0, 1, 2, 0, 0, 1,
+	0, 0, -246, 0, 0, -247, -249, -252, -261, 0, -265, 0, -266, 0,
+};
+
+static const int functionConstantSlots[] = {
+	227, 208, 74, 115, 159, 89, 20, 35, 129, 80, 148, 5, 228, 181, 234, 175,
+	242, 99, 64, 239, 59, 144, 113, 253, 237, 207, 105, 186, 111, 49, 18, 0,
+	266, 252, 147, 187, 77, 109, 204, 179, 201, 45, 180, 120, 87, 176, 97, 91,
+	142, 34, 146, 15, 117, 150, 206, 193, 240, 217, 212, 246, 41, 38, 172, 134,
+	44, 188, 123, 197, 161, 62, 198, 226, 100, 66, 63, 132, 76, 54, 92, 143,
+	52, 27, 265, 108, 182, 235, 101, 67, 183, 61, 205, 255, 264, 195, 125, 29,
+	245, 151, 189, 24, 241, 17, 60, 136, 73, 152, 25, 130, 163, 220, 10, 13,
+	177, 166, 98, 185, 8, 139, 6, 213, 222, 1, 50, 39, 43, 200, 165, 249,
+	33, 140, 93, 78, 26, 28, 47, 162, 75, 267, 127, 128, 11, 4, 135, 250,
+	154, 88, 230, 133, 94, 124, 221, 2, 9, 194, 156, 82, 248, 58, 14, 21,
+	262, 131, 203, 169, 157, 37, 254, 192, 84, 224, 57, 155, 170, 263, 238, 219,
+	65, 260, 121, 7, 114, 81, 243, 51, 173, 104, 244, 145, 251, 48, 232, 168,
+	107, 102, 106, 90, 211, 42, 112, 119, 85, 79, 216, 55, 96, 3, 22, 122,
+	247, 68, 118, 178, 53, 110, 138, 72, 103, 258, 184, 12, 196, 86, 167, 218,
+	19, 32, 171, 69, 46, 259, 158, 236, 30, 36, 209, 215, 164, 210, 233, 231,
+	191, 257, 56, 23, 229, 137, 95, 16, 214, 70, 141, 153, 268, 223, 83, 256,
+	126, 261, 40, 160, 31, 202, 174, 149, 199, 71, 190, 225, 116, 269,
+};
+
+static const int propertyDisplacements[] = {
+	1, -5, 0, -6, 1, 1, -8, -9, 1, -13, 0, 0, -14, 4, 0, 0,
+	-16, 2, 1, 0, 0, -20, 0, 0, -22, 0, -23, 0, 0, 0, 1, 0,
+	1, 0, -25, -27, 0, -33, -39, 0, -42, -45, 3, 2, 0, 1, 2, 1,
+	-47, 0, -49, 1, -51, -52, 0, 1, -54, 4, 1, 1, -58, 0, 2, 0,
+	-59, 4, -64, 0, 7, 0, 8, 5, -66, -67, -69, 0, -70, -72, 0, 13,
+	-73, 1, 1, 0, 0, 2, -75, 0, 0, -79, -87, -93, -105, -106, -108, -111,
+	0, -115, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 4, -120, 3,
+	2, 5, 0, 0, 0, -121, -122, 0, 2, 0, -125, -127, -129, 5, 0, -130,
+	-133, 0, 0, 0, 7, 0, -135, 0, -137, -138, 4, -139, 0, -141, 11, 2,
+	-143, 0, -151, -152, 2, -153, -154, -155, -159, 0, 0, -160, -168, 0, -171, -175,
+	1, 0, 0, 0, 13, 0, 0, 2, -176, 2, 0, 0, 3, 0, -180, -182,
+	0, -183, 0, 0, -185, 0, 0, 0, 0, 7, 0, 0, -186, 0, 0, 4,
+	1, 1, -189, 0, 8,
+};
+
+static const int propertySlots[] = {
+	188, 173, 140, 100, 95, 54, 168, 89, 165, 127, 14, 39, 75, 32, 187, 177,
+	62, 98, 76, 158, 71, 148, 186, 91, 94, 106, 74, 117, 162, 120, 10, 196,
+	1, 176, 56, 77, 83, 57, 149, 102, 113, 129, 119, 35, 130, 92, 47, 22,
+	25, 160, 110, 40, 145, 3, 195, 79, 161, 141, 104, 144, 175, 183, 169, 107,
+	24, 51, 90, 9, 68, 128, 185, 0, 167, 189, 124, 146, 126, 72, 82, 67,
+	174, 179, 137, 2, 138, 44, 64, 28, 85, 59, 111, 116, 114, 152, 12, 103,
+	125, 19, 181, 49, 84, 191, 43, 157, 53, 171, 151, 192, 69, 105, 139, 6,
+	163, 31, 61, 11, 132, 21, 112, 17, 60, 164, 29, 134, 41, 26, 99, 135,
+	58, 86, 131, 142, 16, 172, 109, 18, 63, 190, 133, 37, 42, 155, 194, 136,
+	38, 97, 166, 20, 193, 33, 123, 182, 88, 8, 15, 178, 96, 153, 80, 87,
+	7, 13, 4, 36, 184, 150, 27, 101, 66, 50, 65, 52, 122, 70, 93, 115,
+	170, 180, 30, 154, 23, 5, 48, 159, 147, 78, 45, 73, 34, 55, 156, 81,
+	143, 108, 46, 118, 121,
+};
+
+static const int valueDisplacements[] = {
+	-7, 7, 14, -9, 4, -11, 0, -15, 0, -16, 1, 0, 0, -19, -23, -24,
+	-26, 11, -32, 1, -36, 0, 0, 0, 1, 0, 0, 1, 13, -38, -40, 1,
+	0, 0, -41, 1, 7, -45, 0, -46, 0, 9, -49, -50, 0, 1, 0, -53,
+	-59, -60, -63, 0, 1, 0, 0, 0, 0, 0, 0, -67, 0, 1, 5, -72,
+	1, 7, -75, 0, 0, -76, -77, 1, -78, 1, 0, 0, 1, 0, 0, 0,
+	-79, -81, 6, 0, -82, -86, 36, -93, -95, 4, 0, -97, 0, 0, -99, 0,
+	4, 0, -100, 0, 0, -105, 1, -107, 1, -108, 0, -110, -116, 1, 0, -118,
+	0, 1, 1, -119, -121, -126, 0, -127, -128, 10, -129, 0, 0, -130, -131, 0,
+	4, 0, -136, 1, 4, 4, -137, 0, 5, 0, 0, 0, -142, 1, 3, -144,
+	1, 0, 5, 0, 2, 5, 0, 0, -146, 0, -147, -150, -152, 1, 1, 0,
+	-154, -155, -156, 0, 0, 0, -159, 2, -160, -161, 1, 0, 2, 1, 0, 0,
+	-165, 0, -170, 0, 21, -173, 0, -176, 2, 0, -178, 6, 18, 0, 1, -183,
+	0, 0, 0, 0, -185, 0, -189, -195, 4, 12, -197, -199, 0, 1, 0, 0,
+	-203, -204, 0, -206, 5, -209, 0, 1, 0, 0, 0, -210, -212, -214, 0, -215,
+	7, 50, 0, 0, 3, 1, 1, 0, 0, 0, 0, 0, -226, -237, 0, 0,
+	0, 8, -242, 25, -246, 0, 41, 0, -249, 1, -250, 0, -251, 5, 0, -257,
+	0, 21, 0, -262, 0, 0, -267, -268, -271, 12, 0, 0, -272, -273, -275, 7,
+	1, 6, -277, 1, 1, 0, 0, -280, 0, -282, 0, 0, 17, -292, -296, 5,
+	2, 0, 0, -297, 0, -298, -300, 1, 0, 0, 3, -306, 0, 0, -311, -317,
+	-318, 10, 0, -322, -325, -328, -330, 14, -331, 0, 0, 20, 0, 5, 0, -332,
+	1, 1, 2, 0, -337, 0, 1, 31, 0, 0, -338, 0, 0, -341, 1, 0,
+	-344, 2, 0, -351, 35, 0, -352, -353, 0, 0, 0, -359, -363, -365, 0, -369,
+	-373, -374, -375, 1, 0, 3, -377, -378, 0, 11, 0, 0, 0, -383, -387, -388,
+	-392, 0, 6, 0, -394, -395, -397, -398, -399, -404, -405, 4, 0, 2, 55, 0,
+	0, -406, -409, 7, 0, 0, 0, 0, 0, 1, 17, 0, 2, -415, -418, 0,
+	1, 0, 1, 0, 0, 6, 7, 0, -420, -422, 0, -423, 7, 0, 0, 0,
+	0, 0, 0, -426, 2, -427, 0, -428, 0, 10, 5, 1, 0, 0, 0, -429,
+	-430, 0, 0, 0, 0, 0, 0, -433, -434, -436, 0, 0, 19, 0, -439, 0,
+	17, -441, -442, 2, 0, -444, 1, 42, 0, -449, -456, -457, -460, 1, 1, 0,
+	-461, -462, -464, 0, -469, 0, 4, -470, -475, 0, -477, -481, 0, 0, -482, 0,
+	-487, -492, -493, 0, -496, 1, 0, 0, -499, 0, 0, 0, -500, 0, 0, -504,
+	-507, 4, 0, 1, 4, -508, -512, 0, 6, -515, 2, 0, -516, 0, 0, -519,
+	27, -524, 0, 1, -525, 0, 1, 0, -528, 8, 0, 27, 0, 0, -530, 0,
+	0, 1, 0, 4, -532, 0, 40, -544, -545, 0, 0, -546, 0, -547, -550, 0,
+	-553, -554, 0, -555, 8, -561, -563, -568, 0, -577, 1, -579, -583, 0, -585, 0,
+	-587, -588, -590, 18, 9, -593, 0, -595, 0, -597, -602, 3, 0, -604, 0, 0,
+	0, 0, 0, 0, -609, 0, 0, -613, -614, 1, -617, 1, 3, -626, -631, -635,
+	-636, 26, 14, 0, 0, 15, 1, 0, 2, -641, 3, 44, 0, -642, 4, -645,
+	-649, 1, 0, 19, 1, 0, 0, 1, 30, -654, 7, 0, -661, 1, 7, 0,
+	-663, -665, 0, 1, 0, 0, 0, -667, -668, -672, 17, 0, 0, 0, -676, 0,
+	1, 0, 3, -682, 0, 0, 0, -684, -686, -689, 0, 36, 0, 0, 0, 0,
+	-690, 0, -696, 2, -697, -700, -702, -704, -705, 0, 0, 19, 0, -707, -708, 140,
+	1, -711, 0, 0, 0, -714, -715, 0, 3, -720, -722, -723, 0, -724, 0, 6,
+	0, -725, -726, 0, 4, 0, 91, 0, 4, 1, 20, 129, 18, 122, 0, -729,
+	5, -730, 0, 10, 0, 6, 7, 0, 0, -732, 0, -735, 4, -738, 0, -739,
+	9, 0, 3, -742, -743, 0, -745, 0, 47, 139, 31, 0, 66, -746, 95, -748,
+	0, -749, 0, 9, 0, 47, -751, 1, 0, 0, 0, 0, 4, 0, 0, -754,
+	62, 0, 27, 0, -760, -761, 118, 53, -762, -764, 0, 0, 0, 14, 0, -766,
+	-768, 8, 48, 259, 0, 0, -771, -775, -777, 0, 0, 92, 0, 0, -780, -781,
+	69, 0, -787, 0, -789, 0, 0, 25, 0, 137, 0, 8, 0, 4, 132, 0,
+	-791, -794, 0, -795, 7, 109, 0, -796, -797, -799, 56, -802, 1, 0, 0, 4,
+	134, 0, 98, -803, 0, -804, 0, -807, 0, 0, 0, -808, 0, 0, 258, 61,
+	0, 10, 0, -809, -815, 0, 1, 0, -816, 96, -818, 0, 49, 0, -822, -824,
+	5, -832, 0, -834, 214, 0, -835, -837, -842, 182, 0, -844, -846, 0, 0, 0,
+	-859, 0, 6, 201, 0, -866, 0, 0, 13, 0, -868, 0, -869, -870, 0, 0,
+	0, -871, -872, -873, -877, 0, 0, -878, -882, -883, -885, 0, -892, 6, 0, -894,
+	37, -901, 0, 77, 0, 0, 0, 0, -904, 16, 1, -913, 282, -915, -916, 261,
+	7, -917, 0, 0, -918, 0, 16, 0, -919, 0, -923, -926, 2, 39,
+};
+
+static const int valueSlots[] = {
+	-7, -56, -838, -99, -156, -1932, -2040, -779, -14, 153, -1759, -829, -205, -1810, 176, 263,
+	-2024, -1, 155, -1751, -29, 83, -782, -35, -1776, -1994, -202, -142, 72, -1887, -1889, -43,
+	-818, -1913, -1844, -1683, -55, 1, -1853, -2007, 85, -1876, -16, 247, 96, 112, 122, -1738,
+	237, 246, 166, -143, 264, -177, 125, 189, 59, -221, -1694, 210, -786, -70, 46, -114,
+	-1746, -2030, -1891, -51, -1999, 126, -1827, -1926, -1748, -180, -2229, -855, -1866, 217, -2116, -22,
+	-794, 170, 208, -161, 76, 178, -1839, -1732, -1809, -1767, -1944, -1773, -1991, -116, 262, -129,
+	259, 227, -1914, -1749, -1948, 42, -47, -2003, 220, 21, 198, 89, -1860, -791, -1734, -111,
+	-808, -1888, -834, -72, -166, -1964, -1707, -95, -1939, -1832, -1720, 260, -61, 252, -1984, -1954,
+	-1978, -69, 214, -2025, -104, 107, 0, -1754, -789, -1803, 64, 37, -125, -800, 20, 44,
+	-1993, 53, 172, 75, -92, -97, -182, -1875, -1713, 78, -89, 253, 84, -79, -32, -2023,
+	-132, 245, -1719, -1824, -1960, -1687, -1755, -1882, -213, 218, -1923, -21, -18, -112, -1873, -167,
+	-1987, 171, 94, -1800, 182, -1828, 129, 41, -1958, 90, -2004, -1886, -1764, -1704, -206, 235,
+	-1874, 139, 81, -33, -2331, -1946, 58, -1869, -1790, -1972, 216, 180, -1696, 115, -1900, -86,
+	-783, -2035, 199, 30, -1835, 142, -1756, -138, 151, -1936, 106, -856, -1969, -1918, -1904, 100,
+	9, -1924, -215, -144, -780, 174, -1752, -1717, -1919, -2017, -853, 251, 236, -165, -1962, -1942,
+	233, -1797, -1884, -1774, -2012, 152, -790, -135, 47, -1788, -845, -1798, -151, -1780, -1766, 117,
+	-1871, -2015, -819, -1968, -1806, 195, -1848, -1979, -1698, 250, -1990, -2099, 29, -1691, -2132, -1961,
+	-136, -854, -31, -1758, 196, -2141, -2209, -1794, -2013, 98, -1867, -1838, 167, -1740, -1967, -102,
+	144, -813, 203, -2263, -137, 10, -2286, 224, 226, -154, -133, -199, -163, -826, 150, 73,
+	-1988, -107, -155, 159, -152, -100, -2060, -1878, -1786, 118, -2092, -1825, 244, 257, -787, -110,
+	-2230, 211, 51, -146, -1753, 27, 143, 213, -171, 43, -2019, -1956, -822, -798, 190, -1733,
+	-1768, -1690, -2044, -1817, -1807, 269, -17, -2010, -1833, 163, 7, -96, 183, -1682, 120, -204,
+	-71, 18, -64, -38, -1910, -25, -844, 119, -1851, -40, -1728, -1981, 105, -1909, 266, -2193,
+	-1974, -1819, -1761, -1705, 146, 229, -1997, -106, -1985, -1934, 54, 92, -850, -1679, 193, -1823,
+	-1724, -1731, 111, 154, 23, -1747, 258, -193, 221, -1977, -1896, -2300, -806, 222, -1902, 138,
+	-1709, 6, -2021, -1854, -117, -852, -1836, -2297, -30, -1879, -195, -816, 74, 48, 135, -1965,
+	-1899, -2028, -796, -2000, -1784, -1693, -1907, -26, -1837, -1953, 26, -793, 57, 240, -1814, -846,
+	-2032, -1688, 181, -134, -2081, -1793, 243, -219, 242, -784, -176, -1986, -2199, -45, -73, -1897,
+	-1830, -1710, -1925, -1712, -2194, -1856, -2018, 102, -1885, -78, 215, 123, -1727, -128, 50, -122,
+	25, -2, -2200, -2192, -67, -1726, -1762, -191, 55, -1863, -2232, -139, -141, 223, -148, 14,
+	-781, -1963, -804, -140, -42, 3, -1796, -75, -1684, -1763, 95, -83, 185, -1701, 177, -1778,
+	-1822, 15, -81, -1970, -24, -54, -1894, 77, -1816, 16, -118, -2031, 131, -2020, -130, -2011,
+	56, -785, -1890, -1737, -839, -1815, -805, -1858, -126, 109, -1813, -1950, -150, -788, -815, 52,
+	-1859, 209, -1795, -1912, -3, -2323, 179, -2009, 67, -1883, -123, 186, -57, 62, -36, -1901,
+	-168, -1870, -1680, -103, 39, 17, 234, -2026, -1861, 249, 256, -1862, 69, -74, -1973, -119,
+	-1792, -160, -2022, -2008, 24, -1700, -842, 206, -1801, -801, -840, -792, 192, -109, -1957, -2332,
+	149, -807, 22, 4, 13, 11, 140, 231, -2294, -121, -2089, -2046, -62, -1849, -2095, 110,
+	-1745, -52, -1722, -2034, -1843, -1916, -65, -1940, -1765, 103, -1865, 66, -811, -189, 34, -2001,
+	70, 261, -1689, -1921, -1743, -2014, -23, -2287, -60, -1915, 158, -63, -1959, -1695, -164, 28,
+	-1711, 137, 265, -1735, -2126, -1952, -1976, 228, -217, -211, -1998, 188, -812, -1966, -1945, -1937,
+	124, -1920, -1922, -1685, -2005, -93, -178, 225, -1750, -2006, -2083, -1715, -53, -810, -1864, -2211,
+	-1826, 71, 136, -66, -1947, -1757, -1996, -87, 160, -1787, -1799, 168, -1802, 164, -1975, 93,
+	-1692, -1949, -1903, 97, -1703, 133, 19, -1917, -223, -2195, -2198, 36, -1782, 212, -169, -1982,
+	-1933, -2290, 239, -797, -98, -833, 204, -39, 267, -27, -1821, -1718, -1808, -1779, 197, -1971,
+	-1995, -2146, -1938, -174, -105, 230, -1775, -101, -2231, -2210, 31, -1777, -1980, -1931, 114, 184,
+	8, 60, -108, -127, -2027, -2084, 65, -2038, 200, -157, 38, -1805, 101, 116, -1906, 86,
+	-1951, -58, -1943, -1892, -1723, -203, -1744, -50, -1989, -1929, -778, -1840, -1911, 232, -1928, 130,
+	-145, -59, 254, 165, -2002, -1872, -88, -1771, -8, -1721, 219, -1742, -1716, -803, 148, -1935,
+	-814, -848, -1895, 32, 132, -201, 79, -186, -1820, -1857, -799, 201, -1818, -41, 68, 141,
+	-28, -1730, -1760, -153, -1686, -809, 187, 49, -1714, -173, 147, -1927, -94, -1789, -68, 91,
+	-1908, 35, -1845, -113, -162, 191, 175, -2033, -82, 104, -795, -1781, 156, 134, -120, -1699,
+	-48, -197, -1812, 161, 127, -2016, -77, -1855, -1725, -158, -91, -159, 145, 63, -847, -1770,
+	-1222, -1868, 108, -1785, 248, -2129, -1941, 80, 241, 2, -85, -1697, 255, -1880, -2292, -46,
+	-80, -34, 194, -1804, -131, 113, 33, -19, -1992, -1881, -1893, -1846, -1842, 173, -84, -1741,
+	121, -1783, -2176, -1729, 82, 202, 205, -1898, -15, -2201, -149, -1708, -1852, 40, 162, -1955,
+	-1831, -20, 12, -10, -1877, -1983, 99, -1829, -115, 207, -1736, -175, -2333, -2293, -1791, -1706,
+	-817, -1739, -76, -124, -1847, 157, 88, -2029, -44, -49, 169, -1841, -1772, -1834, -1850, -147,
+	-1811, -1702, 238, 61, -1905, 128, -37, 268, 87, 5, -1769, 45, -1930, -90,
+};
+
+enum {
+	valueCount = 926
+};
+
 //--Autogenerated
 
 const IFaceFunction * const IFaceTable::functions = ifaceFunctions;
@@ -2983,6 +3681,100 @@ const int IFaceTable::constantCount = ifaceConstantCount;
 const IFaceProperty * const IFaceTable::properties = ifaceProperties;
 const int IFaceTable::propertyCount = ifacePropertyCount;
 
+// Names and values are found through the perfect hash tables generated by
+// IFaceTableGen.py so these hash functions must match HashBytes there.
+
+static unsigned int HashFinish(unsigned int h) {
+	h ^= h >> 16;
+	h *= 0x85EBCA6Bu;
+	h ^= h >> 13;
+	h *= 0xC2B2AE35u;
+	h ^= h >> 16;
+	return h;
+}
+
+static unsigned int HashName(unsigned int seed, const char *name) {
+	unsigned int h = seed ? seed : 0x811C9DC5u;
+	for (; *name; name++) {
+		h = (h ^ static_cast<unsigned char>(*name)) * 0x01000193u;
+	}
+	return HashFinish(h);
+}
+
+static unsigned int HashValue(unsigned int seed, int value) {
+	unsigned int h = seed ? seed : 0x811C9DC5u;
+	unsigned int bytes = static_cast<unsigned int>(value);
+	for (int i = 0; i < 4; i++) {
+		h = (h ^ (bytes & 0xFF)) * 0x01000193u;
+		bytes >>= 8;
+	}
+	return HashFinish(h);
+}
+
+// The slot holding the index of the only entry that may match
+static int SlotForName(const char *name, const int *displacements, int size) {
+	const int displacement = displacements[HashName(0, name) % size];
+	if (displacement < 0)
+		return -displacement - 1;
+	return HashName(displacement, name) % size;
+}
+
+static int SlotForValue(int value, const int *displacements, int size) {
+	const int displacement = displacements[HashValue(0, value) % size];
+	if (displacement < 0)
+		return -displacement - 1;
+	return HashValue(displacement, value) % size;
+}
+
+int IFaceTable::FindConstant(const char *name) {
+	const int idx = constantSlots[SlotForName(name, constantDisplacements, constantCount)];
+	return (strcmp(name, constants[idx].name) == 0) ? idx : -1;
+}
+
+int IFaceTable::FindFunction(const char *name) {
+	const int idx = functionSlots[SlotForName(name, functionDisplacements, functionCount)];
+	return (strcmp(name, functions[idx].name) == 0) ? idx : -1;
+}
+
+int IFaceTable::FindFunctionByConstantName(const char *name) {
+	// Function constants are not in the constants table so have a table of their own
+	const int idx = functionConstantSlots[SlotForName(name, functionConstantDisplacements, functionCount)];
+	return (strcmp(name, ifaceFunctionConstants[idx]) == 0) ? idx : -1;
+}
+
+int IFaceTable::FindProperty(const char *name) {
+	const int idx = propertySlots[SlotForName(name, propertyDisplacements, propertyCount)];
+	return (strcmp(name, properties[idx].name) == 0) ? idx : -1;
+}
+
+int IFaceTable::GetConstantName(int value, char *nameOut, unsigned nameBufferLen) {
+	if (nameOut && nameBufferLen > 0) {
+		*nameOut = '\0';
+	}
+
+	// The first function with the value is preferred over any constant so the
+	// table holds function indices and constants as -1-index.
+	const int idx = valueSlots[SlotForValue(value, valueDisplacements, valueCount)];
+	const char *name = 0;
+	if (idx >= 0) {
+		if (functions[idx].value == value)
+			name = ifaceFunctionConstants[idx];
+	} else {
+		if (constants[-1 - idx].value == value)
+			name = constants[-1 - idx].name;
+	}
+	if (!name)
+		return 0;
+
+	int len = static_cast<int>(strlen(name));
+	if (nameOut && (static_cast<int>(nameBufferLen) > len)) {
+		strcpy(nameOut, name);
+		return len;
+	} else {
+		return -1 - len;
+	}
+}
+
 #ifdef _MSC_VER
 // Unreferenced inline functions are OK
 #pragma warning(disable: 4514)
@@ -0,0 +1,200 @@
+// SciTE - Scintilla based Text Editor
+/** @file ImportPrefetch.cxx
+ ** Implementation of reading properties files on other threads before they are imported.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+
+#if defined(__unix__)
+
+#include <unistd.h>
+
+#else
+
+#undef _WIN32_WINNT
+#define _WIN32_WINNT  0x0500
+#ifdef _MSC_VER
+// windows.h, et al, use a lot of nameless struct/unions - can't fix it, so allow it
+#pragma warning(disable: 4201)
+#endif
+#include <windows.h>
+#ifdef _MSC_VER
+// okay, that's done, don't allow it in our code
+#pragma warning(default: 4201)
+#endif
+
+#endif
+
+#include "Scintilla.h"
+
+#include "GUI.h"
+#include "SString.h"
+#include "FilePath.h"
+#include "PropSetFile.h"
+#include "Mutex.h"
+#include "Worker.h"
+#include "ImportPrefetch.h"
+
+struct PrefetchedFile {
+	enum State { pending, reading, read, taken };
+	FilePath path;
+	State state;
+	bool exists;
+	std::vector<char> lines;
+	explicit PrefetchedFile(const FilePath &path_) : path(path_), state(pending), exists(false) {
+	}
+};
+
+struct PrefetchWorker : public Worker {
+	ImportPrefetch *prefetch;
+	explicit PrefetchWorker(ImportPrefetch *prefetch_) : prefetch(prefetch_) {
+	}
+	virtual void Execute() {
+		prefetch->ReadPending();
+		completed = true;
+	}
+};
+
+static void WaitBriefly() {
+#ifdef __unix__
+	usleep(1000);
+#else
+	::Sleep(1);
+#endif
+}
+
+ImportPrefetch::ImportPrefetch(WorkerListener *pListener_, int maxThreads_) :
+	pListener(pListener_), maxThreads(maxThreads_), mutex(Mutex::Create()), fileRead(Event::Create()),
+	nextPending(0), running(0) {
+}
+
+ImportPrefetch::~ImportPrefetch() {
+	{
+		Lock lock(mutex);
+		// Stop the threads from starting more files
+		nextPending = files.size();
+	}
+	for (size_t w = 0; w < workers.size(); w++) {
+		while (!workers[w]->FinishedJob())
+			WaitBriefly();
+		delete workers[w];
+	}
+	for (size_t f = 0; f < files.size(); f++)
+		delete files[f];
+	delete fileRead;
+	delete mutex;
+}
+
+/// Start reading a file unless it is already waiting to be taken.
+void ImportPrefetch::Request(const FilePath &path) {
+	Lock lock(mutex);
+	if (requested.find(path) != requested.end())
+		return;
+	PrefetchedFile *file = new PrefetchedFile(path);
+	files.push_back(file);
+	requested[path] = file;
+	if (running < maxThreads) {
+		PrefetchWorker *worker = new PrefetchWorker(this);
+		running++;
+		if (pListener->PerformOnNewThread(worker)) {
+			workers.push_back(worker);
+		} else {
+			// Files not read by a thread are read when taken
+			running--;
+			delete worker;
+			maxThreads = running;
+		}
+	}
+}
+
+/**
+ * Move the lines of a requested file into @a lines, setting @a exists to whether it
+ * could be read. Returns false when the file was not requested.
+ */
+bool ImportPrefetch::Take(const FilePath &path, std::vector<char> &lines, bool &exists) {
+	for (;;) {
+		PrefetchedFile *file = 0;
+		{
+			Lock lock(mutex);
+			std::map<FilePath, PrefetchedFile *>::iterator it = requested.find(path);
+			if (it == requested.end())
+				return false;
+			file = it->second;
+			if (file->state == PrefetchedFile::read) {
+				lines.swap(file->lines);
+				exists = file->exists;
+				file->state = PrefetchedFile::taken;
+				requested.erase(it);
+				return true;
+			}
+			if (file->state == PrefetchedFile::pending) {
+				file->state = PrefetchedFile::taken;
+				requested.erase(it);
+			} else {
+				file = 0;
+			}
+		}
+		if (file) {
+			// No thread has started so quicker to read it here than wait
+			exists = ReadPropertiesLines(path, lines);
+			return true;
+		}
+		// Reading any file signals so check again after each
+		fileRead->Wait(1000);
+	}
+}
+
+/**
+ * Forget the files taken and those requested but never taken, such as when the user
+ * properties file is requested but not read as the global properties changed. Files
+ * being read are kept until their threads have finished with them.
+ */
+void ImportPrefetch::Forget() {
+	Lock lock(mutex);
+	std::vector<PrefetchedFile *> reading;
+	for (size_t f = 0; f < files.size(); f++) {
+		if (files[f]->state == PrefetchedFile::reading) {
+			reading.push_back(files[f]);
+		} else {
+			delete files[f];
+		}
+	}
+	files.swap(reading);
+	requested.clear();
+	nextPending = 0;
+}
+
+/// Called on each thread to read requested files until there are none left.
+void ImportPrefetch::ReadPending() {
+	for (;;) {
+		PrefetchedFile *file = 0;
+		{
+			Lock lock(mutex);
+			while ((nextPending < files.size()) && (files[nextPending]->state != PrefetchedFile::pending))
+				nextPending++;
+			if (nextPending >= files.size()) {
+				running--;
+				return;
+			}
+			file = files[nextPending];
+			file->state = PrefetchedFile::reading;
+		}
+		std::vector<char> lines;
+		const bool exists = ReadPropertiesLines(file->path, lines);
+		{
+			Lock lock(mutex);
+			file->lines.swap(lines);
+			file->exists = exists;
+			file->state = PrefetchedFile::read;
+		}
+		fileRead->Signal();
+	}
+}
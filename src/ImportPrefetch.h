@@ -0,0 +1,46 @@
+// SciTE - Scintilla based Text Editor
+/** @file ImportPrefetch.h
+ ** Definition of reading properties files on other threads before they are imported.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef IMPORTPREFETCH_H
+#define IMPORTPREFETCH_H
+
+struct PrefetchedFile;
+struct PrefetchWorker;
+
+/**
+ * Reads properties files and splits them into lines on a few threads so that files
+ * about to be imported are ready when the main thread reaches them.
+ * Only the reading is done early: the lines are still applied in import order on the
+ * main thread as "if" lines test the values set by the files before them.
+ * Files are requested when the list of imports is known, such as after listing the
+ * directory for "import *", then taken in order. Taking a file that no thread has started
+ * reads it on the calling thread and taking one that is being read waits for it.
+ * Files from earlier reads are forgotten by Forget before properties are read again.
+ */
+class ImportPrefetch {
+	WorkerListener *pListener;
+	int maxThreads;
+	Mutex *mutex;
+	Event *fileRead;	///< Signalled when a thread finishes reading a file
+	std::vector<PrefetchedFile *> files;	///< In the order requested
+	std::map<FilePath, PrefetchedFile *> requested;	///< Files requested and not yet taken
+	size_t nextPending;
+	int running;
+	std::vector<PrefetchWorker *> workers;
+	// Private so ImportPrefetch objects can not be copied
+	ImportPrefetch(const ImportPrefetch &);
+	ImportPrefetch &operator=(const ImportPrefetch &);
+public:
+	ImportPrefetch(WorkerListener *pListener_, int maxThreads_);
+	~ImportPrefetch();
+	void Request(const FilePath &path);
+	bool Take(const FilePath &path, std::vector<char> &lines, bool &exists);
+	void Forget();
+	void ReadPending();
+};
+
+#endif
@@ -11,18 +11,27 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
 
 #include "Scintilla.h"
+#include "ILexer.h"
 
 #include "GUI.h"
 #include "SString.h"
 #include "FilePath.h"
+#include "Cookie.h"
+#include "Mutex.h"
+#include "Worker.h"
+#include "FileWorker.h"
 #include "StyleWriter.h"
 #include "Extender.h"
 #include "LuaExtension.h"
 
 #include "IFaceTable.h"
 #include "SciTEKeys.h"
+#include "StartupProfile.h"
 
 extern "C" {
 #include "lua.h"
@@ -43,6 +52,7 @@ extern "C" {
 
 #else
 
+#include <unistd.h>
 #include <limits.h>
 #ifdef PATH_MAX
 #define MAX_PATH PATH_MAX
@@ -79,12 +89,13 @@ static bool tracebackEnabled = true;
 static int maxBufferIndex = -1;
 static int curBufferIndex = -1;
 
-static int GetPropertyInt(const char *propName) {
-	int propVal = 0;
+static int GetPropertyInt(const char *propName, int defaultValue=0) {
+	int propVal = defaultValue;
 	if (host) {
 		char *pszPropVal = host->Property(propName);
 		if (pszPropVal) {
-			propVal = atoi(pszPropVal);
+			if (*pszPropVal)
+				propVal = atoi(pszPropVal);
 			delete [] pszPropVal;
 		}
 	}
@@ -330,6 +341,88 @@ static int cf_scite_strip_value(lua_State *L) {
 	return 0;
 }
 
+// Handlers added with scite.AddHandler are kept in the registry as a table
+// mapping each event name to an array of functions.
+static bool handlersAdded = false;	// So events need not look there when none have been added
+
+static void push_handler_lists(lua_State *L) {
+	lua_getfield(L, LUA_REGISTRYINDEX, "SciTE_Handlers");
+	if (!lua_istable(L, -1)) {
+		lua_pop(L, 1);
+		lua_newtable(L);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, LUA_REGISTRYINDEX, "SciTE_Handlers");
+	}
+}
+
+// copy a table of handler lists so that later additions do not change the copy,
+// leaving it at the top of the stack
+static void clone_handler_lists(lua_State *L, int srcTableIdx) {
+	srcTableIdx = absolute_index(L, srcTableIdx);
+	lua_newtable(L);
+	lua_pushnil(L);
+	while (lua_next(L, srcTableIdx) != 0) {
+		lua_pushvalue(L, -2);
+		clone_table(L, -2);
+		lua_rawset(L, -5);
+		lua_pop(L, 1);
+	}
+}
+
+static int cf_scite_add_handler(lua_State *L) {
+	const char *name = luaL_checkstring(L, 1);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+	handlersAdded = true;
+	push_handler_lists(L);
+	lua_getfield(L, -1, name);
+	if (!lua_istable(L, -1)) {
+		lua_pop(L, 1);
+		lua_newtable(L);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, -3, name);
+	}
+	lua_pushvalue(L, 2);
+	lua_rawseti(L, -2, static_cast<int>(lua_objlen(L, -2)) + 1);
+	return 0;
+}
+
+static int cf_scite_remove_handler(lua_State *L) {
+	const char *name = luaL_checkstring(L, 1);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+	bool removed = false;
+	push_handler_lists(L);
+	lua_getfield(L, -1, name);
+	if (lua_istable(L, -1)) {
+		int list = lua_gettop(L);
+		int n = static_cast<int>(lua_objlen(L, list));
+		for (int i = 1; i <= n && !removed; i++) {
+			lua_rawgeti(L, list, i);
+			removed = lua_rawequal(L, -1, 2) != 0;
+			lua_pop(L, 1);
+			if (removed) {
+				for (; i < n; i++) {
+					lua_rawgeti(L, list, i + 1);
+					lua_rawseti(L, list, i);
+				}
+				lua_pushnil(L);
+				lua_rawseti(L, list, n);
+			}
+		}
+		if (n <= 1 && removed) {
+			// An empty list would still cost a call to look through
+			lua_pushnil(L);
+			lua_setfield(L, -3, name);
+		}
+	}
+	lua_pushboolean(L, removed ? 1 : 0);
+	return 1;
+}
+
+static void check_pane_accessible(lua_State *L, ExtensionAPI::Pane p) {
+	if ((p == ExtensionAPI::paneEditor) && (curBufferIndex < 0))
+		raise_error(L, "Editor pane is not accessible at this time.");
+}
+
 static ExtensionAPI::Pane check_pane_object(lua_State *L, int index) {
 	ExtensionAPI::Pane *pPane = reinterpret_cast<ExtensionAPI::Pane *>(checkudata(L, index, "SciTE_MT_Pane"));
 
@@ -342,9 +435,7 @@ static ExtensionAPI::Pane check_pane_object(lua_State *L, int index) {
 	}
 
 	if (pPane) {
-		if ((*pPane == ExtensionAPI::paneEditor) && (curBufferIndex < 0))
-			raise_error(L, "Editor pane is not accessible at this time.");
-
+		check_pane_accessible(L, *pPane);
 		return *pPane;
 	}
 
@@ -765,9 +856,7 @@ static bool call_function(lua_State *L, int nargs, bool ignoreFunctionReturnValu
 	if (L) {
 		int traceback = 0;
 		if (tracebackEnabled) {
-			lua_getglobal(L, "debug");
-			lua_getfield(L, -1, "traceback");
-			lua_remove(L, -2);
+			lua_getfield(L, LUA_REGISTRYINDEX, "SciTE_Traceback");
 			if (lua_isfunction(L, -1)) {
 				traceback = lua_gettop(L) - nargs - 1;
 				lua_insert(L, traceback);
@@ -807,14 +896,426 @@ static bool call_function(lua_State *L, int nargs, bool ignoreFunctionReturnValu
 	return handled;
 }
 
+// Timing of each function handling events or commands, enabled with ext.lua.profile.
+// Kept across resets of the global scope so a session can be profiled as a whole.
+struct HandlerProfile {
+	enum { recentCalls=4096, stackDepth=16 };
+	int calls;
+	double total;
+	double longest;
+	std::vector<double> recent;	// Durations of the latest calls, for percentiles
+	std::map<std::string, int> stacks;	// Sampled stacks, outermost function first
+	std::set<std::string> events;	// Events and commands the function was called for
+	HandlerProfile() : calls(0), total(0.0), longest(0.0) {
+	}
+	std::string Events() const {
+		std::string names;
+		for (std::set<std::string>::const_iterator it = events.begin(); it != events.end(); ++it) {
+			if (!names.empty())
+				names += ',';
+			names += *it;
+		}
+		return names;
+	}
+	void Add(double duration) {
+		if (recent.size() < recentCalls)
+			recent.push_back(duration);
+		else
+			recent[calls % recentCalls] = duration;
+		calls++;
+		total += duration;
+		if (longest < duration)
+			longest = duration;
+	}
+	double Percentile(double fraction) const {
+		if (recent.empty())
+			return 0.0;
+		std::vector<double> sorted(recent);
+		std::vector<double>::iterator nth = sorted.begin() +
+			static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+		std::nth_element(sorted.begin(), nth, sorted.end());
+		return *nth;
+	}
+};
+
+static bool profileEnabled = false;
+static int profileSampleInterval = 0;
+static std::map<std::string, HandlerProfile> profiles;	// By where the function is defined
+static HandlerProfile *profileCurrent = 0;
+static GUI::ElapsedTime handlerClock;
+
+static double HandlerTime() {
+	// Copy so that the clock is not reset
+	GUI::ElapsedTime clock = handlerClock;
+	return clock.Duration();
+}
+
+// Limit on how long each event handler may run, from ext.lua.budget.  Checked by
+// a count hook so only stops Lua code, not a long call into a C function.
+static double budgetSeconds = 0.0;
+static int budgetTrips = 3;	// Times a handler may exceed the budget before it is disabled
+static double budgetDeadline = 0.0;	// When the running handler is stopped, 0.0 for no limit
+static bool budgetExceeded = false;
+static const char *budgetEvent = "";
+static int sinceSample = 0;
+enum { budgetCheckInterval=1000 };
+
+// A hook set by scripts with debug.sethook, put aside while instruction_hook is installed.
+// Its events are passed on so it keeps working during handlers and is restored after them.
+static lua_Hook scriptHook = NULL;
+static int scriptHookMask = 0;
+static int scriptHookCount = 0;
+static int sinceScriptHook = 0;
+
+// Record the stack running inside the current handler
+static void SampleStack(lua_State *L) {
+	std::vector<std::string> frames;
+	lua_Debug frame;
+	for (int level = 0; (level < HandlerProfile::stackDepth) && lua_getstack(L, level, &frame); level++) {
+		lua_getinfo(L, "Sl", &frame);
+		char location[LUA_IDSIZE + 20];
+		if (frame.currentline > 0)
+			sprintf(location, "%s:%d", frame.short_src, frame.currentline);
+		else
+			sprintf(location, "%s", frame.short_src);
+		frames.push_back(location);
+	}
+	std::string stack;
+	for (std::vector<std::string>::reverse_iterator it = frames.rbegin(); it != frames.rend(); ++it) {
+		if (!stack.empty())
+			stack += ';';
+		stack += *it;
+	}
+	profileCurrent->stacks[stack]++;
+}
+
+static void instruction_hook(lua_State *L, lua_Debug *ar) {
+	if (ar->event != LUA_HOOKCOUNT) {
+		if (scriptHook)
+			scriptHook(L, ar);
+		return;
+	}
+	if (scriptHook && (scriptHookMask & LUA_MASKCOUNT)) {
+		sinceScriptHook += lua_gethookcount(L);
+		if (sinceScriptHook >= scriptHookCount) {
+			sinceScriptHook = 0;
+			scriptHook(L, ar);
+		}
+	}
+	if (profileCurrent && (profileSampleInterval > 0)) {
+		sinceSample += lua_gethookcount(L);
+		if (sinceSample >= profileSampleInterval) {
+			sinceSample = 0;
+			SampleStack(L);
+		}
+	}
+	if ((budgetDeadline > 0.0) && (HandlerTime() > budgetDeadline)) {
+		// Fail on every instruction from now on so a handler catching the error with pcall still stops
+		if (!budgetExceeded) {
+			budgetExceeded = true;
+			lua_sethook(L, instruction_hook, lua_gethookmask(L), 1);
+		}
+		char message[200];
+		sprintf(message, "%.100s handler stopped after exceeding its budget of %d ms",
+			budgetEvent, static_cast<int>(budgetSeconds * 1000.0 + 0.5));
+		luaL_where(L, 0);
+		lua_pushstring(L, message);
+		lua_concat(L, 2);
+		if (!tracebackEnabled) {
+			// Otherwise call_function adds the traceback
+			lua_getfield(L, LUA_REGISTRYINDEX, "SciTE_Traceback");
+			if (lua_isfunction(L, -1)) {
+				lua_insert(L, -2);
+				lua_call(L, 1, 1);
+			} else {
+				lua_pop(L, 1);
+			}
+		}
+		lua_error(L);
+	}
+}
+
+// Install the count hook while a handler is being sampled or limited, putting aside any
+// hook of the script, and put the script's hook back when neither is needed.
+static void SetInstructionHook(lua_State *L) {
+	const bool sampling = profileCurrent && (profileSampleInterval > 0);
+	int count = 0;
+	if (budgetDeadline > 0.0) {
+		count = budgetCheckInterval;
+		if (sampling && (profileSampleInterval < count))
+			count = profileSampleInterval;
+	} else if (sampling) {
+		count = profileSampleInterval;
+	}
+	const bool installed = lua_gethook(L) == instruction_hook;
+	if (count > 0) {
+		if (!installed) {
+			scriptHook = lua_gethook(L);
+			scriptHookMask = scriptHook ? lua_gethookmask(L) : 0;
+			scriptHookCount = lua_gethookcount(L);
+			sinceScriptHook = 0;
+		}
+		if (scriptHookMask & LUA_MASKCOUNT) {
+			if (scriptHookCount < count)
+				count = scriptHookCount;
+		}
+		lua_sethook(L, instruction_hook, scriptHookMask | LUA_MASKCOUNT, count);
+	} else if (installed) {
+		lua_sethook(L, scriptHook, scriptHookMask, scriptHookCount);
+		scriptHook = NULL;
+		scriptHookMask = 0;
+		scriptHookCount = 0;
+	}
+}
+
+// Times the function at index function of L, handling the event or command label, for
+// the lifetime of this object when profiling. Functions are told apart by where they are
+// defined so that each handler of an event is timed separately. Nested scopes are timed
+// separately, each including the time of those inside it.
+class ProfileScope {
+	HandlerProfile *outer;
+	HandlerProfile *profile;
+	double start;
+	// Private so ProfileScope objects can not be copied
+	ProfileScope(const ProfileScope &);
+	ProfileScope &operator=(const ProfileScope &);
+public:
+	ProfileScope(lua_State *L, int function, const char *label) : outer(profileCurrent), profile(0), start(0.0) {
+		if (profileEnabled && luaState) {
+			lua_Debug ar;
+			lua_pushvalue(L, function);
+			lua_getinfo(L, ">S", &ar);
+			char where[LUA_IDSIZE + 20];
+			if (ar.linedefined > 0)
+				sprintf(where, "%s:%d", ar.short_src, ar.linedefined);
+			else
+				sprintf(where, "%s %s", ar.short_src, label);
+			profile = &profiles[where];
+			profile->events.insert(label);
+			profileCurrent = profile;
+			if (!outer && (profileSampleInterval > 0)) {
+				sinceSample = 0;
+				SetInstructionHook(luaState);
+			}
+			start = HandlerTime();
+		}
+	}
+	~ProfileScope() {
+		if (profile) {
+			profile->Add(HandlerTime() - start);
+			profileCurrent = outer;
+			if (!outer && luaState)
+				SetInstructionHook(luaState);
+		}
+	}
+};
+
+static bool ProfileLonger(const std::pair<std::string, const HandlerProfile *> &a,
+	const std::pair<std::string, const HandlerProfile *> &b) {
+	return a.second->total > b.second->total;
+}
+
+static bool SampleMore(const std::pair<std::string, int> &a, const std::pair<std::string, int> &b) {
+	return a.second > b.second;
+}
+
+// Write the profile to the output pane, slowest handlers first
+static void TraceProfile() {
+	std::vector<std::pair<std::string, const HandlerProfile *> > sorted;
+	for (std::map<std::string, HandlerProfile>::const_iterator it = profiles.begin(); it != profiles.end(); ++it) {
+		if (it->second.calls)
+			sorted.push_back(std::pair<std::string, const HandlerProfile *>(it->first, &it->second));
+	}
+	std::sort(sorted.begin(), sorted.end(), ProfileLonger);
+	host->Trace("> Lua profile: calls, total, mean, p99 and max in milliseconds\n");
+	for (size_t i = 0; i < sorted.size(); i++) {
+		const HandlerProfile &hp = *sorted[i].second;
+		char line[300];
+		sprintf(line, "%-24s %8d %10.3f %8.3f %8.3f %8.3f  ", sorted[i].first.c_str(), hp.calls,
+			hp.total * 1000.0, hp.total * 1000.0 / hp.calls, hp.Percentile(0.99) * 1000.0, hp.longest * 1000.0);
+		host->Trace(line);
+		host->Trace(hp.Events().c_str());
+		host->Trace("\n");
+		std::vector<std::pair<std::string, int> > samples(hp.stacks.begin(), hp.stacks.end());
+		std::sort(samples.begin(), samples.end(), SampleMore);
+		for (size_t s = 0; s < samples.size() && s < 10; s++) {
+			sprintf(line, "  %8d  ", samples[s].second);
+			host->Trace(line);
+			host->Trace(samples[s].first.c_str());
+			host->Trace("\n");
+		}
+	}
+}
+
+// scite.Profile() returns a table of handler timings, scite.Profile("trace") also
+// writes them to the output pane and scite.Profile("reset") discards them.
+static int cf_scite_profile(lua_State *L) {
+	const char *action = luaL_optstring(L, 1, "");
+	if (0 == strcmp(action, "reset")) {
+		// Entries are reset rather than erased as running handlers point to them
+		for (std::map<std::string, HandlerProfile>::iterator it = profiles.begin(); it != profiles.end(); ++it)
+			it->second = HandlerProfile();
+		return 0;
+	} else if (0 == strcmp(action, "trace")) {
+		TraceProfile();
+	} else if (*action) {
+		raise_error(L, "Profile action must be \"trace\" or \"reset\"");
+		return 0;
+	}
+	lua_newtable(L);
+	for (std::map<std::string, HandlerProfile>::const_iterator it = profiles.begin(); it != profiles.end(); ++it) {
+		const HandlerProfile &hp = it->second;
+		if (!hp.calls)
+			continue;
+		lua_newtable(L);
+		lua_pushinteger(L, hp.calls);
+		lua_setfield(L, -2, "calls");
+		lua_pushnumber(L, hp.total);
+		lua_setfield(L, -2, "total");
+		lua_pushnumber(L, hp.Percentile(0.99));
+		lua_setfield(L, -2, "p99");
+		lua_pushnumber(L, hp.longest);
+		lua_setfield(L, -2, "max");
+		lua_pushstring(L, hp.Events().c_str());
+		lua_setfield(L, -2, "events");
+		lua_newtable(L);
+		for (std::map<std::string, int>::const_iterator st = hp.stacks.begin(); st != hp.stacks.end(); ++st) {
+			lua_pushinteger(L, st->second);
+			lua_setfield(L, -2, st->first.c_str());
+		}
+		lua_setfield(L, -2, "stacks");
+		lua_setfield(L, -2, it->first.c_str());
+	}
+	return 1;
+}
+
+// Call the function below the nargs arguments as a handler for an event, stopping it
+// if it runs for longer than the budget.  A handler stopped budgetTrips times is not
+// called again until its script is loaded again, making a new function.
+static bool call_handler(lua_State *L, int nargs, const char *event) {
+	if (budgetSeconds <= 0.0)
+		return call_function(L, nargs);
+
+	// Trips are counted in a table with weak keys so handlers of old scripts are collected
+	int trips = lua_gettop(L) - nargs;
+	lua_getfield(L, LUA_REGISTRYINDEX, "SciTE_BudgetTrips");
+	if (!lua_istable(L, -1)) {
+		lua_pop(L, 1);
+		lua_newtable(L);
+		lua_newtable(L);
+		lua_pushliteral(L, "k");
+		lua_setfield(L, -2, "__mode");
+		lua_setmetatable(L, -2);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, LUA_REGISTRYINDEX, "SciTE_BudgetTrips");
+	}
+	lua_insert(L, trips);
+	const int function = trips + 1;
+	lua_pushvalue(L, function);
+	lua_rawget(L, trips);
+	int tripCount = static_cast<int>(lua_tointeger(L, -1));
+	lua_pop(L, 1);
+	if ((budgetTrips > 0) && (tripCount >= budgetTrips)) {
+		lua_settop(L, trips - 1);
+		return false;
+	}
+	// Keep a reference to the function to count trips after the call
+	lua_pushvalue(L, function);
+	lua_insert(L, function);
+
+	const double outerDeadline = budgetDeadline;
+	const bool outerExceeded = budgetExceeded;
+	const char *outerEvent = budgetEvent;
+	budgetDeadline = HandlerTime() + budgetSeconds;
+	budgetExceeded = false;
+	budgetEvent = event;
+	SetInstructionHook(L);
+	bool handled = call_function(L, nargs);
+	const bool exceeded = budgetExceeded;
+	budgetDeadline = outerDeadline;
+	budgetExceeded = outerExceeded;
+	budgetEvent = outerEvent;
+	SetInstructionHook(L);
+
+	if (exceeded) {
+		tripCount++;
+		lua_pushvalue(L, function);
+		lua_pushinteger(L, tripCount);
+		lua_rawset(L, trips);
+		if ((budgetTrips > 0) && (tripCount >= budgetTrips)) {
+			char message[200];
+			sprintf(message, "> Lua: %.100s handler disabled after exceeding its budget %d times\n",
+				event, tripCount);
+			host->Trace(message);
+		}
+	}
+	lua_settop(L, trips - 1);
+	return handled;
+}
+
+// Push the functions handling an event, returning how many were pushed.  The global
+// function with the event's name comes first, followed by any added with scite.AddHandler.
+// The global is read with rawget so that events nobody handles cost no more than a table
+// lookup and a script reassigning or removing a handler is always seen on the next event.
+static int PushHandlers(lua_State *L, const char *name) {
+	int handlers = 0;
+	lua_pushstring(L, name);
+	lua_rawget(L, LUA_GLOBALSINDEX);
+	if (lua_isfunction(L, -1)) {
+		handlers++;
+	} else {
+		lua_pop(L, 1);
+	}
+	if (handlersAdded) {
+		lua_getfield(L, LUA_REGISTRYINDEX, "SciTE_Handlers");
+		int lists = lua_gettop(L);
+		if (lua_istable(L, lists)) {
+			lua_getfield(L, lists, name);
+			if (lua_istable(L, -1)) {
+				int list = lua_gettop(L);
+				int n = static_cast<int>(lua_objlen(L, list));
+				// Copy the functions onto the stack so handlers may add or remove handlers
+				lua_checkstack(L, n + LUA_MINSTACK);
+				for (int i = 1; i <= n; i++) {
+					lua_rawgeti(L, list, i);
+					if (lua_isfunction(L, -1))
+						handlers++;
+					else
+						lua_pop(L, 1);
+				}
+				lua_remove(L, list);
+			} else {
+				lua_pop(L, 1);
+			}
+		}
+		lua_remove(L, lists);
+	}
+	return handlers;
+}
+
+// Call the handlers pushed by PushHandlers with the nargs arguments above them
+// until one returns true.
+static bool CallHandlers(lua_State *L, const char *event, int handlers, int nargs) {
+	bool handled = false;
+	int first = lua_gettop(L) - nargs - handlers + 1;
+	int args = first + handlers;
+	for (int h = 0; h < handlers && !handled; h++) {
+		ProfileScope scope(L, first + h, event);
+		lua_pushvalue(L, first + h);
+		for (int a = 0; a < nargs; a++)
+			lua_pushvalue(L, args + a);
+		handled = call_handler(L, nargs, event);
+	}
+	lua_settop(L, first - 1);
+	return handled;
+}
+
 static bool CallNamedFunction(const char *name) {
 	bool handled = false;
 	if (luaState) {
-		lua_getglobal(luaState, name);
-		if (lua_isfunction(luaState, -1)) {
-			handled = call_function(luaState, 0);
-		} else {
-			lua_pop(luaState, 1);
+		int handlers = PushHandlers(luaState, name);
+		if (handlers) {
+			handled = CallHandlers(luaState, name, handlers, 0);
 		}
 	}
 	return handled;
@@ -823,12 +1324,10 @@ static bool CallNamedFunction(const char *name) {
 static bool CallNamedFunction(const char *name, const char *arg) {
 	bool handled = false;
 	if (luaState) {
-		lua_getglobal(luaState, name);
-		if (lua_isfunction(luaState, -1)) {
+		int handlers = PushHandlers(luaState, name);
+		if (handlers) {
 			lua_pushstring(luaState, arg);
-			handled = call_function(luaState, 1);
-		} else {
-			lua_pop(luaState, 1);
+			handled = CallHandlers(luaState, name, handlers, 1);
 		}
 	}
 	return handled;
@@ -837,13 +1336,11 @@ static bool CallNamedFunction(const char *name, const char *arg) {
 static bool CallNamedFunction(const char *name, int numberArg, const char *stringArg) {
 	bool handled = false;
 	if (luaState) {
-		lua_getglobal(luaState, name);
-		if (lua_isfunction(luaState, -1)) {
+		int handlers = PushHandlers(luaState, name);
+		if (handlers) {
 			lua_pushnumber(luaState, numberArg);
 			lua_pushstring(luaState, stringArg);
-			handled = call_function(luaState, 2);
-		} else {
-			lua_pop(luaState, 1);
+			handled = CallHandlers(luaState, name, handlers, 2);
 		}
 	}
 	return handled;
@@ -852,21 +1349,17 @@ static bool CallNamedFunction(const char *name, int numberArg, const char *strin
 static bool CallNamedFunction(const char *name, int numberArg, int numberArg2) {
 	bool handled = false;
 	if (luaState) {
-		lua_getglobal(luaState, name);
-		if (lua_isfunction(luaState, -1)) {
+		int handlers = PushHandlers(luaState, name);
+		if (handlers) {
 			lua_pushnumber(luaState, numberArg);
 			lua_pushnumber(luaState, numberArg2);
-			handled = call_function(luaState, 2);
-		} else {
-			lua_pop(luaState, 1);
+			handled = CallHandlers(luaState, name, handlers, 2);
 		}
 	}
 	return handled;
 }
 
-static int iface_function_helper(lua_State *L, const IFaceFunction &func) {
-	ExtensionAPI::Pane p = check_pane_object(L, 1);
-
+static int iface_function_helper(lua_State *L, ExtensionAPI::Pane p, const IFaceFunction &func) {
 	int arg = 2;
 
 	sptr_t params[2] = {0,0};
@@ -954,6 +1447,10 @@ static int iface_function_helper(lua_State *L, const IFaceFunction &func) {
 	return resultCount;
 }
 
+static int iface_function_helper(lua_State *L, const IFaceFunction &func) {
+	return iface_function_helper(L, check_pane_object(L, 1), func);
+}
+
 struct IFacePropertyBinding {
 	ExtensionAPI::Pane pane;
 	const IFaceProperty *prop;
@@ -971,13 +1468,11 @@ static int cf_ifaceprop_metatable_index(lua_State *L) {
 		raise_error(L, "Attempt to read a write-only indexed property");
 		return 0;
 	}
-	IFaceFunction func = ipb->prop->GetterFunction();
+	check_pane_accessible(L, ipb->pane);
 
-	// rewrite the stack to match what the function expects.  put pane at index 1; param is already at index 2.
-	push_pane_object(L, ipb->pane);
-	lua_replace(L, 1);
+	// the param is already at index 2 where the function expects it
 	lua_settop(L, 2);
-	return iface_function_helper(L, func);
+	return iface_function_helper(L, ipb->pane, ipb->prop->GetterFunction());
 }
 
 static int cf_ifaceprop_metatable_newindex(lua_State *L) {
@@ -990,14 +1485,11 @@ static int cf_ifaceprop_metatable_newindex(lua_State *L) {
 		raise_error(L, "Attempt to write a read-only indexed property");
 		return 0;
 	}
-	IFaceFunction func = ipb->prop->SetterFunction();
+	check_pane_accessible(L, ipb->pane);
 
-	// rewrite the stack to match what the function expects.
-	// pane at index 1; param at index 2, value at index 3
-	push_pane_object(L, ipb->pane);
-	lua_replace(L, 1);
+	// param at index 2, value at index 3 as the function expects
 	lua_settop(L, 3);
-	return iface_function_helper(L, func);
+	return iface_function_helper(L, ipb->pane, ipb->prop->SetterFunction());
 }
 
 static int cf_pane_iface_function(lua_State *L) {
@@ -1011,54 +1503,34 @@ static int cf_pane_iface_function(lua_State *L) {
 	}
 }
 
-static int push_iface_function(lua_State *L, const char *name) {
+static bool push_iface_function(lua_State *L, const char *name) {
 	int i = IFaceTable::FindFunction(name);
 	if (i >= 0) {
 		if (IFaceFunctionIsScriptable(IFaceTable::functions[i])) {
 			lua_pushlightuserdata(L, const_cast<IFaceFunction *>(IFaceTable::functions+i));
 			lua_pushcclosure(L, cf_pane_iface_function, 1);
-
-			// Since Lua experts say it is inefficient to create closures / cfunctions
-			// in an inner loop, I tried caching the closures in the metatable, and looking
-			// for them there first.  However, it made very little difference and did not
-			// seem worth the added complexity. - WBD
-
-			return 1;
+			return true;
 		}
 	}
-	return -1; // signal to try next pane index handler
+	return false; // signal to try next pane index handler
 }
 
-static int push_iface_propval(lua_State *L, const char *name) {
-	// this function doesn't raise errors, but returns 0 if the function is not handled.
+static bool push_iface_property(lua_State *L, const char *name) {
+	// Properties read by a getter push their IFaceProperty as a light userdata so
+	// that their values can be read by push_iface_propval on each access.
 
 	int propidx = IFaceTable::FindProperty(name);
 	if (propidx >= 0) {
 		const IFaceProperty &prop = IFaceTable::properties[propidx];
 		if (!IFacePropertyIsScriptable(prop)) {
 			raise_error(L, "Error: iface property is not scriptable.");
-			return -1;
+			return false;
 		}
 
-		if (prop.paramType == iface_void) {
-			if (prop.getter) {
-				lua_settop(L, 1);
-				return iface_function_helper(L, prop.GetterFunction());
-			}
-		} else if (prop.paramType == iface_bool) {
-			// The bool getter is untested since there are none in the iface.
-			// However, the following is suggested as a reference protocol.
-			ExtensionAPI::Pane p = check_pane_object(L, 1);
-
+		if ((prop.paramType == iface_void) || (prop.paramType == iface_bool)) {
 			if (prop.getter) {
-				if (host->Send(p, prop.getter, 1, 0)) {
-					lua_pushnil(L);
-					return 1;
-				} else {
-					lua_settop(L, 1);
-					lua_pushboolean(L, 0);
-					return iface_function_helper(L, prop.GetterFunction());
-				}
+				lua_pushlightuserdata(L, const_cast<IFaceProperty *>(&prop));
+				return true;
 			}
 		} else {
 			// Indexed property.  These return an object with the following behavior:
@@ -1080,37 +1552,76 @@ static int push_iface_propval(lua_State *L, const char *name) {
 					lua_settable(L, -3);
 				}
 				lua_setmetatable(L, -2);
-				return 1;
+				return true;
 			} else {
 				raise_error(L, "Internal error: failed to allocate userdata for indexed property");
-				return -1;
+				return false;
 			}
 		}
 	}
 
-	return -1; // signal to try next pane index handler
+	return false; // signal to try next pane index handler
 }
 
-static int cf_pane_metatable_index(lua_State *L) {
-	if (lua_isstring(L, 2)) {
-		const char *name = lua_tostring(L, 2);
+static int push_iface_propval(lua_State *L, const IFaceProperty &prop) {
+	if (prop.paramType == iface_bool) {
+		// The bool getter is untested since there are none in the iface.
+		// However, the following is suggested as a reference protocol.
+		ExtensionAPI::Pane p = check_pane_object(L, 1);
 
-		// these return the number of values pushed (possibly 0), or -1 if no match
-		int results = push_iface_function(L, name);
-		if (results < 0)
-			results = push_iface_propval(L, name);
+		if (host->Send(p, prop.getter, 1, 0)) {
+			lua_pushnil(L);
+			return 1;
+		} else {
+			lua_settop(L, 1);
+			lua_pushboolean(L, 0);
+			return iface_function_helper(L, p, prop.GetterFunction());
+		}
+	}
+	lua_settop(L, 1);
+	return iface_function_helper(L, prop.GetterFunction());
+}
 
-		if (results >= 0) {
-			return results;
-		} else if (name[0] != '_') {
-			lua_getmetatable(L, 1);
-			if (lua_istable(L, -1)) {
+static int cf_pane_metatable_index(lua_State *L) {
+	// What each name refers to is kept in a table for each pane, held in the
+	// table that is the upvalue, so that the iface tables are only searched once
+	// and each indexed property object is only made once.
+	ExtensionAPI::Pane *pPane = reinterpret_cast<ExtensionAPI::Pane *>(checkudata(L, 1, "SciTE_MT_Pane"));
+	if (pPane && lua_isstring(L, 2)) {
+		lua_settop(L, 2);
+		lua_rawgeti(L, lua_upvalueindex(1), *pPane);
+		if (!lua_istable(L, 3)) {
+			lua_pop(L, 1);
+			lua_newtable(L);
+			lua_pushvalue(L, 3);
+			lua_rawseti(L, lua_upvalueindex(1), *pPane);
+		}
+		lua_pushvalue(L, 2);
+		lua_rawget(L, 3);
+
+		if (lua_isnil(L, 4)) {
+			lua_pop(L, 1);
+			const char *name = lua_tostring(L, 2);
+			if (!push_iface_function(L, name) && !push_iface_property(L, name)) {
+				if (name[0] == '_')
+					raise_error(L, "Pane function / readable property / indexed writable property name expected");
+				lua_getmetatable(L, 1);
 				lua_pushvalue(L, 2);
-				lua_gettable(L, -2);
-				if (!lua_isnil(L, -1))
-					return 1;
+				lua_rawget(L, -2);
+				lua_remove(L, -2);
+				if (lua_isnil(L, -1))
+					raise_error(L, "Pane function / readable property / indexed writable property name expected");
 			}
+			lua_pushvalue(L, 2);
+			lua_pushvalue(L, -2);
+			lua_rawset(L, 3);
 		}
+
+		if (lua_islightuserdata(L, -1)) {
+			const IFaceProperty *prop = reinterpret_cast<const IFaceProperty *>(lua_touserdata(L, -1));
+			return push_iface_propval(L, *prop);
+		}
+		return 1;
 	}
 
 	raise_error(L, "Pane function / readable property / indexed writable property name expected");
@@ -1158,7 +1669,8 @@ static int cf_pane_metatable_newindex(lua_State *L) {
 void push_pane_object(lua_State *L, ExtensionAPI::Pane p) {
 	*reinterpret_cast<ExtensionAPI::Pane *>(lua_newuserdata(L, sizeof(p))) = p;
 	if (luaL_newmetatable(L, "SciTE_MT_Pane")) {
-		lua_pushcfunction(L, cf_pane_metatable_index);
+		lua_newtable(L);
+		lua_pushcclosure(L, cf_pane_metatable_index, 1);
 		lua_setfield(L, -2, "__index");
 		lua_pushcfunction(L, cf_pane_metatable_newindex);
 		lua_setfield(L, -2, "__newindex");
@@ -1201,9 +1713,8 @@ static int cf_global_metatable_index(lua_State *L) {
 			if (i >= 0) {
 				lua_pushnumber(L, IFaceTable::functions[i].value);
 
-				// FindFunctionByConstantName is slow, so cache the result into the
-				// global table.  My tests show this gives an order of magnitude
-				// improvement.
+				// Cache the result into the global table so later accesses
+				// do not need to reach this metamethod.
 				lua_pushvalue(L, 2);
 				lua_pushvalue(L, -2);
 				lua_rawset(L, 1);
@@ -1277,7 +1788,847 @@ void PublishGlobalBufferData() {
 	lua_rawset(luaState, LUA_GLOBALSINDEX);
 }
 
+// Compiled scripts are cached as Lua bytecode in ext.lua.cache.directory so that
+// scripts run again after a reset or at the next startup skip the parser.
+
+static std::string luaCacheDirectory;
+
+static const char luaCacheMagic[8] = { 'S', 'c', 'i', 'T', 'E', 'L', 'u', 'a' };
+// Increment when the layout changes
+static const unsigned int luaCacheVersion = 1;
+
+/**
+ * The file starts with this header followed by the signature describing the
+ * script and then the bytecode written by lua_dump.
+ */
+struct LuaCacheHeader {
+	char magic[8];
+	unsigned int version;
+	unsigned int signatureLength;
+};
+
+// FNV-1a
+static unsigned int HashBytes(const char *s, size_t len) {
+	unsigned int hash = 2166136261u;
+	for (size_t i = 0; i < len; i++) {
+		hash ^= static_cast<unsigned char>(s[i]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static bool ReadWholeFile(const FilePath &path, std::string &data) {
+	FILE *fp = path.Open(fileRead);
+	if (!fp)
+		return false;
+	char block[8192];
+	size_t lenBlock;
+	while ((lenBlock = fread(block, 1, sizeof(block), fp)) > 0)
+		data.append(block, lenBlock);
+	fclose(fp);
+	return true;
+}
+
+static std::string LuaCacheFileName(const char *filename) {
+	char name[100];
+	sprintf(name, "SciTE-%08x.luac", HashBytes(filename, strlen(filename)));
+	FilePath cacheFile(GUI::StringFromUTF8(luaCacheDirectory.c_str()), GUI::StringFromUTF8(name));
+	return cacheFile.AsUTF8();
+}
+
+/// Describe the script by size, a hash of its contents and name so a changed script is
+/// compiled again, even when changed twice within the resolution of modification times.
+static std::string LuaCacheSignature(const char *filename) {
+	std::string source;
+	if (!ReadWholeFile(FilePath(GUI::StringFromUTF8(filename)), source))
+		return std::string();
+	char stamp[100];
+	sprintf(stamp, "%lu %08x ", static_cast<unsigned long>(source.length()),
+		HashBytes(source.c_str(), source.length()));
+	return stamp + std::string(filename);
+}
+
+static int bytecode_writer(lua_State *, const void *p, size_t sz, void *ud) {
+	static_cast<std::string *>(ud)->append(static_cast<const char *>(p), sz);
+	return 0;
+}
+
+// Write the function at the top of the stack to the cache, under a temporary
+// name then renamed so that other instances never see a partial file.
+static void SaveBytecode(lua_State *L, const std::string &cacheFileName, const std::string &signature) {
+	std::string bytecode;
+	if ((lua_dump(L, bytecode_writer, &bytecode) != 0) || bytecode.empty())
+		return;
+	LuaCacheHeader header;
+	memcpy(header.magic, luaCacheMagic, sizeof(luaCacheMagic));
+	header.version = luaCacheVersion;
+	header.signatureLength = static_cast<unsigned int>(signature.length());
+	FilePath cacheFile(GUI::StringFromUTF8(cacheFileName.c_str()));
+	FilePath tempFile(GUI::StringFromUTF8((cacheFileName + ".new").c_str()));
+	FILE *fp = tempFile.Open(GUI_TEXT("wb"));
+	if (!fp)
+		return;
+	bool ok = (fwrite(&header, sizeof(header), 1, fp) == 1) &&
+		(fwrite(signature.c_str(), 1, signature.length(), fp) == signature.length()) &&
+		(fwrite(bytecode.c_str(), 1, bytecode.length(), fp) == bytecode.length());
+	if (fclose(fp) != 0)
+		ok = false;
+	if (ok) {
+		cacheFile.Remove();
+		ok = tempFile.Rename(cacheFile);
+	}
+	if (!ok)
+		tempFile.Remove();
+}
+
+// Load the cached bytecode of a script if it was compiled from the same version of
+// the script, returning 0 with the function on the stack like luaL_loadfile.
+static int LoadBytecode(lua_State *L, const std::string &cacheFileName, const std::string &signature, const char *filename) {
+	std::string data;
+	if (!ReadWholeFile(FilePath(GUI::StringFromUTF8(cacheFileName.c_str())), data))
+		return LUA_ERRFILE;
+	LuaCacheHeader header;
+	if (data.size() < sizeof(header))
+		return LUA_ERRFILE;
+	memcpy(&header, &data[0], sizeof(header));
+	const size_t codeStart = sizeof(header) + header.signatureLength;
+	if ((memcmp(header.magic, luaCacheMagic, sizeof(luaCacheMagic)) != 0) ||
+		(header.version != luaCacheVersion) ||
+		(header.signatureLength != signature.length()) ||
+		(data.size() <= codeStart) ||
+		(memcmp(&data[sizeof(header)], signature.c_str(), signature.length()) != 0) ||
+		(data[codeStart] != LUA_SIGNATURE[0])) {
+		return LUA_ERRFILE;
+	}
+	// The chunk name is only used when the bytecode is damaged as it holds its source name.
+	// lundump rejects bytecode from a build with different number formats or byte order.
+	std::string chunkName = std::string("@") + filename;
+	int result = luaL_loadbuffer(L, &data[codeStart], data.size() - codeStart, chunkName.c_str());
+	if (result != 0)
+		lua_pop(L, 1);
+	return result;
+}
+
+// luaL_loadfile through the bytecode cache when ext.lua.cache.directory is set
+static int load_file_cached(lua_State *L, const char *filename) {
+	if (luaCacheDirectory.empty())
+		return luaL_loadfile(L, filename);
+	const std::string cacheFileName = LuaCacheFileName(filename);
+	const std::string signature = LuaCacheSignature(filename);
+	if (signature.empty())
+		return luaL_loadfile(L, filename);
+	if (LoadBytecode(L, cacheFileName, signature, filename) == 0)
+		return 0;
+	int result = luaL_loadfile(L, filename);
+	if (result == 0)
+		SaveBytecode(L, cacheFileName, signature);
+	return result;
+}
+
+// Searcher added to package.loaders before Lua's own so modules loaded by require
+// also use the bytecode cache.  Finds the file along package.path as Lua does.
+static int cf_cached_loader(lua_State *L) {
+	const char *name = luaL_checkstring(L, 1);
+	if (luaCacheDirectory.empty())
+		return 0;	// Lua's loader will find it
+	lua_getglobal(L, "package");
+	if (!lua_istable(L, -1))
+		return 0;
+	lua_getfield(L, -1, "path");
+	const char *path = lua_tostring(L, -1);
+	if (!path)
+		return 0;
+	name = luaL_gsub(L, name, ".", LUA_DIRSEP);
+	while (*path) {
+		while (*path == *LUA_PATHSEP)
+			path++;
+		if (!*path)
+			break;
+		const char *end = strchr(path, *LUA_PATHSEP);
+		if (!end)
+			end = path + strlen(path);
+		lua_pushlstring(L, path, end - path);
+		const char *filename = luaL_gsub(L, lua_tostring(L, -1), LUA_PATH_MARK, name);
+		if (FilePath(GUI::StringFromUTF8(filename)).Exists()) {
+			if (load_file_cached(L, filename) != 0) {
+				luaL_error(L, "error loading module " LUA_QS " from file " LUA_QS ":\n\t%s",
+					lua_tostring(L, 1), filename, lua_tostring(L, -1));
+			}
+			return 1;
+		}
+		lua_pop(L, 2);
+		path = end;
+	}
+	return 0;
+}
+
+// Background Lua states started by scite.Spawn.  Each job runs in a new lua_State on a
+// thread from a small pool and only exchanges copies of values with the main state,
+// so no lua_State is ever used by two threads.
+
+enum { maxCopyDepth=64 };
+
+// Values are copied between states as bytes: nil, booleans, numbers, strings
+// and tables of those.  Returns false for other types or deeply nested tables.
+static bool EncodeValue(lua_State *L, int index, std::string &out, int depth) {
+	index = absolute_index(L, index);
+	switch (lua_type(L, index)) {
+	case LUA_TNIL:
+		out += 'n';
+		return true;
+	case LUA_TBOOLEAN:
+		out += lua_toboolean(L, index) ? 't' : 'f';
+		return true;
+	case LUA_TNUMBER: {
+			lua_Number number = lua_tonumber(L, index);
+			out += 'd';
+			out.append(reinterpret_cast<const char *>(&number), sizeof(number));
+			return true;
+		}
+	case LUA_TSTRING: {
+			size_t len = 0;
+			const char *s = lua_tolstring(L, index, &len);
+			out += 's';
+			out.append(reinterpret_cast<const char *>(&len), sizeof(len));
+			out.append(s, len);
+			return true;
+		}
+	case LUA_TTABLE:
+		if ((depth >= maxCopyDepth) || !lua_checkstack(L, 3))
+			return false;
+		out += '{';
+		lua_pushnil(L);
+		while (lua_next(L, index) != 0) {
+			if (!EncodeValue(L, -2, out, depth + 1) || !EncodeValue(L, -1, out, depth + 1)) {
+				lua_pop(L, 2);
+				return false;
+			}
+			lua_pop(L, 1);
+		}
+		out += '}';
+		return true;
+	}
+	return false;
+}
+
+// Push the value encoded at p, returning the position after it
+static const char *DecodeValue(lua_State *L, const char *p, const char *end) {
+	if ((p >= end) || !lua_checkstack(L, 3)) {
+		lua_pushnil(L);
+		return end;
+	}
+	switch (*p++) {
+	case 't':
+		lua_pushboolean(L, 1);
+		return p;
+	case 'f':
+		lua_pushboolean(L, 0);
+		return p;
+	case 'd': {
+			lua_Number number = 0;
+			memcpy(&number, p, sizeof(number));
+			lua_pushnumber(L, number);
+			return p + sizeof(number);
+		}
+	case 's': {
+			size_t len = 0;
+			memcpy(&len, p, sizeof(len));
+			p += sizeof(len);
+			lua_pushlstring(L, p, len);
+			return p + len;
+		}
+	case '{':
+		lua_newtable(L);
+		while ((p < end) && (*p != '}')) {
+			p = DecodeValue(L, p, end);
+			p = DecodeValue(L, p, end);
+			if (lua_isnil(L, -2))
+				lua_pop(L, 2);
+			else
+				lua_rawset(L, -3);
+		}
+		return p + 1;
+	}
+	lua_pushnil(L);
+	return p;
+}
+
+// Encode the values from first to last on the stack, preceded by their count
+static bool EncodeValues(lua_State *L, int first, int last, std::string &out) {
+	const int count = (last >= first) ? (last - first + 1) : 0;
+	out.append(reinterpret_cast<const char *>(&count), sizeof(count));
+	for (int i = first; i <= last; i++) {
+		if (!EncodeValue(L, i, out, 0))
+			return false;
+	}
+	return true;
+}
+
+// Push the values encoded by EncodeValues, returning how many were pushed
+static int DecodeValues(lua_State *L, const std::string &in) {
+	int count = 0;
+	if (in.length() < sizeof(count))
+		return 0;
+	memcpy(&count, in.data(), sizeof(count));
+	if (!lua_checkstack(L, count + LUA_MINSTACK))
+		return 0;
+	const char *p = in.data() + sizeof(count);
+	const char *end = in.data() + in.length();
+	for (int i = 0; i < count; i++)
+		p = DecodeValue(L, p, end);
+	return count;
+}
+
+class LuaJobPool;
+
+struct LuaJob : public Worker {
+	enum State { queued, running, finished };
+	struct Message {
+		char kind;	// 'm' posted values, 'p' printed text, 'r' results, 'e' error, 'c' cancelled
+		std::string values;
+		Message(char kind_, const std::string &values_) : kind(kind_), values(values_) {
+		}
+	};
+	LuaJobPool *pool;
+	int id;
+	std::string source;
+	std::string args;
+	// Guarded by the pool's mutex
+	State state;
+	std::vector<Message> messages;	// Not yet taken by the main thread
+	bool posted;	// Main thread has been asked to take the messages
+	LuaJob(LuaJobPool *pool_, int id_, const std::string &source_, const std::string &args_) :
+		pool(pool_), id(id_), source(source_), args(args_), state(queued), posted(false) {
+	}
+};
+
+// Runs jobs on up to maxThreads threads, each thread taking jobs until none are waiting.
+class LuaJobPool {
+	ExtensionAPI *pHost;
+	Mutex *mutex;
+	std::vector<LuaJob *> waiting;
+	std::vector<Worker *> threads;
+	int running;
+	int maxThreads;
+	bool stopping;	// The host is going away so must not be posted to
+	std::map<int, LuaJob *> jobs;	// Started and not yet finished on the main thread
+public:
+	LuaJobPool(ExtensionAPI *pHost_) : pHost(pHost_), mutex(Mutex::Create()), running(0), maxThreads(2), stopping(false) {
+	}
+	~LuaJobPool();
+	bool Stop();
+	void SetMaxThreads(int maxThreads_) {
+		maxThreads = (maxThreads_ > 0) ? maxThreads_ : 1;
+	}
+	void Start(LuaJob *job);
+	void Cancel(LuaJob *job);
+	LuaJob::State StateOf(LuaJob *job);
+	LuaJob *Find(int id) const;
+	LuaJob *Find(const Worker *pWorker) const;
+	bool Take(LuaJob *job, std::vector<LuaJob::Message> &messages);
+	void Finished(LuaJob *job);
+	void Post(LuaJob *job, char kind, const std::string &values, bool final=false);
+	void RunWaiting();
+};
+
+static LuaJobPool *jobPool = 0;
+
+struct LuaPoolThread : public Worker {
+	LuaJobPool *pool;
+	explicit LuaPoolThread(LuaJobPool *pool_) : pool(pool_) {
+	}
+	virtual void Execute() {
+		pool->RunWaiting();
+		completed = true;
+	}
+};
+
+static void WaitBriefly() {
+#ifdef __unix__
+	usleep(1000);
+#else
+	::Sleep(1);
+#endif
+}
+
+/**
+ * Cancel every job and wait a short time for the threads to finish. Returns false
+ * when a thread is still running, perhaps blocked inside a library call such as
+ * io.read, in which case the pool is still in use and must not be deleted.
+ */
+bool LuaJobPool::Stop() {
+	{
+		Lock lock(mutex);
+		stopping = true;
+		waiting.clear();
+		for (std::map<int, LuaJob *>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+			it->second->cancelling = true;
+	}
+	const double stopSeconds = 2.0;
+	GUI::ElapsedTime waited;
+	for (size_t t = 0; t < threads.size(); t++) {
+		while (!threads[t]->FinishedJob()) {
+			if (waited.Duration() > stopSeconds)
+				return false;
+			WaitBriefly();
+		}
+	}
+	return true;
+}
+
+/// Only called once Stop has succeeded.
+LuaJobPool::~LuaJobPool() {
+	for (size_t t = 0; t < threads.size(); t++)
+		delete threads[t];
+	for (std::map<int, LuaJob *>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+		delete it->second;
+	delete mutex;
+}
+
+static void RunJob(LuaJob *job);
+
+void LuaJobPool::Start(LuaJob *job) {
+	jobs[job->id] = job;
+	bool startThread = false;
+	{
+		Lock lock(mutex);
+		waiting.push_back(job);
+		if (running < maxThreads) {
+			running++;
+			startThread = true;
+		}
+	}
+	if (!startThread)
+		return;
+	// Threads that have run out of jobs are replaced
+	for (size_t t = 0; t < threads.size();) {
+		if (threads[t]->FinishedJob()) {
+			delete threads[t];
+			threads.erase(threads.begin() + t);
+		} else {
+			t++;
+		}
+	}
+	LuaPoolThread *thread = new LuaPoolThread(this);
+	if (pHost->PerformOnNewThread(thread)) {
+		threads.push_back(thread);
+	} else {
+		delete thread;
+		bool fail = false;
+		{
+			Lock lock(mutex);
+			running--;
+			maxThreads = running > 0 ? running : 1;
+			// Left waiting when other threads will take it, otherwise running it here
+			// would block the user interface which is what Spawn is meant to avoid
+			if (running == 0) {
+				std::vector<LuaJob *>::iterator it = std::find(waiting.begin(), waiting.end(), job);
+				if (it != waiting.end()) {
+					waiting.erase(it);
+					fail = true;
+				}
+			}
+		}
+		if (fail)
+			Post(job, 'e', "> Lua: could not start a thread for the job", true);
+	}
+}
+
+void LuaJobPool::Cancel(LuaJob *job) {
+	job->cancelling = true;
+	bool post = false;
+	{
+		Lock lock(mutex);
+		std::vector<LuaJob *>::iterator it = std::find(waiting.begin(), waiting.end(), job);
+		if (it != waiting.end()) {
+			waiting.erase(it);
+			job->messages.push_back(LuaJob::Message('c', std::string()));
+			job->state = LuaJob::finished;
+			post = !job->posted && !stopping;
+			job->posted = true;
+		}
+	}
+	// Reported through the main loop like other results so callbacks never run inside Cancel
+	if (post)
+		pHost->PostOnMainThread(WORK_EXTENSION, job);
+}
+
+LuaJob::State LuaJobPool::StateOf(LuaJob *job) {
+	Lock lock(mutex);
+	return job->state;
+}
+
+LuaJob *LuaJobPool::Find(int id) const {
+	std::map<int, LuaJob *>::const_iterator it = jobs.find(id);
+	return (it != jobs.end()) ? it->second : 0;
+}
+
+/// Posts may arrive after their job is finished so only trust known jobs.
+LuaJob *LuaJobPool::Find(const Worker *pWorker) const {
+	for (std::map<int, LuaJob *>::const_iterator it = jobs.begin(); it != jobs.end(); ++it) {
+		if (it->second == pWorker)
+			return it->second;
+	}
+	return 0;
+}
+
+/// Move the job's messages into @a messages, returning whether the job has finished.
+bool LuaJobPool::Take(LuaJob *job, std::vector<LuaJob::Message> &messages) {
+	Lock lock(mutex);
+	messages.swap(job->messages);
+	job->posted = false;
+	return job->state == LuaJob::finished;
+}
+
+void LuaJobPool::Finished(LuaJob *job) {
+	jobs.erase(job->id);
+	delete job;
+}
+
+/// Called on a job's thread to queue a message for the main thread.
+/// After the final message the job must not be touched by that thread.
+void LuaJobPool::Post(LuaJob *job, char kind, const std::string &values, bool final) {
+	bool post = false;
+	{
+		Lock lock(mutex);
+		job->messages.push_back(LuaJob::Message(kind, values));
+		if (final)
+			job->state = LuaJob::finished;
+		post = !job->posted && !stopping;
+		job->posted = true;
+	}
+	if (post)
+		pHost->PostOnMainThread(WORK_EXTENSION, job);
+}
+
+/// Called on each pool thread to run waiting jobs until there are none left.
+void LuaJobPool::RunWaiting() {
+	for (;;) {
+		LuaJob *job = 0;
+		{
+			Lock lock(mutex);
+			if (waiting.empty()) {
+				running--;
+				return;
+			}
+			job = waiting.front();
+			waiting.erase(waiting.begin());
+			job->state = LuaJob::running;
+		}
+		RunJob(job);
+	}
+}
+
+// The functions available to jobs, which may only use their own state
+
+static LuaJob *job_of_state(lua_State *L) {
+	lua_getfield(L, LUA_REGISTRYINDEX, "SciTE_Job");
+	LuaJob *job = static_cast<LuaJob *>(lua_touserdata(L, -1));
+	lua_pop(L, 1);
+	return job;
+}
+
+static int cf_job_print(lua_State *L) {
+	int nargs = lua_gettop(L);
+	std::string text;
+	lua_getglobal(L, "tostring");
+	for (int i = 1; i <= nargs; ++i) {
+		if (i > 1)
+			text += '\t';
+		lua_pushvalue(L, -1); // tostring
+		lua_pushvalue(L, i);
+		lua_call(L, 1, 1);
+		const char *argStr = lua_tostring(L, -1);
+		if (!argStr)
+			raise_error(L, "tostring (called from print) returned a non-string");
+		text += argStr;
+		lua_pop(L, 1);
+	}
+	text += '\n';
+	LuaJob *job = job_of_state(L);
+	job->pool->Post(job, 'p', text);
+	return 0;
+}
+
+static int cf_job_post(lua_State *L) {
+	std::string values;
+	if (!EncodeValues(L, 1, lua_gettop(L), values))
+		raise_error(L, "Only nil, booleans, numbers, strings and tables of those can be posted");
+	LuaJob *job = job_of_state(L);
+	job->pool->Post(job, 'm', values);
+	return 0;
+}
+
+static int cf_job_cancelled(lua_State *L) {
+	lua_pushboolean(L, job_of_state(L)->cancelling ? 1 : 0);
+	return 1;
+}
+
+static void job_hook(lua_State *L, lua_Debug *ar) {
+	if ((ar->event == LUA_HOOKCOUNT) && job_of_state(L)->cancelling) {
+		// Raise on every instruction from now on so a script catching the error with pcall
+		// can not carry on
+		lua_sethook(L, job_hook, LUA_MASKCOUNT, 1);
+		luaL_error(L, "cancelled");
+	}
+}
+
+/// Run a job in a new state on the calling thread, posting its outcome.
+static void RunJob(LuaJob *job) {
+	lua_State *L = luaL_newstate();
+	if (!L) {
+		job->pool->Post(job, 'e', "> Lua: scripting engine failed to initalise for job", true);
+		return;
+	}
+
+	// Only libraries that can not affect the process or remove the cancel hook.
+	// debug is opened just for its traceback and then hidden from the job.
+	static const luaL_Reg jobLibs[] = {
+		{"", luaopen_base},
+		{LUA_TABLIBNAME, luaopen_table},
+		{LUA_STRLIBNAME, luaopen_string},
+		{LUA_MATHLIBNAME, luaopen_math},
+		{LUA_DBLIBNAME, luaopen_debug},
+		{NULL, NULL}
+	};
+	for (const luaL_Reg *lib = jobLibs; lib->func; lib++) {
+		lua_pushcfunction(L, lib->func);
+		lua_pushstring(L, lib->name);
+		lua_call(L, 1, 0);
+	}
+	lua_getglobal(L, LUA_DBLIBNAME);
+	lua_getfield(L, -1, "traceback");
+	lua_remove(L, -2);
+	const int traceback = lua_gettop(L);
+	lua_pushnil(L);
+	lua_setglobal(L, LUA_DBLIBNAME);
+
+	lua_pushlightuserdata(L, job);
+	lua_setfield(L, LUA_REGISTRYINDEX, "SciTE_Job");
+	lua_register(L, "print", cf_job_print);
+	lua_register(L, "post", cf_job_post);
+	lua_register(L, "cancelled", cf_job_cancelled);
+	lua_sethook(L, job_hook, LUA_MASKCOUNT, 1000);
+
+	char kind = 'r';
+	std::string outcome;
+	int result = luaL_loadbuffer(L, job->source.c_str(), job->source.length(), "=scite.Spawn");
+	if (result == 0) {
+		const int nargs = DecodeValues(L, job->args);
+		result = lua_pcall(L, nargs, LUA_MULTRET, traceback);
+	}
+	if (job->cancelling) {
+		kind = 'c';
+	} else if (result == 0) {
+		if (!EncodeValues(L, traceback + 1, lua_gettop(L), outcome)) {
+			kind = 'e';
+			outcome = "Only nil, booleans, numbers, strings and tables of those can be returned";
+		}
+	} else {
+		kind = 'e';
+		const char *message = lua_tostring(L, -1);
+		outcome = message ? message : "unknown error";
+	}
+	lua_close(L);
+	job->pool->Post(job, kind, outcome, true);
+}
+
+// On the main thread, a job is represented by a userdata holding its id whose environment
+// is a record of its callback and outcome.  Records of unfinished jobs are also kept in
+// the registry so their callbacks can be found.
+
+static int job_id(lua_State *L) {
+	int *id = static_cast<int *>(checkudata(L, 1, "SciTE_MT_Job"));
+	if (!id)
+		raise_error(L, "Self argument for job method is not a job.");
+	return *id;
+}
+
+static int cf_job_cancel(lua_State *L) {
+	int id = job_id(L);
+	if (jobPool) {
+		LuaJob *job = jobPool->Find(id);
+		if (job)
+			jobPool->Cancel(job);
+	}
+	return 0;
+}
+
+static void push_job_status(lua_State *L, int id) {
+	lua_getfenv(L, 1);
+	lua_getfield(L, -1, "status");
+	lua_remove(L, -2);
+	LuaJob *job = jobPool ? jobPool->Find(id) : 0;
+	if (job && (jobPool->StateOf(job) == LuaJob::running) && (0 == strcmp(lua_tostring(L, -1), "queued"))) {
+		lua_pop(L, 1);
+		lua_pushliteral(L, "running");
+	}
+}
+
+static int cf_job_status(lua_State *L) {
+	push_job_status(L, job_id(L));
+	return 1;
+}
+
+static int cf_job_result(lua_State *L) {
+	int id = job_id(L);
+	lua_getfenv(L, 1);
+	int record = lua_gettop(L);
+	lua_getfield(L, record, "status");
+	const char *status = lua_tostring(L, -1);
+	if (status && (0 == strcmp(status, "done"))) {
+		lua_getfield(L, record, "results");
+		int results = lua_gettop(L);
+		lua_getfield(L, results, "n");
+		int n = static_cast<int>(lua_tointeger(L, -1));
+		lua_pop(L, 1);
+		luaL_checkstack(L, n, "too many results");
+		for (int i = 1; i <= n; i++)
+			lua_rawgeti(L, results, i);
+		return n;
+	}
+	lua_pushnil(L);
+	if (status && (0 == strcmp(status, "error")))
+		lua_getfield(L, record, "error");
+	else
+		push_job_status(L, id);
+	return 2;
+}
+
+// scite.Spawn(source [, args [, callback]]) runs the Lua chunk source on a worker thread
+// with the elements of the args table as its arguments.  callback is called on the main
+// thread with "message" and the values of each post, then once with "done" and the values
+// returned, "error" and a message, or "cancelled".
+static int cf_scite_spawn(lua_State *L) {
+	size_t sourceLength = 0;
+	const char *source = luaL_checklstring(L, 1, &sourceLength);
+	std::string args;
+	if (lua_isnoneornil(L, 2)) {
+		EncodeValues(L, 1, 0, args);
+	} else {
+		luaL_checktype(L, 2, LUA_TTABLE);
+		int n = static_cast<int>(lua_objlen(L, 2));
+		luaL_checkstack(L, n, "too many arguments");
+		for (int i = 1; i <= n; i++)
+			lua_rawgeti(L, 2, i);
+		if (!EncodeValues(L, lua_gettop(L) - n + 1, lua_gettop(L), args))
+			raise_error(L, "Only nil, booleans, numbers, strings and tables of those can be passed to Spawn");
+		lua_pop(L, n);
+	}
+	if (!lua_isnoneornil(L, 3))
+		luaL_checktype(L, 3, LUA_TFUNCTION);
+
+	static int nextJobId = 1;
+	const int id = nextJobId++;
+
+	lua_newtable(L);
+	int record = lua_gettop(L);
+	lua_pushvalue(L, 3);
+	lua_setfield(L, record, "callback");
+	lua_pushliteral(L, "queued");
+	lua_setfield(L, record, "status");
+
+	lua_getfield(L, LUA_REGISTRYINDEX, "SciTE_Jobs");
+	if (!lua_istable(L, -1)) {
+		lua_pop(L, 1);
+		lua_newtable(L);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, LUA_REGISTRYINDEX, "SciTE_Jobs");
+	}
+	lua_pushvalue(L, record);
+	lua_rawseti(L, -2, id);
+	lua_pop(L, 1);
+
+	int *jobUserData = static_cast<int *>(lua_newuserdata(L, sizeof(int)));
+	*jobUserData = id;
+	if (luaL_newmetatable(L, "SciTE_MT_Job")) {
+		lua_newtable(L);
+		lua_pushcfunction(L, cf_job_cancel);
+		lua_setfield(L, -2, "Cancel");
+		lua_pushcfunction(L, cf_job_status);
+		lua_setfield(L, -2, "Status");
+		lua_pushcfunction(L, cf_job_result);
+		lua_setfield(L, -2, "Result");
+		lua_setfield(L, -2, "__index");
+	}
+	lua_setmetatable(L, -2);
+	lua_pushvalue(L, record);
+	lua_setfenv(L, -2);
+
+	if (!jobPool)
+		jobPool = new LuaJobPool(host);
+	jobPool->SetMaxThreads(GetPropertyInt("ext.lua.workers", 2));
+	jobPool->Start(new LuaJob(jobPool, id, std::string(source, sourceLength), args));
+	return 1;
+}
+
+// Deliver a message from a job to its callback
+static void DeliverJobMessage(lua_State *L, int id, const LuaJob::Message &message) {
+	if (message.kind == 'p') {
+		host->Trace(message.values.c_str());
+		return;
+	}
+	const int base = lua_gettop(L);
+	lua_getfield(L, LUA_REGISTRYINDEX, "SciTE_Jobs");
+	if (!lua_istable(L, -1)) {
+		lua_settop(L, base);
+		return;
+	}
+	const int jobs = lua_gettop(L);
+	lua_rawgeti(L, jobs, id);
+	if (!lua_istable(L, -1)) {
+		lua_settop(L, base);
+		return;
+	}
+	const int record = lua_gettop(L);
+
+	const char *status = "message";
+	if (message.kind == 'r')
+		status = "done";
+	else if (message.kind == 'e')
+		status = "error";
+	else if (message.kind == 'c')
+		status = "cancelled";
+	if (message.kind != 'm') {
+		lua_pushstring(L, status);
+		lua_setfield(L, record, "status");
+		if (message.kind == 'r') {
+			lua_newtable(L);
+			const int n = DecodeValues(L, message.values);
+			for (int i = n; i >= 1; i--)
+				lua_rawseti(L, -1 - i, i);
+			lua_pushinteger(L, n);
+			lua_setfield(L, -2, "n");
+			lua_setfield(L, record, "results");
+		} else if (message.kind == 'e') {
+			lua_pushstring(L, message.values.c_str());
+			lua_setfield(L, record, "error");
+		}
+		lua_pushnil(L);
+		lua_rawseti(L, jobs, id);
+	}
+
+	lua_getfield(L, record, "callback");
+	if (lua_isfunction(L, -1)) {
+		lua_pushstring(L, status);
+		int nargs = 1;
+		if ((message.kind == 'm') || (message.kind == 'r')) {
+			nargs += DecodeValues(L, message.values);
+		} else if (message.kind == 'e') {
+			lua_pushstring(L, message.values.c_str());
+			nargs++;
+		}
+		call_function(L, nargs, true);
+	} else if (message.kind == 'e') {
+		// Errors are not lost when nobody is listening
+		host->Trace(message.values.c_str());
+		host->Trace("\n");
+	}
+	lua_settop(L, base);
+}
+
 static bool InitGlobalScope(bool checkProperties, bool forceReload = false) {
+	StartupPhase phase("InitGlobalScope");
 	bool reload = forceReload;
 	if (checkProperties) {
 		int resetMode = GetPropertyInt("ext.lua.reset");
@@ -1287,6 +2638,18 @@ static bool InitGlobalScope(bool checkProperties, bool forceReload = false) {
 	}
 
 	tracebackEnabled = (GetPropertyInt("ext.lua.debug.traceback") == 1);
+	profileEnabled = GetPropertyInt("ext.lua.profile") == 1;
+	profileSampleInterval = GetPropertyInt("ext.lua.profile.sample");
+	budgetSeconds = GetPropertyInt("ext.lua.budget") / 1000.0;
+	budgetTrips = GetPropertyInt("ext.lua.budget.trips", 3);
+	luaCacheDirectory.clear();
+	if (host) {
+		char *cacheDirectory = host->Property("ext.lua.cache.directory");
+		if (cacheDirectory) {
+			luaCacheDirectory = cacheDirectory;
+			delete []cacheDirectory;
+		}
+	}
 
 	if (luaState) {
 		// The Clear / Load used to use metatables to setup without having to re-run the scripts,
@@ -1308,6 +2671,16 @@ static bool InitGlobalScope(bool checkProperties, bool forceReload = false) {
 				merge_table(luaState, -1, -2, false);
 				lua_pop(luaState, 2);
 
+				// restore the handlers added by the startup script
+				lua_getfield(luaState, LUA_REGISTRYINDEX, "SciTE_InitialHandlers");
+				handlersAdded = lua_istable(luaState, -1);
+				if (handlersAdded)
+					clone_handler_lists(luaState, -1);
+				else
+					lua_pushnil(luaState);
+				lua_setfield(luaState, LUA_REGISTRYINDEX, "SciTE_Handlers");
+				lua_pop(luaState, 1);
+
 				PublishGlobalBufferData();
 
 				return true;
@@ -1327,6 +2700,11 @@ static bool InitGlobalScope(bool checkProperties, bool forceReload = false) {
 		lua_pushnil(luaState);
 		lua_setfield(luaState, LUA_REGISTRYINDEX, "SciTE_BufferData_Array");
 
+		// Handlers are added again when the scripts are run
+		handlersAdded = false;
+		lua_pushnil(luaState);
+		lua_setfield(luaState, LUA_REGISTRYINDEX, "SciTE_Handlers");
+
 		// Don't replace global scope using new_table, because then startup script is
 		// bound to a different copy of the globals than the extension script.
 		clear_table(luaState, LUA_GLOBALSINDEX, true);
@@ -1345,6 +2723,7 @@ static bool InitGlobalScope(bool checkProperties, bool forceReload = false) {
 			return false;
 		}
 		lua_atpanic(luaState, LuaPanicFunction);
+		handlersAdded = false;
 
 	} else {
 		return false;
@@ -1353,6 +2732,31 @@ static bool InitGlobalScope(bool checkProperties, bool forceReload = false) {
 	// ...register standard libraries
 	luaL_openlibs(luaState);
 
+	// Keep debug.traceback in the registry so call_function need not look it up each time
+	lua_getglobal(luaState, "debug");
+	if (lua_istable(luaState, -1))
+		lua_getfield(luaState, -1, "traceback");
+	else
+		lua_pushnil(luaState);
+	lua_setfield(luaState, LUA_REGISTRYINDEX, "SciTE_Traceback");
+	lua_pop(luaState, 1);
+
+	// Put the cached loader ahead of Lua's own loader for Lua files
+	lua_getglobal(luaState, "package");
+	if (lua_istable(luaState, -1)) {
+		lua_getfield(luaState, -1, "loaders");
+		if (lua_istable(luaState, -1)) {
+			for (int i = static_cast<int>(lua_objlen(luaState, -1)); i >= 2; i--) {
+				lua_rawgeti(luaState, -1, i);
+				lua_rawseti(luaState, -2, i + 1);
+			}
+			lua_pushcfunction(luaState, cf_cached_loader);
+			lua_rawseti(luaState, -2, 2);
+		}
+		lua_pop(luaState, 1);
+	}
+	lua_pop(luaState, 1);
+
 	lua_register(luaState, "_ALERT", cf_global_print);
 
 	// although this is mostly redundant with output:append
@@ -1418,6 +2822,18 @@ static bool InitGlobalScope(bool checkProperties, bool forceReload = false) {
 	lua_pushcfunction(luaState, cf_scite_strip_value);
 	lua_setfield(luaState, -2, "StripValue");
 
+	lua_pushcfunction(luaState, cf_scite_add_handler);
+	lua_setfield(luaState, -2, "AddHandler");
+
+	lua_pushcfunction(luaState, cf_scite_remove_handler);
+	lua_setfield(luaState, -2, "RemoveHandler");
+
+	lua_pushcfunction(luaState, cf_scite_profile);
+	lua_setfield(luaState, -2, "Profile");
+
+	lua_pushcfunction(luaState, cf_scite_spawn);
+	lua_setfield(luaState, -2, "Spawn");
+
 	lua_setglobal(luaState, "scite");
 
 	// Metatable for global namespace, to publish iface constants
@@ -1440,7 +2856,8 @@ static bool InitGlobalScope(bool checkProperties, bool forceReload = false) {
 
 		FilePath fpTest(GUI::StringFromUTF8(startupScript));
 		if (fpTest.Exists()) {
-			luaL_loadfile(luaState, startupScript);
+			StartupPhase phaseScript("LuaStartupScript", startupScript);
+			load_file_cached(luaState, startupScript);
 			if (!call_function(luaState, 0, true)) {
 				host->Trace(">Lua: error occurred while loading startup script\n");
 			}
@@ -1459,6 +2876,17 @@ static bool InitGlobalScope(bool checkProperties, bool forceReload = false) {
 	lua_setfield(luaState, LUA_REGISTRYINDEX, "SciTE_InitialPackageState");
 	lua_pop(luaState, 1);
 
+	// Likewise for the handlers added by the startup script
+	if (handlersAdded) {
+		push_handler_lists(luaState);
+		clone_handler_lists(luaState, -1);
+		lua_setfield(luaState, LUA_REGISTRYINDEX, "SciTE_InitialHandlers");
+		lua_pop(luaState, 1);
+	} else {
+		lua_pushnil(luaState);
+		lua_setfield(luaState, LUA_REGISTRYINDEX, "SciTE_InitialHandlers");
+	}
+
 	PublishGlobalBufferData();
 
 	return true;
@@ -1475,6 +2903,13 @@ bool LuaExtension::Initialise(ExtensionAPI *host_) {
 }
 
 bool LuaExtension::Finalise() {
+	// Jobs are cancelled and their threads finish before the state their callbacks are in goes.
+	// This may be called from the host's destructor so jobs no longer post to the host.
+	// A thread stuck in a library call still uses its pool which is then left for process exit.
+	if (jobPool && jobPool->Stop())
+		delete jobPool;
+	jobPool = 0;
+
 	if (luaState) {
 		lua_close(luaState);
 	}
@@ -1512,7 +2947,8 @@ bool LuaExtension::Load(const char *filename) {
 		if (sl >= 4 && strcmp(filename+sl-4, ".lua")==0) {
 			if (luaState || InitGlobalScope(false)) {
 				extensionScript = filename;
-				luaL_loadfile(luaState, filename);
+				StartupPhase phase("LuaExtensionScript", filename);
+				load_file_cached(luaState, filename);
 				if (!call_function(luaState, 0, true)) {
 					host->Trace(">Lua: error occurred while loading extension script\n");
 				}
@@ -1622,6 +3058,9 @@ bool LuaExtension::OnExecute(const char *s) {
 				int status = lua_pcall(luaState, 2, 4, 0);
 				if (status==0) {
 					lua_insert(luaState, stackBase+1);
+					std::string command;
+					if (profileEnabled && lua_isstring(luaState, -1))
+						command = lua_tostring(luaState, -1);
 					lua_gettable(luaState, LUA_GLOBALSINDEX);
 					if (!lua_isnil(luaState, -1)) {
 						if (lua_isfunction(luaState, -1)) {
@@ -1629,6 +3068,7 @@ bool LuaExtension::OnExecute(const char *s) {
 							handled = true;
 							lua_insert(luaState, stackBase+1);
 							lua_settop(luaState, stackBase+2);
+							ProfileScope scope(luaState, stackBase+1, command.c_str());
 							if (!call_function(luaState, 1, true)) {
 								host->Trace(">Lua: error occurred while processing command\n");
 							}
@@ -1716,9 +3156,21 @@ struct StylingContext {
 	int lenCurrent;
 	int lenNext;
 
+	// The styler of the innermost OnStyle call, which is almost always self
+	static StylingContext *current;
+
+	// Methods have the styler metatable as their upvalue to check that self is a styler
 	static StylingContext *Context(lua_State *L) {
-		return reinterpret_cast<StylingContext *>(
-		        lua_touserdata(L, lua_upvalueindex(1)));
+		StylingContext *self = static_cast<StylingContext *>(lua_touserdata(L, 1));
+		if (self && (self == current))
+			return self;
+		if (!lua_getmetatable(L, 1) || !lua_rawequal(L, -1, lua_upvalueindex(1)))
+			luaL_typerror(L, 1, "styler");
+		lua_pop(L, 1);
+		StylingContext *context = static_cast<StylingContext *>(lua_touserdata(L, 1));
+		if (!context->styler)
+			luaL_error(L, "styler can only be used during OnStyle");
+		return context;
 	}
 
 	void Colourize() {
@@ -1819,29 +3271,34 @@ struct StylingContext {
 		        (currentPos >= endPos);
 	}
 
-	void StartStyling(unsigned int startPos_, unsigned int length, int initStyle_) {
-		endDoc = styler->Length();
-		endPos = startPos_ + length;
-		if (endPos == endDoc)
-			endPos = endDoc + 1;
-		currentPos = startPos_;
-		atLineStart = true;
+	// Move the character cursor to pos without styling the text passed over
+	void MoveTo(unsigned int pos) {
+		currentPos = pos;
 		atLineEnd = false;
-		state = initStyle_;
 		cursorPos = 0;
 		lenCurrent = 0;
 		lenNext = 0;
 		memcpy(cursor[0], "\0\0\0\0\0\0\0\0", 8);
 		memcpy(cursor[1], "\0\0\0\0\0\0\0\0", 8);
 		memcpy(cursor[2], "\0\0\0\0\0\0\0\0", 8);
-		styler->StartAt(startPos_, static_cast<char>(0xffu));
-		styler->StartSegment(startPos_);
 
 		GetNextChar();
 		cursorPos++;
 		GetNextChar();
 	}
 
+	void StartStyling(unsigned int startPos_, unsigned int length, int initStyle_) {
+		endDoc = styler->Length();
+		endPos = startPos_ + length;
+		if (endPos == endDoc)
+			endPos = endDoc + 1;
+		atLineStart = true;
+		state = initStyle_;
+		styler->StartAt(startPos_, static_cast<char>(0xffu));
+		styler->StartSegment(startPos_);
+		MoveTo(startPos_);
+	}
+
 	static int EndStyling(lua_State *L) {
 		StylingContext *context = Context(L);
 		context->Colourize();
@@ -1954,16 +3411,94 @@ struct StylingContext {
 		int len = end - start + 1;
 		if (len <= 0)
 			len = 1;
-		char *sReturn = new char[len+1];
+		luaL_Buffer b;
+		luaL_buffinit(L, &b);
 		for (int i = 0; i < len; i++) {
-			sReturn[i] = context->styler->SafeGetCharAt(start + i);
+			luaL_addchar(&b, context->styler->SafeGetCharAt(start + i));
 		}
-		sReturn[len] = '\0';
-		lua_pushstring(L, sReturn);
-		delete []sReturn;
+		luaL_pushresult(&b);
 		return 1;
 	}
 
+	// End of the text that may be styled, which excludes the extra position allowed at the end of the document
+	unsigned int EndRange() const {
+		return (endPos > endDoc) ? endDoc : endPos;
+	}
+
+	static int Text(lua_State *L) {
+		StylingContext *context = Context(L);
+		const int endRange = static_cast<int>(context->EndRange());
+		int start = luaL_optint(L, 2, context->currentPos);
+		int end = lua_isnoneornil(L, 3) ? endRange : start + luaL_checkint(L, 3);
+		if (start < 0)
+			start = 0;
+		if (end > static_cast<int>(context->endDoc))
+			end = static_cast<int>(context->endDoc);
+		if (end <= start) {
+			lua_pushliteral(L, "");
+			return 1;
+		}
+		std::vector<char> text(end - start + 1);
+		context->styler->GetRange(start, end, &text[0]);
+		lua_pushlstring(L, &text[0], end - start);
+		return 1;
+	}
+
+	// Read the length and style of run n from either {{length, style}, ...} or {length, style, ...}
+	static void GetRun(lua_State *L, bool flat, int n, int &length, int &style) {
+		if (flat) {
+			lua_rawgeti(L, 2, n * 2 - 1);
+			lua_rawgeti(L, 2, n * 2);
+		} else {
+			lua_rawgeti(L, 2, n);
+			if (!lua_istable(L, -1))
+				luaL_error(L, "run %d of SetStyles is not a {length, style} table", n);
+			lua_rawgeti(L, -1, 1);
+			lua_rawgeti(L, -2, 2);
+			lua_remove(L, -3);
+		}
+		if (!lua_isnumber(L, -2) || !lua_isnumber(L, -1))
+			luaL_error(L, "run %d of SetStyles does not have a numeric length and style", n);
+		length = static_cast<int>(lua_tointeger(L, -2));
+		style = static_cast<int>(lua_tointeger(L, -1));
+		lua_pop(L, 2);
+	}
+
+	static int SetStyles(lua_State *L) {
+		StylingContext *context = Context(L);
+		luaL_checktype(L, 2, LUA_TTABLE);
+		const int elements = static_cast<int>(lua_objlen(L, 2));
+		lua_rawgeti(L, 2, 1);
+		const bool flat = lua_isnumber(L, -1) != 0;
+		lua_pop(L, 1);
+		const int runs = flat ? elements / 2 : elements;
+		const unsigned int endRange = context->EndRange();
+
+		// Text passed over by Forward is styled with the current state first
+		context->Colourize();
+		unsigned int pos = context->currentPos;
+		for (int n = 1; n <= runs; n++) {
+			int length = 0;
+			int style = 0;
+			GetRun(L, flat, n, length, style);
+			if (length < 0)
+				luaL_error(L, "run %d of SetStyles has a negative length", n);
+			if (pos + length > endRange)
+				luaL_error(L, "run %d of SetStyles extends past the end of the range being styled", n);
+			if (length > 0) {
+				pos += length;
+				context->styler->ColourTo(pos - 1, style);
+			}
+		}
+		if (pos != context->currentPos) {
+			const char chBefore = context->styler->SafeGetCharAt(pos - 1);
+			context->MoveTo(pos);
+			context->atLineStart = (chBefore == '\n') ||
+				((chBefore == '\r') && (context->cursor[context->cursorPos % 3][0] != '\n'));
+		}
+		return 0;
+	}
+
 	bool Match(const char *s) {
 		for (int n=0; *s; n++) {
 			if (*s != styler->SafeGetCharAt(currentPos+n))
@@ -1980,74 +3515,132 @@ struct StylingContext {
 		return 1;
 	}
 
-	void PushMethod(lua_State *L, lua_CFunction fn, const char *name) {
-		lua_pushlightuserdata(L, this);
-		lua_pushcclosure(L, fn, 1);
-		lua_setfield(luaState, -2, name);
-	}
+	static void PushMetatable(lua_State *L);
+	static StylingContext *PushNew(lua_State *L);
+	static void SetFields(lua_State *L, int index, unsigned int startPos, int lengthDoc, int initStyle);
 };
 
+StylingContext *StylingContext::current = 0;
+
+static const luaL_Reg stylerMethods[] = {
+	{"Line", StylingContext::Line},
+	{"CharAt", StylingContext::CharAt},
+	{"StyleAt", StylingContext::StyleAt},
+	{"LevelAt", StylingContext::LevelAt},
+	{"SetLevelAt", StylingContext::SetLevelAt},
+	{"LineState", StylingContext::LineState},
+	{"SetLineState", StylingContext::SetLineState},
+
+	{"StartStyling", StylingContext::StartStyling},
+	{"EndStyling", StylingContext::EndStyling},
+	{"More", StylingContext::More},
+	{"Forward", StylingContext::Forward},
+	{"Position", StylingContext::Position},
+	{"AtLineStart", StylingContext::AtLineStart},
+	{"AtLineEnd", StylingContext::AtLineEnd},
+	{"State", StylingContext::State},
+	{"SetState", StylingContext::SetState},
+	{"ForwardSetState", StylingContext::ForwardSetState},
+	{"ChangeState", StylingContext::ChangeState},
+	{"Current", StylingContext::Current},
+	{"Next", StylingContext::Next},
+	{"Previous", StylingContext::Previous},
+	{"Token", StylingContext::Token},
+	{"Match", StylingContext::Match},
+	{"Text", StylingContext::Text},
+	{"SetStyles", StylingContext::SetStyles},
+	{NULL, NULL}
+};
+
+/**
+ * Push the metatable shared by the stylers of a Lua state. Its __index table holds
+ * the methods along with the fields of the current OnStyle call.
+ */
+void StylingContext::PushMetatable(lua_State *L) {
+	if (luaL_newmetatable(L, "SciTE_MT_Styler")) {
+		lua_newtable(L);
+		for (const luaL_Reg *method = stylerMethods; method->name; method++) {
+			lua_pushvalue(L, -2);
+			lua_pushcclosure(L, method->func, 1);
+			lua_setfield(L, -2, method->name);
+		}
+		lua_setfield(L, -2, "__index");
+	}
+}
+
+/// Push a new styler which is not yet styling.
+StylingContext *StylingContext::PushNew(lua_State *L) {
+	StylingContext *context = static_cast<StylingContext *>(lua_newuserdata(L, sizeof(StylingContext)));
+	memset(context, 0, sizeof(StylingContext));
+	PushMetatable(L);
+	lua_setmetatable(L, -2);
+	return context;
+}
+
+/// Set the fields of the styler at @a index that describe the range to style.
+void StylingContext::SetFields(lua_State *L, int index, unsigned int startPos, int lengthDoc, int initStyle) {
+	lua_getmetatable(L, index);
+	lua_getfield(L, -1, "__index");
+
+	lua_pushinteger(L, startPos);
+	lua_setfield(L, -2, "startPos");
+
+	lua_pushinteger(L, lengthDoc);
+	lua_setfield(L, -2, "lengthDoc");
+
+	lua_pushinteger(L, initStyle);
+	lua_setfield(L, -2, "initStyle");
+
+	char *lang = host->Property("Language");
+	lua_pushstring(L, lang);
+	delete []lang;
+	lua_setfield(L, -2, "language");
+
+	lua_pop(L, 2);
+}
+
 bool LuaExtension::OnStyle(unsigned int startPos, int lengthDoc, int initStyle, StyleWriter *styler) {
 	bool handled = false;
 	if (luaState) {
-		lua_getglobal(luaState, "OnStyle");
-		if (lua_isfunction(luaState, -1)) {
-
-			StylingContext sc;
-			sc.startPos = startPos;
-			sc.lengthDoc = lengthDoc;
-			sc.initStyle = initStyle;
-			sc.styler = styler;
-			sc.codePage = static_cast<int>(host->Send(ExtensionAPI::paneEditor, SCI_GETCODEPAGE));
-
-			lua_newtable(luaState);
+		int handlers = PushHandlers(luaState, "OnStyle");
+		if (handlers) {
+
+			// The same styler is used for each call. Another is only made for a call made
+			// while styling, such as by a script that asks for more of the document to be styled.
+			lua_getfield(luaState, LUA_REGISTRYINDEX, "SciTE_Styler");
+			StylingContext *sc = static_cast<StylingContext *>(lua_touserdata(luaState, -1));
+			StylingContext *outer = 0;
+			if (!sc || sc->styler) {
+				outer = sc;
+				lua_pop(luaState, 1);
+				sc = StylingContext::PushNew(luaState);
+				if (!outer) {
+					lua_pushvalue(luaState, -1);
+					lua_setfield(luaState, LUA_REGISTRYINDEX, "SciTE_Styler");
+				}
+			}
+			sc->startPos = startPos;
+			sc->lengthDoc = lengthDoc;
+			sc->initStyle = initStyle;
+			sc->styler = styler;
+			sc->codePage = static_cast<int>(host->Send(ExtensionAPI::paneEditor, SCI_GETCODEPAGE));
+			StylingContext::SetFields(luaState, -1, startPos, lengthDoc, initStyle);
+			StylingContext::current = sc;
+
+			// Keep a reference below the handlers so the styler outlives the calls
+			lua_pushvalue(luaState, -1);
+			lua_insert(luaState, -(handlers + 2));
+			handled = CallHandlers(luaState, "OnStyle", handlers, 1);
 
-			lua_pushstring(luaState, "startPos");
-			lua_pushinteger(luaState, startPos);
-			lua_settable(luaState, -3);
-
-			lua_pushstring(luaState, "lengthDoc");
-			lua_pushinteger(luaState, lengthDoc);
-			lua_settable(luaState, -3);
-
-			lua_pushstring(luaState, "initStyle");
-			lua_pushinteger(luaState, initStyle);
-			lua_settable(luaState, -3);
-
-			lua_pushstring(luaState, "language");
-			char *lang = host->Property("Language");
-			lua_pushstring(luaState, lang);
-			delete []lang;
-			lua_settable(luaState, -3);
-
-			sc.PushMethod(luaState, StylingContext::Line, "Line");
-			sc.PushMethod(luaState, StylingContext::CharAt, "CharAt");
-			sc.PushMethod(luaState, StylingContext::StyleAt, "StyleAt");
-			sc.PushMethod(luaState, StylingContext::LevelAt, "LevelAt");
-			sc.PushMethod(luaState, StylingContext::SetLevelAt, "SetLevelAt");
-			sc.PushMethod(luaState, StylingContext::LineState, "LineState");
-			sc.PushMethod(luaState, StylingContext::SetLineState, "SetLineState");
-
-			sc.PushMethod(luaState, StylingContext::StartStyling, "StartStyling");
-			sc.PushMethod(luaState, StylingContext::EndStyling, "EndStyling");
-			sc.PushMethod(luaState, StylingContext::More, "More");
-			sc.PushMethod(luaState, StylingContext::Forward, "Forward");
-			sc.PushMethod(luaState, StylingContext::Position, "Position");
-			sc.PushMethod(luaState, StylingContext::AtLineStart, "AtLineStart");
-			sc.PushMethod(luaState, StylingContext::AtLineEnd, "AtLineEnd");
-			sc.PushMethod(luaState, StylingContext::State, "State");
-			sc.PushMethod(luaState, StylingContext::SetState, "SetState");
-			sc.PushMethod(luaState, StylingContext::ForwardSetState, "ForwardSetState");
-			sc.PushMethod(luaState, StylingContext::ChangeState, "ChangeState");
-			sc.PushMethod(luaState, StylingContext::Current, "Current");
-			sc.PushMethod(luaState, StylingContext::Next, "Next");
-			sc.PushMethod(luaState, StylingContext::Previous, "Previous");
-			sc.PushMethod(luaState, StylingContext::Token, "Token");
-			sc.PushMethod(luaState, StylingContext::Match, "Match");
-
-			handled = call_function(luaState, 1);
-		} else {
+			// Methods called after OnStyle returns fail rather than using a stale styler
+			sc->styler = 0;
+			StylingContext::current = outer;
 			lua_pop(luaState, 1);
+			if (outer) {
+				lua_getfield(luaState, LUA_REGISTRYINDEX, "SciTE_Styler");
+				StylingContext::SetFields(luaState, -1, outer->startPos, outer->lengthDoc, outer->initStyle);
+				lua_pop(luaState, 1);
+			}
 		}
 	}
 	return handled;
@@ -2072,15 +3665,13 @@ bool LuaExtension::OnUserListSelection(int listType, const char *selection) {
 bool LuaExtension::OnKey(int keyval, int modifiers) {
 	bool handled = false;
 	if (luaState) {
-		lua_getglobal(luaState, "OnKey");
-		if (lua_isfunction(luaState, -1)) {
+		int handlers = PushHandlers(luaState, "OnKey");
+		if (handlers) {
 			lua_pushnumber(luaState, keyval);
 			lua_pushboolean(luaState, (SCMOD_SHIFT & modifiers) != 0 ? 1 : 0); // shift/lock
 			lua_pushboolean(luaState, (SCMOD_CTRL  & modifiers) != 0 ? 1 : 0); // control
 			lua_pushboolean(luaState, (SCMOD_ALT   & modifiers) != 0 ? 1 : 0); // alt
-			handled = call_function(luaState, 4);
-		} else {
-			lua_pop(luaState, 1);
+			handled = CallHandlers(luaState, "OnKey", handlers, 4);
 		}
 	}
 	return handled;
@@ -2098,6 +3689,22 @@ bool LuaExtension::OnUserStrip(int control, int change) {
 	return CallNamedFunction("OnStrip", control, change);
 }
 
+bool LuaExtension::OnWorker(Worker *pWorker) {
+	LuaJob *job = jobPool ? jobPool->Find(pWorker) : 0;
+	if (!job)
+		return false;
+	std::vector<LuaJob::Message> messages;
+	const bool finished = jobPool->Take(job, messages);
+	const int id = job->id;
+	if (finished)
+		jobPool->Finished(job);
+	if (luaState) {
+		for (size_t m = 0; m < messages.size(); m++)
+			DeliverJobMessage(luaState, id, messages[m]);
+	}
+	return true;
+}
+
 #ifdef _MSC_VER
 // Unreferenced inline functions are OK
 #pragma warning(disable: 4514)
@@ -40,4 +40,5 @@ public:
 	virtual bool OnDwellStart(int pos, const char *word);
 	virtual bool OnClose(const char *filename);
 	virtual bool OnUserStrip(int control, int change);
+	virtual bool OnWorker(Worker *pWorker);
 };
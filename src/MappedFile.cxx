@@ -0,0 +1,109 @@
+// SciTE - Scintilla based Text Editor
+/** @file MappedFile.cxx
+ ** Implementation of a file mapped into memory.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <stdlib.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <string>
+
+#if defined(__unix__)
+
+#include <unistd.h>
+#include <sys/mman.h>
+
+#else
+
+#undef _WIN32_WINNT
+#define _WIN32_WINNT  0x0500
+#ifdef _MSC_VER
+// windows.h, et al, use a lot of nameless struct/unions - can't fix it, so allow it
+#pragma warning(disable: 4201)
+#endif
+#include <windows.h>
+#ifdef _MSC_VER
+// okay, that's done, don't allow it in our code
+#pragma warning(default: 4201)
+#endif
+
+#endif
+
+#include "Scintilla.h"
+
+#include "GUI.h"
+#include "MappedFile.h"
+
+MappedFile::MappedFile() : data(0), size(0) {
+}
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+/**
+ * Map the file @a fileName, failing for empty files and for files too large
+ * for the address space.
+ */
+bool MappedFile::Open(const GUI::gui_char *fileName, bool copyOnWrite) {
+	Close();
+#if defined(__unix__)
+	int fd = open(fileName, O_RDONLY);
+	if (fd == -1)
+		return false;
+	struct stat statusFile;
+	if ((fstat(fd, &statusFile) == -1) || (statusFile.st_size <= 0) ||
+		(static_cast<off_t>(static_cast<size_t>(statusFile.st_size)) != statusFile.st_size)) {
+		close(fd);
+		return false;
+	}
+	const size_t sizeFile = static_cast<size_t>(statusFile.st_size);
+	void *mapping = copyOnWrite ?
+		mmap(0, sizeFile, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0) :
+		mmap(0, sizeFile, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+		return false;
+	data = static_cast<char *>(mapping);
+	size = sizeFile;
+#else
+	HANDLE hFile = ::CreateFileW(fileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER sizeFile;
+	if (!::GetFileSizeEx(hFile, &sizeFile) || (sizeFile.QuadPart <= 0) ||
+		(static_cast<LONGLONG>(static_cast<SIZE_T>(sizeFile.QuadPart)) != sizeFile.QuadPart)) {
+		::CloseHandle(hFile);
+		return false;
+	}
+	HANDLE hMapping = ::CreateFileMappingW(hFile, NULL, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+	::CloseHandle(hFile);
+	if (!hMapping)
+		return false;
+	// The view stays valid after the handles are closed
+	void *mapping = ::MapViewOfFile(hMapping, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+	::CloseHandle(hMapping);
+	if (!mapping)
+		return false;
+	data = static_cast<char *>(mapping);
+	size = static_cast<size_t>(sizeFile.QuadPart);
+#endif
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data) {
+#if defined(__unix__)
+		munmap(data, size);
+#else
+		::UnmapViewOfFile(data);
+#endif
+	}
+	data = 0;
+	size = 0;
+}
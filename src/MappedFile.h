@@ -0,0 +1,38 @@
+// SciTE - Scintilla based Text Editor
+/** @file MappedFile.h
+ ** Definition of a file mapped into memory.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+/**
+ * The whole of a file mapped into the address space so it can be read without
+ * reading it all: pages are only loaded as they are touched.
+ * A copy on write mapping may be written to without changing the file.
+ */
+class MappedFile {
+	char *data;
+	size_t size;
+	// Private so MappedFile objects can not be copied
+	MappedFile(const MappedFile &);
+	MappedFile &operator=(const MappedFile &);
+public:
+	MappedFile();
+	~MappedFile();
+	bool Open(const GUI::gui_char *fileName, bool copyOnWrite=false);
+	void Close();
+	bool IsOpen() const {
+		return data != 0;
+	}
+	char *Data() const {
+		return data;
+	}
+	size_t Size() const {
+		return size;
+	}
+};
+
+#endif
@@ -253,3 +253,10 @@ bool MultiplexExtension::OnUserStrip(int control, int change) {
 	return false;
 }
 
+bool MultiplexExtension::OnWorker(Worker *pWorker) {
+	for (int i = 0; i < extensionCount; ++i)
+		if (extensions[i]->OnWorker(pWorker))
+			return true;
+	return false;
+}
+
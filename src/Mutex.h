@@ -19,6 +19,19 @@ public:
 	static Mutex *Create();
 };
 
+/**
+ * Lets a thread wait until another thread signals it. A signal that arrives when no
+ * thread is waiting is kept for the next wait.
+ */
+class Event {
+public:
+	virtual void Signal() = 0;
+	/// Returns false if not signalled within @a milliseconds.
+	virtual bool Wait(int milliseconds) = 0;
+	virtual ~Event() {}
+	static Event *Create();
+};
+
 class Lock {
 	Mutex *mute;
 public:
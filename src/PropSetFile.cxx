@@ -34,6 +34,10 @@
 #include "SString.h"
 #include "FilePath.h"
 #include "PropSetFile.h"
+#include "Mutex.h"
+#include "Worker.h"
+#include "ImportPrefetch.h"
+#include "StartupProfile.h"
 
 // The comparison and case changing functions here assume ASCII
 // or extended ASCII such as the normal Windows code page.
@@ -76,26 +80,503 @@ bool ImportFilter::IsValid(std::string name) const {
 
 bool PropSetFile::caseSensitiveFilenames = false;
 
-PropSetFile::PropSetFile(bool lowerKeys_) : lowerKeys(lowerKeys_), superPS(0) {
+// Compiled wildcard indexes watch the keys evaluated while building them and the keys
+// starting with their keybase. When one of these changes in a set in the chain of an
+// index, the stamp of the watched key or prefix is set to a new value of wildStamp and
+// indexes built before then are no longer valid. wildGeneration changes with any watched
+// change so an index that has been checked since need not check its watches again.
+static unsigned int wildGeneration = 0;
+static unsigned int wildStamp = 0;
+static unsigned int wildReset = 0;	///< Indexes built before this stamp are invalid
+typedef std::map<std::string, unsigned int> WatchStamps;
+static WatchStamps wildKeys;
+static WatchStamps wildPrefixes;
+// Source of the values of PropSetFile::changes so that no two states of any sets share one
+static unsigned int changeStamp = 0;
+static std::set<std::string> *keysEvaluated = 0;	///< Collects keys while building an index
+static std::set<std::string> *conditionsRead = 0;	///< Collects the tests of "if" lines
+static PropertyReads *readsRecorded = 0;
+
+static void InvalidateWildIndexes() {
+	wildGeneration++;
+	wildReset = ++wildStamp;
+	wildKeys.clear();
+	wildPrefixes.clear();
+}
+
+static void NoteChange(const std::string &key) {
+	WatchStamps::iterator itKey = wildKeys.find(key);
+	if (itKey != wildKeys.end()) {
+		itKey->second = ++wildStamp;
+		wildGeneration++;
+	}
+	// A prefix of key sorts before key
+	for (WatchStamps::iterator it = wildPrefixes.begin();
+		(it != wildPrefixes.end()) && (it->first <= key); ++it) {
+		if (key.compare(0, it->first.length(), it->first) == 0) {
+			it->second = ++wildStamp;
+			wildGeneration++;
+		}
+	}
+}
+
+static void Watch(WatchStamps &watches, const std::string &key, std::vector<std::string> &watched) {
+	watches.insert(std::pair<const std::string, unsigned int>(key, 0));
+	watched.push_back(key);
+}
+
+static bool WatchesUnchanged(const WatchStamps &watches, const std::vector<std::string> &watched, unsigned int built) {
+	for (std::vector<std::string>::const_iterator it = watched.begin(); it != watched.end(); ++it) {
+		WatchStamps::const_iterator itWatch = watches.find(*it);
+		if ((itWatch == watches.end()) || (itWatch->second > built))
+			return false;
+	}
+	return true;
+}
+
+static bool ChainMatches(const PropSetFile *psStart, const std::vector<const PropSetFile *> &chain) {
+	const PropSetFile *psf = psStart;
+	for (size_t i = 0; i < chain.size(); i++) {
+		if (psf != chain[i])
+			return false;
+		psf = psf->superPS;
+	}
+	return psf == 0;
+}
+
+/**
+ * A property name stored once for all property sets so that tables hold pointers to it
+ * and copying a table does not copy its keys.
+ */
+struct PropertyKey {
+	unsigned int hash;
+	std::string name;
+	mutable int uses;	///< Slots of tables holding this key
+};
+
+static unsigned int HashKey(const char *key, size_t len) {
+	// FNV-1a
+	unsigned int hash = 2166136261u;
+	for (size_t i = 0; i < len; i++) {
+		hash ^= static_cast<unsigned char>(key[i]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Every key held by a table, found by hash. A key is freed when no table holds it.
+ * Property sets and so the pool and the uses of keys are only touched by the main
+ * thread: threads reading imports ahead of use only read files and Lua jobs do not
+ * see properties.
+ */
+class KeyPool {
+	typedef std::multimap<unsigned int, PropertyKey *> KeysByHash;
+	KeysByHash keys;
+public:
+	~KeyPool() {
+		for (KeysByHash::iterator it = keys.begin(); it != keys.end(); ++it)
+			delete it->second;
+	}
+	/// The key with this name, counting a use of it.
+	const PropertyKey *Intern(const char *key, size_t len, unsigned int hash) {
+		std::pair<KeysByHash::iterator, KeysByHash::iterator> range = keys.equal_range(hash);
+		for (KeysByHash::iterator it = range.first; it != range.second; ++it) {
+			if ((it->second->name.length() == len) && (memcmp(it->second->name.c_str(), key, len) == 0)) {
+				it->second->uses++;
+				return it->second;
+			}
+		}
+		PropertyKey *pk = new PropertyKey;
+		pk->hash = hash;
+		pk->name.assign(key, len);
+		pk->uses = 1;
+		keys.insert(range.second, std::make_pair(hash, pk));
+		return pk;
+	}
+	void Release(const PropertyKey *pk) {
+		if (--pk->uses > 0)
+			return;
+		std::pair<KeysByHash::iterator, KeysByHash::iterator> range = keys.equal_range(pk->hash);
+		for (KeysByHash::iterator it = range.first; it != range.second; ++it) {
+			if (it->second == pk) {
+				keys.erase(it);
+				break;
+			}
+		}
+		delete pk;
+	}
+};
+
+static KeyPool keyPool;
+
+/**
+ * The keys and values of a property set in an open addressing hash table with linear
+ * probing. Values are kept one after another in a single buffer, each followed by a NUL,
+ * and the buffer is compacted when most of it holds replaced values.
+ * The keys in order, needed for prefix searches and enumeration, are sorted when first
+ * needed and then kept in order as keys are added and removed.
+ * A table is shared by copies of a property set until one of them changes it.
+ */
+class PropertyTable {
+	struct Slot {
+		const PropertyKey *key;	///< 0 when the slot is empty
+		size_t valueStart;
+		size_t valueLength;
+	};
+	std::vector<Slot> slots;	///< Size is a power of 2 and at most half the slots are used
+	size_t used;
+	std::vector<char> values;
+	size_t valuesGarbage;	///< Bytes of values that have been replaced or removed
+	mutable std::vector<const PropertyKey *> sorted;	///< Keys in order when sortedValid
+	mutable bool sortedValid;
+	size_t Probe(const char *key, size_t len, unsigned int hash) const;
+	void Grow();
+	void CompactValues();
+	void StoreValue(Slot &slot, const char *val, size_t lenVal);
+	PropertyTable &operator=(const PropertyTable &);
+public:
+	int references;	///< Property sets sharing this table, all on the main thread
+
+	PropertyTable() : slots(16), used(0), valuesGarbage(0), sortedValid(false), references(1) {
+		for (size_t i = 0; i < slots.size(); i++)
+			slots[i].key = 0;
+	}
+	/// A copy that is not yet shared, without the replaced values
+	PropertyTable(const PropertyTable &other) : slots(other.slots), used(other.used),
+		values(other.values), valuesGarbage(other.valuesGarbage),
+		sorted(other.sorted), sortedValid(other.sortedValid), references(1) {
+		for (size_t i = 0; i < slots.size(); i++) {
+			if (slots[i].key)
+				slots[i].key->uses++;
+		}
+		CompactValues();
+	}
+	~PropertyTable() {
+		for (size_t i = 0; i < slots.size(); i++) {
+			if (slots[i].key)
+				keyPool.Release(slots[i].key);
+		}
+	}
+	bool Empty() const {
+		return used == 0;
+	}
+	const char *Find(const char *key, size_t len, size_t *lenValue=0) const;
+	bool Set(const char *key, size_t lenKey, const char *val, size_t lenVal);
+	bool Remove(const char *key, size_t len);
+	size_t Count() const {
+		return used;
+	}
+	// Access in order of key
+	size_t LowerBound(const char *key, size_t len) const;
+	const std::string &KeyAt(size_t position) const;
+	const char *ValueAt(size_t position) const;
+};
+
+size_t PropertyTable::Probe(const char *key, size_t len, unsigned int hash) const {
+	const size_t mask = slots.size() - 1;
+	size_t i = hash & mask;
+	while (slots[i].key) {
+		const PropertyKey *pk = slots[i].key;
+		if ((pk->hash == hash) && (pk->name.length() == len) && (memcmp(pk->name.c_str(), key, len) == 0))
+			return i;
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+void PropertyTable::Grow() {
+	std::vector<Slot> old(slots.size() * 2);
+	old.swap(slots);
+	for (size_t i = 0; i < slots.size(); i++)
+		slots[i].key = 0;
+	const size_t mask = slots.size() - 1;
+	for (size_t o = 0; o < old.size(); o++) {
+		if (old[o].key) {
+			size_t i = old[o].key->hash & mask;
+			while (slots[i].key)
+				i = (i + 1) & mask;
+			slots[i] = old[o];
+		}
+	}
+}
+
+void PropertyTable::CompactValues() {
+	if (valuesGarbage == 0)
+		return;
+	std::vector<char> compacted;
+	compacted.reserve(values.size() - valuesGarbage);
+	for (size_t i = 0; i < slots.size(); i++) {
+		if (slots[i].key) {
+			const size_t start = compacted.size();
+			compacted.insert(compacted.end(), values.begin() + slots[i].valueStart,
+				values.begin() + slots[i].valueStart + slots[i].valueLength + 1);
+			slots[i].valueStart = start;
+		}
+	}
+	values.swap(compacted);
+	valuesGarbage = 0;
+}
+
+void PropertyTable::StoreValue(Slot &slot, const char *val, size_t lenVal) {
+	if (!values.empty() && (val >= &values[0]) && (val < &values[0] + values.size())) {
+		// Copy a value from this table first as inserting may move the values
+		const std::string copy(val, lenVal);
+		StoreValue(slot, copy.c_str(), lenVal);
+		return;
+	}
+	slot.valueStart = values.size();
+	slot.valueLength = lenVal;
+	values.insert(values.end(), val, val + lenVal);
+	values.push_back('\0');
+}
+
+/// The value of @a key or 0 when it is not in the table.
+const char *PropertyTable::Find(const char *key, size_t len, size_t *lenValue) const {
+	const Slot &slot = slots[Probe(key, len, HashKey(key, len))];
+	if (!slot.key)
+		return 0;
+	if (lenValue)
+		*lenValue = slot.valueLength;
+	return &values[slot.valueStart];
+}
+
+/// Returns true if the key was added or its value changed.
+bool PropertyTable::Set(const char *key, size_t lenKey, const char *val, size_t lenVal) {
+	const unsigned int hash = HashKey(key, lenKey);
+	size_t i = Probe(key, lenKey, hash);
+	if (slots[i].key) {
+		if ((slots[i].valueLength == lenVal) && (memcmp(&values[slots[i].valueStart], val, lenVal) == 0))
+			return false;
+		valuesGarbage += slots[i].valueLength + 1;
+		StoreValue(slots[i], val, lenVal);
+		if (valuesGarbage > values.size() / 2)
+			CompactValues();
+		return true;
+	}
+	if ((used + 1) * 2 > slots.size()) {
+		Grow();
+		i = Probe(key, lenKey, hash);
+	}
+	slots[i].key = keyPool.Intern(key, lenKey, hash);
+	StoreValue(slots[i], val, lenVal);
+	used++;
+	if (sortedValid)
+		sorted.insert(sorted.begin() + LowerBound(key, lenKey), slots[i].key);
+	return true;
+}
+
+/// Returns true if the key was in the table.
+bool PropertyTable::Remove(const char *key, size_t len) {
+	size_t i = Probe(key, len, HashKey(key, len));
+	if (!slots[i].key)
+		return false;
+	if (sortedValid)
+		sorted.erase(sorted.begin() + LowerBound(key, len));
+	const PropertyKey *removed = slots[i].key;
+	valuesGarbage += slots[i].valueLength + 1;
+	slots[i].key = 0;
+	used--;
+	// Move later entries of the cluster back so that no probe stops early
+	const size_t mask = slots.size() - 1;
+	for (size_t j = (i + 1) & mask; slots[j].key; j = (j + 1) & mask) {
+		const size_t home = slots[j].key->hash & mask;
+		const bool homeAfterGap = (i <= j) ? ((i < home) && (home <= j)) : ((i < home) || (home <= j));
+		if (!homeAfterGap) {
+			slots[i] = slots[j];
+			slots[j].key = 0;
+			i = j;
+		}
+	}
+	if (valuesGarbage > values.size() / 2)
+		CompactValues();
+	keyPool.Release(removed);
+	return true;
+}
+
+static bool KeyLess(const PropertyKey *a, const PropertyKey *b) {
+	return a->name < b->name;
+}
+
+/// Position in key order of the first key not less than @a key.
+size_t PropertyTable::LowerBound(const char *key, size_t len) const {
+	if (!sortedValid) {
+		sorted.clear();
+		for (size_t i = 0; i < slots.size(); i++) {
+			if (slots[i].key)
+				sorted.push_back(slots[i].key);
+		}
+		std::sort(sorted.begin(), sorted.end(), KeyLess);
+		sortedValid = true;
+	}
+	size_t low = 0;
+	size_t high = sorted.size();
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		const std::string &name = sorted[middle]->name;
+		if (name.compare(0, std::string::npos, key, len) < 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return low;
+}
+
+const std::string &PropertyTable::KeyAt(size_t position) const {
+	return sorted[position]->name;
 }
 
-PropSetFile::PropSetFile(const PropSetFile &copy) : lowerKeys(copy.lowerKeys), props(copy.props), superPS(copy.superPS) {
+const char *PropertyTable::ValueAt(size_t position) const {
+	const PropertyKey *pk = sorted[position];
+	return &values[slots[Probe(pk->name.c_str(), pk->name.length(), pk->hash)].valueStart];
+}
+
+/**
+ * The patterns of the keys starting with a keybase in a chain of property sets,
+ * compiled so that the value for a file name is found without matching every pattern.
+ * Whole file names and "*.ext" patterns are looked up in maps and only the remaining
+ * patterns are matched in turn. Each key is an entry numbered in the order GetWild
+ * searched them and the lowest numbered entry that matches wins.
+ */
+class WildIndex {
+	struct Pattern {
+		size_t entry;
+		std::string pattern;
+		Pattern(size_t entry_, const std::string &pattern_) : entry(entry_), pattern(pattern_) {
+		}
+	};
+	std::map<std::string, size_t> names;
+	std::map<std::string, size_t> extensions;
+	std::vector<Pattern> patterns;
+	std::vector<std::string> values;	///< Value of each entry
+	bool hasDefault;	///< The last entry is the keybase itself which matches every file name
+	std::string Folded(const char *s, size_t len) const;
+	void AddPattern(size_t entry, const char *pattern, size_t len);
+public:
+	unsigned int built;	///< wildStamp when built
+	mutable unsigned int generation;	///< wildGeneration when last known valid
+	bool caseSensitive;
+	std::vector<const PropSetFile *> chain;
+	std::vector<std::string> keysWatched;
+	std::vector<std::string> prefixesWatched;
+
+	WildIndex(bool caseSensitive_) :
+		hasDefault(false), built(wildStamp), generation(wildGeneration), caseSensitive(caseSensitive_) {
+	}
+	bool HasDefault() const {
+		return hasDefault;
+	}
+	bool IsValidFor(const PropSetFile *psStart, bool caseSensitive_) const;
+	void AddKey(const char *keyPatterns, const std::string &value);
+	void AddDefault(const std::string &value);
+	SString Find(const char *filename) const;
+};
+
+/// Note the keys whose values differ between two tables, both walked in key order.
+static void NoteDifferences(const PropertyTable &a, const PropertyTable &b) {
+	size_t posA = a.LowerBound("", 0);
+	size_t posB = b.LowerBound("", 0);
+	while ((posA < a.Count()) || (posB < b.Count())) {
+		int comparison;
+		if (posA >= a.Count())
+			comparison = 1;
+		else if (posB >= b.Count())
+			comparison = -1;
+		else
+			comparison = a.KeyAt(posA).compare(b.KeyAt(posB));
+		if (comparison < 0) {
+			NoteChange(a.KeyAt(posA++));
+		} else if (comparison > 0) {
+			NoteChange(b.KeyAt(posB++));
+		} else {
+			if (strcmp(a.ValueAt(posA), b.ValueAt(posB)) != 0)
+				NoteChange(a.KeyAt(posA));
+			posA++;
+			posB++;
+		}
+	}
+}
+
+/// Whether two tables hold the same keys and values.
+static bool SameEntries(const PropertyTable &a, const PropertyTable &b) {
+	if (&a == &b)
+		return true;
+	if (a.Count() != b.Count())
+		return false;
+	b.LowerBound("", 0);
+	for (size_t position = a.LowerBound("", 0); position < a.Count(); position++) {
+		if ((a.KeyAt(position) != b.KeyAt(position)) || (strcmp(a.ValueAt(position), b.ValueAt(position)) != 0))
+			return false;
+	}
+	return true;
+}
+
+PropSetFile::PropSetFile(bool lowerKeys_) : lowerKeys(lowerKeys_), table(new PropertyTable()), changes(++changeStamp),
+	indexed(false), manifest(0), keysDeferred(0), order(0), superPS(0) {
+}
+
+PropSetFile::PropSetFile(const PropSetFile &copy) : lowerKeys(copy.lowerKeys), table(copy.table), changes(++changeStamp),
+	indexed(false), deferredImports(copy.deferredImports), manifest(0), keysDeferred(0),
+	order(copy.order), keyOrder(copy.keyOrder), superPS(copy.superPS) {
+	table->references++;
 }
 
 PropSetFile::~PropSetFile() {
 	superPS = 0;
 	Clear();
+	ReleaseTable();
+	for (std::map<std::string, WildIndex *>::iterator it = wildIndexes.begin(); it != wildIndexes.end(); ++it)
+		delete it->second;
+	// Another set made at the same address must not match the chains of indexes including this
+	// one. Expansions check the changes of their chain which are never reused.
+	if (indexed)
+		InvalidateWildIndexes();
 }
 
+/**
+ * Copying a set, such as when switching buffers, only discards what was derived from
+ * it when the contents differ.
+ */
 PropSetFile &PropSetFile::operator=(const PropSetFile &assign) {
 	if (this != &assign) {
 		lowerKeys = assign.lowerKeys;
 		superPS = assign.superPS;
-		props = assign.props;
+		if (table != assign.table) {
+			if (!SameEntries(*table, *assign.table)) {
+				NoteChanged();
+				if (indexed)
+					NoteDifferences(*table, *assign.table);
+			}
+			ReleaseTable();
+			table = assign.table;
+			table->references++;
+		}
+		deferredImports = assign.deferredImports;
+		order = assign.order;
+		keyOrder = assign.keyOrder;
 	}
 	return *this;
 }
 
+void PropSetFile::NoteChanged() {
+	changes = ++changeStamp;
+}
+
+void PropSetFile::ReleaseTable() {
+	if (--table->references == 0)
+		delete table;
+	table = 0;
+}
+
+/// Copy the table before changing it if it is shared with other property sets.
+void PropSetFile::Unshare() {
+	if (table->references > 1) {
+		PropertyTable *copy = new PropertyTable(*table);
+		table->references--;
+		table = copy;
+	}
+}
+
 void PropSetFile::Set(const char *key, const char *val, ptrdiff_t lenKey, ptrdiff_t lenVal) {
 	if (!*key)	// Empty keys are not supported
 		return;
@@ -103,7 +584,17 @@ void PropSetFile::Set(const char *key, const char *val, ptrdiff_t lenKey, ptrdif
 		lenKey = static_cast<int>(strlen(key));
 	if (lenVal == -1)
 		lenVal = static_cast<int>(strlen(val));
-	props[std::string(key, lenKey)] = std::string(val, lenVal);
+	if (order)
+		keyOrder[std::string(key, lenKey)] = order;
+	size_t lenExisting = 0;
+	const char *existing = table->Find(key, lenKey, &lenExisting);
+	if (existing && (lenExisting == static_cast<size_t>(lenVal)) && (memcmp(existing, val, lenVal) == 0))
+		return;
+	Unshare();
+	table->Set(key, lenKey, val, lenVal);
+	NoteChanged();
+	if (indexed)
+		NoteChange(std::string(key, lenKey));
 }
 
 void PropSetFile::Set(const char *keyVal) {
@@ -125,9 +616,15 @@ void PropSetFile::Unset(const char *key, int lenKey) {
 		return;
 	if (lenKey == -1)
 		lenKey = static_cast<int>(strlen(key));
-	mapss::iterator keyPos = props.find(std::string(key, lenKey));
-	if (keyPos != props.end())
-		props.erase(keyPos);
+	if (order)
+		keyOrder[std::string(key, lenKey)] = order;
+	if (!table->Find(key, lenKey))
+		return;
+	Unshare();
+	table->Remove(key, lenKey);
+	NoteChanged();
+	if (indexed)
+		NoteChange(std::string(key, lenKey));
 }
 
 void PropSetFile::SetMultiple(const char *s) {
@@ -141,26 +638,27 @@ void PropSetFile::SetMultiple(const char *s) {
 }
 
 bool PropSetFile::Exists(const char *key) const {
-	mapss::const_iterator keyPos = props.find(std::string(key));
-	if (keyPos != props.end()) {
-		return true;
-	} else {
-		if (superPS) {
-			// Failed here, so try in base property set
-			return superPS->Exists(key);
-		} else {
-			return false;
-		}
+	if (readsRecorded)
+		readsRecorded->AddKey(key);
+	const size_t lenKey = strlen(key);
+	for (const PropSetFile *psf = this; psf; psf = psf->superPS) {
+		if (psf->table->Find(key, lenKey))
+			return true;
+		// Failed here, so try in base property set
 	}
+	return false;
 }
 
 SString PropSetFile::Get(const char *key) const {
-	const std::string sKey(key);
+	if (readsRecorded)
+		readsRecorded->AddKey(key);
+	const size_t lenKey = strlen(key);
 	const PropSetFile *psf = this;
 	while (psf) {
-		mapss::const_iterator keyPos = psf->props.find(sKey);
-		if (keyPos != psf->props.end()) {
-			return SString(keyPos->second.c_str());
+		size_t lenVal = 0;
+		const char *val = psf->table->Find(key, lenKey, &lenVal);
+		if (val) {
+			return SString(val, 0, lenVal);
 		}
 		// Failed here, so try in base property set
 		psf = psf->superPS;
@@ -204,24 +702,29 @@ static SString ShellEscape(const char *toEscape) {
 }
 
 SString PropSetFile::Evaluate(const char *key) const {
+	if (keysEvaluated)
+		keysEvaluated->insert(key);
 	if (strchr(key, ' ')) {
 		if (isprefix(key, "escape ")) {
 			SString val = Get(key+7);
 			return ShellEscape(val.c_str());
 		} else if (isprefix(key, "star ")) {
 			const std::string sKeybase(key + 5);
+			if (readsRecorded)
+				readsRecorded->AddPrefix(sKeybase.c_str());
 			// Create set of variables with values
 			mapss values;
 			// For this property set and all base sets
 			for (const PropSetFile *psf = this; psf; psf = psf->superPS) {
-				mapss::const_iterator it = psf->props.lower_bound(sKeybase);
-				while ((it != psf->props.end()) && (it->first.find(sKeybase) == 0)) {
-					mapss::iterator itDestination = values.find(it->first);
+				const PropertyTable &props = *psf->table;
+				size_t position = props.LowerBound(sKeybase.c_str(), sKeybase.length());
+				while ((position < props.Count()) && (props.KeyAt(position).compare(0, sKeybase.length(), sKeybase) == 0)) {
+					mapss::iterator itDestination = values.find(props.KeyAt(position));
 					if (itDestination == values.end()) {
 						// Not present so add
-						values[it->first] = it->second;
+						values[props.KeyAt(position)] = props.ValueAt(position);
 					}
-					++it;
+					++position;
 				}
 			}
 			// Concatenate all variables
@@ -254,52 +757,131 @@ struct VarChain {
 	const VarChain *link;
 };
 
-static int ExpandAllInPlace(const PropSetFile &props, SString &withVars, int maxExpands, const VarChain &blankVars = VarChain()) {
-	int varStart = withVars.search("$(");
-	while ((varStart >= 0) && (maxExpands > 0)) {
-		int varEnd = withVars.search(")", varStart+2);
-		if (varEnd < 0) {
+typedef std::vector<std::pair<std::string, std::string> > VariableReads;
+
+/// Record the lookups Evaluate made for @a reads without making them again.
+static void RecordEvaluated(const VariableReads &reads) {
+	for (VariableReads::const_iterator it = reads.begin(); it != reads.end(); ++it) {
+		const char *var = it->first.c_str();
+		if (isprefix(var, "escape "))
+			readsRecorded->AddKey(var + 7);
+		else if (isprefix(var, "star "))
+			readsRecorded->AddPrefix(var + 5);
+		else if (!strchr(var, ' '))
+			readsRecorded->AddKey(var);
+	}
+}
+
+static int ExpandAllInPlace(const PropSetFile &props, std::string &withVars, int maxExpands,
+	const VarChain &blankVars = VarChain(), VariableReads *reads = 0) {
+	size_t varStart = withVars.find("$(");
+	while ((varStart != std::string::npos) && (maxExpands > 0)) {
+		const size_t varEnd = withVars.find(')', varStart+2);
+		if (varEnd == std::string::npos) {
 			break;
 		}
 
 		// For consistency, when we see '$(ab$(cde))', expand the inner variable first,
 		// regardless whether there is actually a degenerate variable named 'ab$(cde'.
-		int innerVarStart = withVars.search("$(", varStart+2);
-		while ((innerVarStart > varStart) && (innerVarStart < varEnd)) {
+		size_t innerVarStart = withVars.find("$(", varStart+2);
+		while ((innerVarStart != std::string::npos) && (innerVarStart < varEnd)) {
 			varStart = innerVarStart;
-			innerVarStart = withVars.search("$(", varStart+2);
+			innerVarStart = withVars.find("$(", varStart+2);
 		}
 
-		SString var(withVars.c_str(), varStart + 2, varEnd);
-		SString val = props.Evaluate(var.c_str());
+		const std::string var(withVars, varStart + 2, varEnd - varStart - 2);
+		std::string val = props.Evaluate(var.c_str()).c_str();
+		if (reads)
+			reads->push_back(std::make_pair(var, val));
 
 		if (blankVars.contains(var.c_str())) {
 			val.clear(); // treat blankVar as an empty string (e.g. to block self-reference)
 		}
 
 		if (--maxExpands >= 0) {
-			maxExpands = ExpandAllInPlace(props, val, maxExpands, VarChain(var.c_str(), &blankVars));
+			maxExpands = ExpandAllInPlace(props, val, maxExpands, VarChain(var.c_str(), &blankVars), reads);
 		}
 
-		withVars.remove(varStart, varEnd-varStart+1);
-		withVars.insert(varStart, val.c_str(), val.length());
+		withVars.replace(varStart, varEnd-varStart+1, val);
 
-		varStart = withVars.search("$(");
+		varStart = withVars.find("$(");
 	}
 
 	return maxExpands;
 }
 
+/**
+ * Find a result of an earlier expansion with the same arguments made from the same raw
+ * value. Results are discarded when the chain of property sets is different.
+ */
+PropertyExpansion *PropSetFile::FindExpansion(const std::string &key, const char *raw) const {
+	if (!ChainMatches(this, expansionsChain)) {
+		expansions.clear();
+		expansionsChain.clear();
+		for (const PropSetFile *psf = this; psf; psf = psf->superPS)
+			expansionsChain.push_back(psf);
+		return 0;
+	}
+	std::map<std::string, PropertyExpansion>::iterator it = expansions.find(key);
+	if ((it == expansions.end()) || (it->second.raw != raw))
+		return 0;
+	return &it->second;
+}
+
+bool PropSetFile::ChainUnchanged(const std::vector<unsigned int> &chainChanges) const {
+	size_t position = 0;
+	for (const PropSetFile *psf = this; psf; psf = psf->superPS, position++) {
+		if ((position >= chainChanges.size()) || (chainChanges[position] != psf->changes))
+			return false;
+	}
+	return position == chainChanges.size();
+}
+
+void PropSetFile::ChainChanges(std::vector<unsigned int> &chainChanges) const {
+	chainChanges.clear();
+	for (const PropSetFile *psf = this; psf; psf = psf->superPS)
+		chainChanges.push_back(psf->changes);
+}
+
+/**
+ * An expansion is still valid when no set in the chain has changed. Otherwise, or while
+ * building a wildcard index, each variable is looked up again and the expansion is kept
+ * if all have the same values, so changes to unrelated keys such as those of the status
+ * bar do not cause everything to be expanded again.
+ */
 SString PropSetFile::GetExpanded(const char *key) const {
 	SString val = Get(key);
-	ExpandAllInPlace(*this, val, 100, VarChain(key));
-	return val;
+	if (val.search("$(") < 0)
+		return val;
+	const std::string sKey(key);
+	PropertyExpansion *expansion = FindExpansion(sKey, val.c_str());
+	if (expansion) {
+		if (!keysEvaluated && ChainUnchanged(expansion->changes)) {
+			if (readsRecorded)
+				RecordEvaluated(expansion->reads);
+			return SString(expansion->value.c_str());
+		}
+		bool same = true;
+		for (VariableReads::const_iterator it = expansion->reads.begin(); same && (it != expansion->reads.end()); ++it)
+			same = it->second == Evaluate(it->first.c_str()).c_str();
+		if (same) {
+			ChainChanges(expansion->changes);
+			return SString(expansion->value.c_str());
+		}
+	}
+	PropertyExpansion &result = expansions[sKey];
+	result.raw = val.c_str();
+	result.value = result.raw;
+	result.reads.clear();
+	ExpandAllInPlace(*this, result.value, 100, VarChain(key), &result.reads);
+	ChainChanges(result.changes);
+	return SString(result.value.c_str());
 }
 
 SString PropSetFile::Expand(const char *withVars, int maxExpands) const {
-	SString val = withVars;
+	std::string val = withVars;
 	ExpandAllInPlace(*this, val, maxExpands);
-	return val;
+	return SString(val.c_str());
 }
 
 int PropSetFile::GetInt(const char *key, int defaultValue) const {
@@ -323,15 +905,25 @@ static bool isPrefix(const char *target, const char *prefix) {
 }
 
 void PropSetFile::Clear() {
-	props.clear();
+	if (!table->Empty()) {
+		NoteChanged();
+		PropertyTable *cleared = new PropertyTable();
+		if (indexed)
+			NoteDifferences(*table, *cleared);
+		ReleaseTable();
+		table = cleared;
+	}
+	deferredImports.clear();
+	order = 0;
+	keyOrder.clear();
 }
 
 char *PropSetFile::ToString() const {
 	std::string sval;
-	for (mapss::const_iterator it=props.begin(); it != props.end(); ++it) {
-		sval += it->first;
+	for (size_t position = table->LowerBound("", 0); position < table->Count(); position++) {
+		sval += table->KeyAt(position);
 		sval += "=";
-		sval += it->second;
+		sval += table->ValueAt(position);
 		sval += "\n";
 	}
 	char *ret = new char [sval.size() + 1];
@@ -398,6 +990,118 @@ static bool GenericPropertiesFile(const FilePath &filename) {
 	return name.find("SciTE") != std::string::npos;
 }
 
+/// Length of the key set by a line as Set(const char *keyVal) would find it.
+static size_t KeyLength(const char *&line) {
+	while (IsASpace(*line))
+		line++;
+	const char *endKey = line;
+	while (*endKey && (*endKey != '=') && (*endKey != '\n'))
+		endKey++;
+	return endKey - line;
+}
+
+/// Settings read from every language file, even when the rest of the file is deferred.
+static bool IsManifestKey(const char *key, size_t lenKey) {
+	static const char *prefixes[] = { "file.patterns.", "lexer.", "shbang.", "filter.", "*" };
+	for (size_t i = 0; i < sizeof(prefixes) / sizeof(prefixes[0]); i++) {
+		const size_t lenPrefix = strlen(prefixes[i]);
+		if ((lenKey >= lenPrefix) && (strncmp(key, prefixes[i], lenPrefix) == 0))
+			return true;
+	}
+	return false;
+}
+
+static bool ReadFileData(const FilePath &filename, std::vector<char> &data) {
+	FILE *rcfile = filename.Open(fileRead);
+	if (!rcfile)
+		return false;
+	fseek(rcfile, 0, SEEK_END);
+	long sizeFile = ftell(rcfile);
+	fseek(rcfile, 0, SEEK_SET);
+	data.resize(sizeFile > 0 ? sizeFile : 0);
+	if (!data.empty())
+		data.resize(fread(&data[0], 1, data.size(), rcfile));
+	fclose(rcfile);
+	if ((data.size() >= 3) && (memcmp(&data[0], "\xef\xbb\xbf", 3) == 0))
+		data.erase(data.begin(), data.begin() + 3);
+	return true;
+}
+
+/// Append the lines of @a data to @a lines with continuations joined, each followed by a NUL.
+static void SplitLines(const char *data, size_t len, std::vector<char> &lines) {
+	char lineBuffer[60000];
+	while (len > 0) {
+		GetFullLine(data, len, lineBuffer, sizeof(lineBuffer));
+		lines.insert(lines.end(), lineBuffer, lineBuffer + strlen(lineBuffer) + 1);
+	}
+}
+
+/**
+ * Read a properties file as lines ready for PropSetFile::ReadLines.
+ * Only reads the file so may be called on any thread.
+ */
+bool ReadPropertiesLines(const FilePath &filename, std::vector<char> &lines) {
+	lines.clear();
+	std::vector<char> data;
+	if (!ReadFileData(filename, data))
+		return false;
+	SplitLines(data.empty() ? "" : &data[0], data.size(), lines);
+	return true;
+}
+
+/// Read the lines of a file, taking them from the prefetch when it has read the file.
+static bool ReadImportLines(const FilePath &filename, const ImportFilter &filter, std::vector<char> &lines) {
+	bool exists = false;
+	if (filter.prefetch && filter.prefetch->Take(filename, lines, exists))
+		return exists;
+	return ReadPropertiesLines(filename, lines);
+}
+
+/// Ask the prefetch to start reading the files named by "import" lines so they are ready when reached.
+static void RequestImports(const std::vector<char> &lines, FilePath directoryForImports, const ImportFilter &filter) {
+	if (!filter.prefetch || !directoryForImports.IsSet())
+		return;
+	for (size_t pos = 0; pos < lines.size(); pos += strlen(&lines[pos]) + 1) {
+		const char *line = &lines[pos];
+		if (isPrefix(line, "import ")) {
+			SString importName(line + strlen("import") + 1);
+			if ((importName != "*") && filter.IsValid(importName.c_str())) {
+				importName += ".properties";
+				filter.prefetch->Request(FilePath(directoryForImports, FilePath(GUI::StringFromUTF8(importName.c_str()))));
+			}
+		}
+	}
+}
+
+/// Add the names referenced as $(name) in @a data that are not defined by @a props.
+static void AddUndefinedReferences(const std::vector<char> &data, const PropSetFile &props,
+	std::set<std::string> &names) {
+	const std::string text(data.begin(), data.end());
+	size_t start = text.find("$(");
+	while (start != std::string::npos) {
+		const size_t end = text.find_first_of(") \t\r\n$", start + 2);
+		if ((end != std::string::npos) && (text[end] == ')') && (end > start + 2)) {
+			const std::string name = text.substr(start + 2, end - start - 2);
+			if (!props.Exists(name.c_str()))
+				names.insert(name);
+		}
+		start = text.find("$(", start + 2);
+	}
+}
+
+static bool DefinesAny(const DeferredImport &deferred, const std::set<std::string> &names) {
+	for (std::set<std::string>::const_iterator it = names.begin(); it != names.end(); ++it) {
+		if (deferred.keys.find("\n" + *it + "\n") != std::string::npos)
+			return true;
+	}
+	return false;
+}
+
+/// Name of a file for the startup profile, only found when profiling.
+static std::string ProfileDetail(const FilePath &filename) {
+	return StartupProfile::Enabled() ? filename.AsUTF8() : std::string();
+}
+
 void PropSetFile::Import(FilePath filename, FilePath directoryForImports, const ImportFilter &filter, std::vector<FilePath> *imports) {
 	if (Read(filename, directoryForImports, filter, imports)) {
 		if (imports && (std::find(imports->begin(),imports->end(), filename) == imports->end())) {
@@ -406,6 +1110,100 @@ void PropSetFile::Import(FilePath filename, FilePath directoryForImports, const
 	}
 }
 
+/**
+ * Read only the settings of a language file that choose a language and defer the rest
+ * until one of its lexers is needed. Files that choose no lexer are read completely.
+ */
+void PropSetFile::ImportManifest(FilePath filename, FilePath directoryForImports, const ImportFilter &filter, std::vector<FilePath> *imports) {
+	StartupPhase phase("ImportManifest", ProfileDetail(filename).c_str());
+	std::vector<char> lines;
+	if (!ReadImportLines(filename, filter, lines))
+		return;
+	DeferredImport deferred;
+	deferred.path = filename;
+	deferred.directoryForImports = directoryForImports;
+	deferred.keys = "\n";
+	deferred.order = order + 1;
+	manifest = &deferred;
+	ReadLines(lines, directoryForImports, filter, imports);
+	manifest = 0;
+	if (deferred.lexers.empty()) {
+		RequestImports(lines, directoryForImports, filter);
+		ReadLines(lines, directoryForImports, filter, imports);
+	} else {
+		AddDeferredImport(deferred);
+	}
+	if (imports && (std::find(imports->begin(),imports->end(), filename) == imports->end())) {
+		imports->push_back(filename);
+	}
+}
+
+void PropSetFile::AddDeferredImport(const DeferredImport &deferred) {
+	deferredImports.push_back(deferred);
+	if (order < deferred.order)
+		order = deferred.order;
+}
+
+void PropSetFile::SetKeyOrder(const std::string &key, size_t order_) {
+	keyOrder[key] = order_;
+}
+
+/**
+ * Read a deferred language file as if at its place in "import *": its settings replace
+ * those made before that place but not those made after it, which come later when all
+ * files are read at once.
+ */
+void PropSetFile::ReadDeferred(const DeferredImport &deferred, const std::vector<char> &data, const ImportFilter &filter) {
+	StartupPhase phase("ImportDeferred", ProfileDetail(deferred.path).c_str());
+	std::set<std::string> keysRead;
+	keysDeferred = &keysRead;
+	const size_t orderCurrent = order;
+	order = deferred.order;
+	// Files it imports are read now as they would have been at that place
+	ImportFilter filterEager = filter;
+	filterEager.lazy = false;
+	ReadFromMemory(data.empty() ? "" : &data[0], data.size(), deferred.directoryForImports, filterEager);
+	order = orderCurrent;
+	keysDeferred = 0;
+}
+
+/**
+ * Read the deferred language files that choose @a lexer and then any other deferred
+ * files defining properties that the files read refer to but are not yet defined.
+ * Returns true if any file was read.
+ */
+bool PropSetFile::ImportDeferred(const char *lexer, const ImportFilter &filter) {
+	bool imported = false;
+	std::set<std::string> wanted;
+	bool found = true;
+	while (found) {
+		found = false;
+		for (size_t i = 0; i < deferredImports.size();) {
+			if ((deferredImports[i].lexers.count(lexer) > 0) || DefinesAny(deferredImports[i], wanted)) {
+				const DeferredImport deferred = deferredImports[i];
+				deferredImports.erase(deferredImports.begin() + i);
+				std::vector<char> data;
+				ReadFileData(deferred.path, data);
+				ReadDeferred(deferred, data, filter);
+				AddUndefinedReferences(data, *this, wanted);
+				found = true;
+				imported = true;
+			} else {
+				i++;
+			}
+		}
+		for (std::set<std::string>::iterator it = wanted.begin(); it != wanted.end();) {
+			if (Exists(it->c_str()))
+				wanted.erase(it++);
+			else
+				++it;
+		}
+		if (wanted.empty())
+			break;
+	}
+	return imported;
+}
+
 bool PropSetFile::ReadLine(const char *lineBuffer, bool ifIsTrue, FilePath directoryForImports,
                            const ImportFilter &filter, std::vector<FilePath> *imports) {
 	//UnSlash(lineBuffer);
@@ -413,7 +1211,11 @@ bool PropSetFile::ReadLine(const char *lineBuffer, bool ifIsTrue, FilePath direc
 		ifIsTrue = true;
 	if (isPrefix(lineBuffer, "if ")) {
 		const char *expr = lineBuffer + strlen("if") + 1;
+		if (conditionsRead)
+			conditionsRead->insert(expr);
 		ifIsTrue = GetInt(expr) != 0;
+	} else if (isPrefix(lineBuffer, "import ") && manifest) {
+		// Imports are made when the rest of the file is read
 	} else if (isPrefix(lineBuffer, "import ") && directoryForImports.IsSet()) {
 		SString importName(lineBuffer + strlen("import") + 1);
 		if (importName == "*") {
@@ -421,65 +1223,106 @@ bool PropSetFile::ReadLine(const char *lineBuffer, bool ifIsTrue, FilePath direc
 			FilePathSet directories;
 			FilePathSet files;
 			directoryForImports.List(directories, files);
+			std::vector<FilePath> importPaths;
 			for (size_t i = 0; i < files.size(); i ++) {
 				FilePath fpFile = files[i];
 				if (IsPropertiesFile(fpFile) &&
 					!GenericPropertiesFile(fpFile) &&
 					filter.IsValid(fpFile.BaseName().AsUTF8())) {
-					FilePath importPath(directoryForImports, fpFile);
-					Import(importPath, directoryForImports, filter, imports);
+					importPaths.push_back(FilePath(directoryForImports, fpFile));
 				}
 			}
+			if (filter.prefetch) {
+				for (size_t p = 0; p < importPaths.size(); p++)
+					filter.prefetch->Request(importPaths[p]);
+			}
+			for (size_t j = 0; j < importPaths.size(); j++) {
+				if (filter.lazy)
+					ImportManifest(importPaths[j], directoryForImports, filter, imports);
+				else
+					Import(importPaths[j], directoryForImports, filter, imports);
+			}
 		} else if (filter.IsValid(importName.c_str())) {
 			importName += ".properties";
 			FilePath importPath(directoryForImports, FilePath(GUI::StringFromUTF8(importName.c_str())));
 			Import(importPath, directoryForImports, filter, imports);
 		}
 	} else if (ifIsTrue && !IsCommentLine(lineBuffer)) {
+		if (manifest || keysDeferred) {
+			const char *key = lineBuffer;
+			const size_t lenKey = KeyLength(key);
+			const std::string sKey(key, lenKey);
+			if (manifest) {
+				if (!IsManifestKey(key, lenKey)) {
+					manifest->keys += sKey;
+					manifest->keys += '\n';
+					return ifIsTrue;
+				}
+				if (isPrefix(sKey.c_str(), "lexer.")) {
+					const char *eqAt = strchr(key, '=');
+					manifest->lexers.insert(eqAt ? eqAt + 1 : "1");
+				}
+			} else if (!keysDeferred->count(sKey)) {
+				std::map<std::string, size_t>::const_iterator it = keyOrder.find(sKey);
+				if ((it != keyOrder.end()) && (it->second >= order))
+					return ifIsTrue;	// Set after this file's place so that setting wins
+				keysDeferred->insert(sKey);
+			}
+		}
 		Set(lineBuffer);
 	}
 	return ifIsTrue;
 }
 
-void PropSetFile::ReadFromMemory(const char *data, size_t len, FilePath directoryForImports,
-                                 const ImportFilter &filter, std::vector<FilePath> *imports) {
-	const char *pd = data;
-	char lineBuffer[60000];
+/// Read the lines produced by SplitLines in order.
+void PropSetFile::ReadLines(const std::vector<char> &lines, FilePath directoryForImports,
+                            const ImportFilter &filter, std::vector<FilePath> *imports) {
 	bool ifIsTrue = true;
-	while (len > 0) {
-		GetFullLine(pd, len, lineBuffer, sizeof(lineBuffer));
+	std::string lineLowered;
+	for (size_t pos = 0; pos < lines.size();) {
+		const char *line = &lines[pos];
+		const size_t lenLine = strlen(line);
+		pos += lenLine + 1;
 		if (lowerKeys) {
-			for (int i=0; lineBuffer[i] && (lineBuffer[i] != '='); i++) {
-				if ((lineBuffer[i] >= 'A') && (lineBuffer[i] <= 'Z')) {
-					lineBuffer[i] = static_cast<char>(lineBuffer[i] - 'A' + 'a');
+			lineLowered.assign(line, lenLine);
+			for (size_t i=0; (i < lenLine) && (lineLowered[i] != '='); i++) {
+				if ((lineLowered[i] >= 'A') && (lineLowered[i] <= 'Z')) {
+					lineLowered[i] = static_cast<char>(lineLowered[i] - 'A' + 'a');
 				}
 			}
+			line = lineLowered.c_str();
 		}
-		ifIsTrue = ReadLine(lineBuffer, ifIsTrue, directoryForImports, filter, imports);
+		ifIsTrue = ReadLine(line, ifIsTrue, directoryForImports, filter, imports);
 	}
 }
 
+void PropSetFile::ReadFromMemory(const char *data, size_t len, FilePath directoryForImports,
+                                 const ImportFilter &filter, std::vector<FilePath> *imports) {
+	std::vector<char> lines;
+	SplitLines(data, len, lines);
+	ReadLines(lines, directoryForImports, filter, imports);
+}
+
 bool PropSetFile::Read(FilePath filename, FilePath directoryForImports,
                        const ImportFilter &filter, std::vector<FilePath> *imports) {
-	FILE *rcfile = filename.Open(fileRead);
-	if (rcfile) {
-		fseek(rcfile, 0, SEEK_END);
-		long sizeFile = ftell(rcfile);
-		fseek(rcfile, 0, SEEK_SET);
-		std::vector<char> propsData(sizeFile);
-		int lenFile = static_cast<int>(fread(&propsData[0], 1, propsData.size(), rcfile));
-		fclose(rcfile);
-		const char *data = propsData.data();
-		if (memcmp(data, "\xef\xbb\xbf", 3) == 0) {
-			data += 3;
-			lenFile -= 3;
-		}
-		ReadFromMemory(data, lenFile, directoryForImports, filter, imports);
+	StartupPhase phase("ReadPropertiesFile", ProfileDetail(filename).c_str());
+	std::vector<char> lines;
+	if (ReadImportLines(filename, filter, lines)) {
+		RequestImports(lines, directoryForImports, filter);
+		ReadLines(lines, directoryForImports, filter, imports);
 		return true;
 	}
 	return false;
 }
 
+/**
+ * While @a conditions is set, add the property tested by each "if" line read to it
+ * so that callers can tell whether reading the same files again would differ.
+ */
+void PropSetFile::CollectConditions(std::set<std::string> *conditions) {
+	conditionsRead = conditions;
+}
+
 void PropSetFile::SetInteger(const char *key, int i) {
 	char tmp[32];
 	sprintf(tmp, "%d", static_cast<int>(i));
@@ -525,97 +1368,336 @@ static bool startswith(const std::string &s, const char *keybase) {
 	return isPrefix(s.c_str(), keybase);
 }
 
-SString PropSetFile::GetWildUsingStart(const PropSetFile &psStart, const char *keybase, const char *filename) {
+std::string WildIndex::Folded(const char *s, size_t len) const {
+	std::string folded(s, len);
+	if (!caseSensitive) {
+		for (size_t i = 0; i < len; i++)
+			folded[i] = MakeUpperCase(folded[i]);
+	}
+	return folded;
+}
+
+void WildIndex::AddPattern(size_t entry, const char *pattern, size_t len) {
+	const char *star = static_cast<const char *>(memchr(pattern, '*', len));
+	if (!star) {
+		// Only matches the whole file name. Earlier entries win so do not replace.
+		names.insert(std::pair<const std::string, size_t>(Folded(pattern, len), entry));
+	} else if ((star == pattern) && (len >= 2) && (pattern[1] == '.') &&
+		!memchr(pattern + 1, '*', len - 1) && !memchr(pattern + 2, '.', len - 2)) {
+		// "*.ext" matches when the file name's last '.' starts ".ext"
+		extensions.insert(std::pair<const std::string, size_t>(Folded(pattern + 1, len - 1), entry));
+	} else {
+		patterns.push_back(Pattern(entry, std::string(pattern, len)));
+	}
+}
+
+bool WildIndex::IsValidFor(const PropSetFile *psStart, bool caseSensitive_) const {
+	if ((caseSensitive != caseSensitive_) || !ChainMatches(psStart, chain))
+		return false;
+	if (generation != wildGeneration) {
+		if ((built < wildReset) || !WatchesUnchanged(wildKeys, keysWatched, built) ||
+			!WatchesUnchanged(wildPrefixes, prefixesWatched, built))
+			return false;
+		generation = wildGeneration;
+	}
+	return true;
+}
+
+/// Add a key with ';' separated patterns.
+void WildIndex::AddKey(const char *keyPatterns, const std::string &value) {
+	const size_t entry = values.size();
+	values.push_back(value);
+	for (;;) {
+		const char *del = strchr(keyPatterns, ';');
+		if (del == NULL)
+			del = keyPatterns + strlen(keyPatterns);
+		AddPattern(entry, keyPatterns, del - keyPatterns);
+		if (*del == '\0')
+			break;
+		keyPatterns = del + 1;
+	}
+}
+
+void WildIndex::AddDefault(const std::string &value) {
+	values.push_back(value);
+	hasDefault = true;
+}
+
+SString WildIndex::Find(const char *filename) const {
+	const size_t lenFileName = strlen(filename);
+	size_t best = values.size();
+	std::map<std::string, size_t>::const_iterator itName = names.find(Folded(filename, lenFileName));
+	if (itName != names.end())
+		best = itName->second;
+	const char *extension = strrchr(filename, '.');
+	if (extension) {
+		std::map<std::string, size_t>::const_iterator itExtension =
+			extensions.find(Folded(extension, filename + lenFileName - extension));
+		if ((itExtension != extensions.end()) && (itExtension->second < best))
+			best = itExtension->second;
+	}
+	for (std::vector<Pattern>::const_iterator it = patterns.begin();
+		(it != patterns.end()) && (it->entry < best); ++it) {
+		if (MatchWild(it->pattern.c_str(), it->pattern.length(), filename, caseSensitive)) {
+			best = it->entry;
+			break;
+		}
+	}
+	if (best < values.size())
+		return SString(values[best].c_str());
+	if (hasDefault)
+		return SString(values.back().c_str());
+	return "";
+}
+
+/**
+ * Return the compiled index for @a keybase, building it when there is none or
+ * the keys it was built from have changed.
+ */
+const WildIndex &PropSetFile::WildIndexFor(const char *keybase) {
 	const std::string sKeybase(keybase);
-	const size_t lenKeybase = strlen(keybase);
-	const PropSetFile *psf = this;
-	while (psf) {
-		mapss::const_iterator it = psf->props.lower_bound(sKeybase);
-		while ((it != psf->props.end()) && startswith(it->first, keybase)) {
-			const char *orgkeyfile = it->first.c_str() + lenKeybase;
-			char *keyptr = NULL;
+	std::map<std::string, WildIndex *>::iterator itIndex = wildIndexes.find(sKeybase);
+	if (itIndex != wildIndexes.end()) {
+		if (itIndex->second->IsValidFor(this, caseSensitiveFilenames))
+			return *itIndex->second;
+		delete itIndex->second;
+		wildIndexes.erase(itIndex);
+	}
 
-			if (strncmp(orgkeyfile, "$(", 2) == 0) {
+	WildIndex *index = new WildIndex(caseSensitiveFilenames);
+	std::set<std::string> evaluated;
+	keysEvaluated = &evaluated;
+	const size_t lenKeybase = sKeybase.length();
+	for (const PropSetFile *psf = this; psf; psf = psf->superPS) {
+		index->chain.push_back(psf);
+		psf->indexed = true;
+		const PropertyTable &props = *psf->table;
+		size_t position = props.LowerBound(keybase, lenKeybase);
+		while (!index->HasDefault() && (position < props.Count()) && startswith(props.KeyAt(position), keybase)) {
+			const std::string &key = props.KeyAt(position);
+			const char *orgkeyfile = key.c_str() + lenKeybase;
+			if (key.length() == lenKeybase) {
+				// Any later keys can not be reached
+				index->AddDefault(props.ValueAt(position));
+			} else if (strncmp(orgkeyfile, "$(", 2) == 0 && strchr(orgkeyfile, ')')) {
 				const char *cpendvar = strchr(orgkeyfile, ')');
-				if (cpendvar) {
-					SString var(orgkeyfile, 2, cpendvar-orgkeyfile);
-					SString s = psStart.GetExpanded(var.c_str());
-					keyptr = StringDup(s.c_str());
-				}
-			}
-			const char *keyfile = keyptr;
-
-			if (keyfile == NULL)
-				keyfile = orgkeyfile;
-
-			for (;;) {
-				const char *del = strchr(keyfile, ';');
-				if (del == NULL)
-					del = keyfile + strlen(keyfile);
-				if (MatchWild(keyfile, del - keyfile, filename, caseSensitiveFilenames)) {
-					delete []keyptr;
-					return SString(it->second.c_str());
-				}
-				if (*del == '\0')
-					break;
-				keyfile = del + 1;
+				SString var(orgkeyfile, 2, cpendvar-orgkeyfile);
+				evaluated.insert(var.c_str());
+				index->AddKey(GetExpanded(var.c_str()).c_str(), props.ValueAt(position));
+			} else {
+				index->AddKey(orgkeyfile, props.ValueAt(position));
 			}
-			delete []keyptr;
+			++position;
+		}
+	}
+	keysEvaluated = 0;
+
+	// Watch the keys the index depends on
+	Watch(wildPrefixes, sKeybase, index->prefixesWatched);
+	for (std::set<std::string>::const_iterator itKey = evaluated.begin(); itKey != evaluated.end(); ++itKey) {
+		if (isprefix(itKey->c_str(), "star "))
+			Watch(wildPrefixes, itKey->substr(5), index->prefixesWatched);
+		else if (isprefix(itKey->c_str(), "escape "))
+			Watch(wildKeys, itKey->substr(7), index->keysWatched);
+		else
+			Watch(wildKeys, *itKey, index->keysWatched);
+	}
+	wildIndexes[sKeybase] = index;
+	return *index;
+}
+
+SString PropSetFile::GetWild(const char *keybase, const char *filename) {
+	if (readsRecorded)
+		readsRecorded->AddWild(keybase, filename);
+	return WildIndexFor(keybase).Find(filename);
+}
+
+/**
+ * While @a reads is set, record the properties looked up in it.
+ * Returns the previous recorder so that it can be restored.
+ */
+PropertyReads *PropSetFile::RecordReads(PropertyReads *reads) {
+	PropertyReads *previous = readsRecorded;
+	readsRecorded = reads;
+	return previous;
+}
+
+/// Add the names referred to as $(name) in @a text to @a names.
+static void AddReferences(const std::string &text, std::vector<std::string> &names) {
+	size_t start = text.find("$(");
+	while (start != std::string::npos) {
+		const size_t end = text.find(')', start + 2);
+		if (end == std::string::npos)
+			break;
+		names.push_back(text.substr(start + 2, end - start - 2));
+		start = text.find("$(", end);
+	}
+}
+
+static bool RefersToAny(const std::vector<std::string> &references, const std::set<std::string> &keys) {
+	for (size_t r = 0; r < references.size(); r++) {
+		const std::string &reference = references[r];
+		if (isprefix(reference.c_str(), "star ")) {
+			const std::string prefix = reference.substr(5);
+			std::set<std::string>::const_iterator it = keys.lower_bound(prefix);
+			if ((it != keys.end()) && (it->compare(0, prefix.length(), prefix) == 0))
+				return true;
+		} else if (isprefix(reference.c_str(), "escape ")) {
+			if (keys.count(reference.substr(7)))
+				return true;
+		} else if (keys.count(reference)) {
+			return true;
+		}
+	}
+	return false;
+}
 
-			if (0 == strcmp(it->first.c_str(), keybase)) {
-				return SString(it->second.c_str());
+/**
+ * Add to @a keys the keys of this set and its base sets whose names or values
+ * refer to one of @a keys, directly or through other keys.
+ */
+void PropSetFile::AddReferrers(std::set<std::string> &keys) const {
+	std::vector<std::pair<std::string, std::vector<std::string> > > referring;
+	for (const PropSetFile *psf = this; psf; psf = psf->superPS) {
+		const PropertyTable &props = *psf->table;
+		for (size_t position = props.LowerBound("", 0); position < props.Count(); position++) {
+			std::vector<std::string> references;
+			AddReferences(props.KeyAt(position), references);
+			AddReferences(props.ValueAt(position), references);
+			if (!references.empty())
+				referring.push_back(std::make_pair(props.KeyAt(position), references));
+		}
+	}
+	bool added = true;
+	while (added) {
+		added = false;
+		for (size_t i = 0; i < referring.size(); i++) {
+			if (!keys.count(referring[i].first) && RefersToAny(referring[i].second, keys)) {
+				keys.insert(referring[i].first);
+				added = true;
 			}
-			++it;
 		}
-		// Failed here, so try in base property set
-		psf = psf->superPS;
 	}
-	return "";
 }
 
-SString PropSetFile::GetWild(const char *keybase, const char *filename) {
-	return GetWildUsingStart(*this, keybase, filename);
+void PropertyReads::Clear() {
+	keys.clear();
+	prefixes.clear();
+	wild.clear();
+}
+
+/**
+ * Could changing @a key, one of @a changedKeys, alter a value read? For keys found with
+ * GetWild, only a key whose patterns match the file name could. Patterns given by another
+ * property are taken from @a props unless that property also changed.
+ */
+bool PropertyReads::Includes(const std::string &key, const std::set<std::string> &changedKeys, const PropSetFile &props) const {
+	if (keys.count(key))
+		return true;
+	for (std::set<std::string>::const_iterator it = prefixes.begin(); it != prefixes.end(); ++it) {
+		if (key.compare(0, it->length(), *it) == 0)
+			return true;
+	}
+	for (std::set<std::pair<std::string, std::string> >::const_iterator itWild = wild.begin();
+		itWild != wild.end(); ++itWild) {
+		const std::string &keybase = itWild->first;
+		if (key.compare(0, keybase.length(), keybase) != 0)
+			continue;
+		std::string keyPatterns = key.substr(keybase.length());
+		if (keyPatterns.empty())
+			return true;
+		if ((keyPatterns.compare(0, 2, "$(") == 0) && (keyPatterns.find(')') == keyPatterns.length() - 1)) {
+			const std::string var = keyPatterns.substr(2, keyPatterns.length() - 3);
+			if (changedKeys.count(var))
+				return true;
+			keyPatterns = props.GetExpanded(var.c_str()).c_str();
+		} else if (keyPatterns.find("$(") != std::string::npos) {
+			return true;
+		}
+		size_t start = 0;
+		for (;;) {
+			size_t end = keyPatterns.find(';', start);
+			if (end == std::string::npos)
+				end = keyPatterns.length();
+			if (MatchWild(keyPatterns.c_str() + start, end - start, itWild->second.c_str(),
+				PropSetFile::CaseSensitiveFilenames()))
+				return true;
+			if (end == keyPatterns.length())
+				break;
+			start = end + 1;
+		}
+	}
+	return false;
+}
+
+bool PropertyReads::IncludesAny(const std::set<std::string> &changedKeys, const PropSetFile &props) const {
+	for (std::set<std::string>::const_iterator it = changedKeys.begin(); it != changedKeys.end(); ++it) {
+		if (Includes(*it, changedKeys, props))
+			return true;
+	}
+	return false;
 }
 
 // GetNewExpand does not use Expand as it has to use GetWild with the filename for each
 // variable reference found.
 SString PropSetFile::GetNewExpand(const char *keybase, const char *filename) {
-	char *base = StringDup(GetWild(keybase, filename).c_str());
-	char *cpvar = strstr(base, "$(");
+	SString val = GetWild(keybase, filename);
+	if (val.search("$(") < 0)
+		return val;
+	// Results are stored by keybase and file name, separated by a NUL that keys
+	// can not contain so they do not collide with those of GetExpanded
+	std::string expansionKey(keybase);
+	expansionKey += '\0';
+	expansionKey += filename;
+	PropertyExpansion *expansion = FindExpansion(expansionKey, val.c_str());
+	if (expansion) {
+		if (ChainUnchanged(expansion->changes)) {
+			if (readsRecorded) {
+				for (VariableReads::const_iterator it = expansion->reads.begin(); it != expansion->reads.end(); ++it)
+					readsRecorded->AddWild(it->first.c_str(), filename);
+			}
+			return SString(expansion->value.c_str());
+		}
+		bool same = true;
+		for (VariableReads::const_iterator it = expansion->reads.begin(); same && (it != expansion->reads.end()); ++it)
+			same = it->second == GetWild(it->first.c_str(), filename).c_str();
+		if (same) {
+			ChainChanges(expansion->changes);
+			return SString(expansion->value.c_str());
+		}
+	}
+	PropertyExpansion &result = expansions[expansionKey];
+	result.raw = val.c_str();
+	result.reads.clear();
+	std::string &base = result.value;
+	base = result.raw;
+	size_t varStart = base.find("$(");
 	int maxExpands = 1000;	// Avoid infinite expansion of recursive definitions
-	while (cpvar && (maxExpands > 0)) {
-		const char *cpendvar = strchr(cpvar, ')');
-		if (cpendvar) {
-			ptrdiff_t lenvar = cpendvar - cpvar - 2;  	// Subtract the $()
-			char *var = StringDup(cpvar + 2, lenvar);
-			SString val = GetWild(var, filename);
-			if (0 == strcmp(var, keybase))
-				val.clear(); // Self-references evaluate to empty string
-			size_t newlenbase = strlen(base) + val.length() - lenvar;
-			char *newbase = new char[newlenbase];
-			strncpy(newbase, base, cpvar - base);
-			strcpy(newbase + (cpvar - base), val.c_str());
-			strcpy(newbase + (cpvar - base) + val.length(), cpendvar + 1);
-			delete []var;
-			delete []base;
-			base = newbase;
-		}
-		cpvar = strstr(base, "$(");
+	while ((varStart != std::string::npos) && (maxExpands > 0)) {
+		const size_t varEnd = base.find(')', varStart);
+		if (varEnd == std::string::npos)
+			break;
+		const std::string var(base, varStart + 2, varEnd - varStart - 2);
+		SString valVar = GetWild(var.c_str(), filename);
+		result.reads.push_back(std::make_pair(var, std::string(valVar.c_str())));
+		if (var == keybase)
+			valVar.clear(); // Self-references evaluate to empty string
+		base.replace(varStart, varEnd - varStart + 1, valVar.c_str(), valVar.length());
+		varStart = base.find("$(");
 		maxExpands--;
 	}
-	SString sret = base;
-	delete []base;
-	return sret;
+	ChainChanges(result.changes);
+	return SString(base.c_str());
 }
 
 /**
  * Initiate enumeration.
  */
 bool PropSetFile::GetFirst(const char *&key, const char *&val) {
-	mapss::iterator it = props.begin();
-	if (it != props.end()) {
-		key = it->first.c_str();
-		val = it->second.c_str();
+	const size_t position = table->LowerBound("", 0);
+	if (position < table->Count()) {
+		key = table->KeyAt(position).c_str();
+		val = table->ValueAt(position);
 		return true;
 	} else {
 		return false;
@@ -626,12 +1708,13 @@ bool PropSetFile::GetFirst(const char *&key, const char *&val) {
  * Continue enumeration.
  */
 bool PropSetFile::GetNext(const char *&key, const char *&val) {
-	mapss::iterator it = props.find(key);
-	if (it != props.end()) {
-		++it;
-		if (it != props.end()) {
-			key = it->first.c_str();
-			val = it->second.c_str();
+	const size_t lenKey = strlen(key);
+	size_t position = table->LowerBound(key, lenKey);
+	if ((position < table->Count()) && (table->KeyAt(position).compare(0, std::string::npos, key, lenKey) == 0)) {
+		++position;
+		if (position < table->Count()) {
+			key = table->KeyAt(position).c_str();
+			val = table->ValueAt(position);
 			return true;
 		}
 	}
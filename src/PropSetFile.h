@@ -10,19 +10,95 @@
 
 typedef std::map<std::string, std::string> mapss;
 
+class ImportPrefetch;
+
 class ImportFilter {
 public:
 	std::set<std::string> excludes;
 	std::set<std::string> includes;
+	bool lazy;	///< Defer reading language files imported by "import *" until needed
+	ImportPrefetch *prefetch;	///< Reads imported files on other threads when set
+	ImportFilter() : lazy(false), prefetch(0) {
+	}
 	void SetFilter(std::string sExcludes, std::string sIncludes);
 	bool IsValid(std::string name) const;
 };
 
+class WildIndex;
+class PropertyTable;
+class PropSetFile;
+
+/**
+ * The properties looked up while recording with RecordingReads: keys read directly,
+ * prefixes of keys read by "star" evaluation and the keybases and file names given to
+ * GetWild. Tells whether a change to a property may alter what was read.
+ */
+class PropertyReads {
+	std::set<std::string> keys;
+	std::set<std::string> prefixes;
+	std::set<std::pair<std::string, std::string> > wild;
+public:
+	void Clear();
+	void AddKey(const char *key) {
+		keys.insert(key);
+	}
+	void AddPrefix(const char *prefix) {
+		prefixes.insert(prefix);
+	}
+	void AddWild(const char *keybase, const char *filename) {
+		wild.insert(std::pair<std::string, std::string>(keybase, filename));
+	}
+	bool Includes(const std::string &key, const std::set<std::string> &changedKeys, const PropSetFile &props) const;
+	bool IncludesAny(const std::set<std::string> &changedKeys, const PropSetFile &props) const;
+};
+
+/**
+ * A language properties file imported by "import *" of which only the settings that
+ * choose a language for a file have been read: file patterns, lexers, shbangs, open
+ * filters and '*' settings. The rest is read when one of its lexers is needed.
+ */
+struct DeferredImport {
+	FilePath path;
+	FilePath directoryForImports;
+	std::set<std::string> lexers;	///< Values of the file's lexer settings
+	std::string keys;	///< Settings left to be read, each between line ends
+	size_t order;	///< Place among the files deferred by this set, counting from 1
+	DeferredImport() : order(0) {
+	}
+};
+
+/// A value expanded by GetExpanded or GetNewExpand along with what it was made from.
+struct PropertyExpansion {
+	std::string raw;	///< Value before expansion
+	std::string value;	///< Value after expansion
+	std::vector<unsigned int> changes;	///< Changes() of each set in the chain when last known valid
+	std::vector<std::pair<std::string, std::string> > reads;	///< Variables looked up and their values
+};
+
 class PropSetFile {
 	bool lowerKeys;
-	SString GetWildUsingStart(const PropSetFile &psStart, const char *keybase, const char *filename);
 	static bool caseSensitiveFilenames;
-	mapss props;
+	PropertyTable *table;	///< Shared with copies of this set until either changes
+	unsigned int changes;
+	mutable bool indexed;	///< In the chain of a wildcard index so changed keys must be noted
+	void NoteChanged();
+	void ReleaseTable();
+	void Unshare();
+	std::map<std::string, WildIndex *> wildIndexes;	///< Compiled patterns for GetWild by keybase
+	const WildIndex &WildIndexFor(const char *keybase);
+	mutable std::vector<const PropSetFile *> expansionsChain;
+	mutable std::map<std::string, PropertyExpansion> expansions;	///< By key or by keybase and file name
+	PropertyExpansion *FindExpansion(const std::string &key, const char *raw) const;
+	bool ChainUnchanged(const std::vector<unsigned int> &chainChanges) const;
+	void ChainChanges(std::vector<unsigned int> &chainChanges) const;
+	std::vector<DeferredImport> deferredImports;
+	DeferredImport *manifest;	///< Reading only the choice of language into this
+	std::set<std::string> *keysDeferred;	///< Keys set while reading a deferred import
+	size_t order;	///< Settings made now follow this many deferred imports
+	std::map<std::string, size_t> keyOrder;	///< order when each key was last set, once any file is deferred
+	void ImportManifest(FilePath filename, FilePath directoryForImports, const ImportFilter &filter, std::vector<FilePath> *imports);
+	void ReadDeferred(const DeferredImport &deferred, const std::vector<char> &data, const ImportFilter &filter);
+	void ReadLines(const std::vector<char> &lines, FilePath directoryForImports, const ImportFilter &filter, std::vector<FilePath> *imports);
 public:
 	PropSetFile *superPS;
 	PropSetFile(bool lowerKeys_=false);
@@ -47,6 +123,20 @@ public:
 	void Import(FilePath filename, FilePath directoryForImports, const ImportFilter &filter, std::vector<FilePath> *imports);
 	bool Read(FilePath filename, FilePath directoryForImports, const ImportFilter &filter, std::vector<FilePath> *imports=0);
 	void SetInteger(const char *key, int i);
+	/// Differs after any change to this set and from that of any other set, so values
+	/// derived from a set can be kept until then.
+	unsigned int Changes() const {
+		return changes;
+	}
+	const std::vector<DeferredImport> &DeferredImports() const {
+		return deferredImports;
+	}
+	void AddDeferredImport(const DeferredImport &deferred);
+	const std::map<std::string, size_t> &KeyOrder() const {
+		return keyOrder;
+	}
+	void SetKeyOrder(const std::string &key, size_t order_);
+	bool ImportDeferred(const char *lexer, const ImportFilter &filter);
 	SString GetWild(const char *keybase, const char *filename);
 	SString GetNewExpand(const char *keybase, const char *filename="");
 	bool GetFirst(const char *&key, const char *&val);
@@ -54,7 +144,25 @@ public:
 	static void SetCaseSensitiveFilenames(bool caseSensitiveFilenames_) {
 		caseSensitiveFilenames = caseSensitiveFilenames_;
 	}
+	static void CollectConditions(std::set<std::string> *conditions);
+	static bool CaseSensitiveFilenames() {
+		return caseSensitiveFilenames;
+	}
+	static PropertyReads *RecordReads(PropertyReads *reads);
+	void AddReferrers(std::set<std::string> &keys) const;
+};
+
+/// Record the properties read from any PropSetFile into @a reads while this exists.
+class RecordingReads {
+	PropertyReads *previous;
+public:
+	explicit RecordingReads(PropertyReads &reads) : previous(PropSetFile::RecordReads(&reads)) {
+	}
+	~RecordingReads() {
+		PropSetFile::RecordReads(previous);
+	}
 };
 
 #define PROPERTIES_EXTENSION	".properties"
 bool IsPropertiesFile(const FilePath &filename);
+bool ReadPropertiesLines(const FilePath &filename, std::vector<char> &lines);
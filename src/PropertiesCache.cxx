@@ -0,0 +1,326 @@
+// SciTE - Scintilla based Text Editor
+/** @file PropertiesCache.cxx
+ ** Implementation of a file holding property sets already read from properties files.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <algorithm>
+
+#ifdef _MSC_VER
+// Turn off MS dislike of POSIX
+#pragma warning(disable: 4996)
+#endif
+
+#include "Scintilla.h"
+
+#include "GUI.h"
+#include "SString.h"
+#include "FilePath.h"
+#include "PropSetFile.h"
+#include "MappedFile.h"
+#include "PropertiesCache.h"
+#include "SciTE.h"
+
+static const char cacheMagic[8] = { 'S', 'c', 'i', 'T', 'E', 'P', 'R', 'P' };
+// Increment when the layout changes
+static const unsigned int cacheVersion = 3;
+// Differs when read on a machine with other byte order
+static const unsigned int cacheByteOrder = 0x01020304;
+
+/**
+ * The file starts with this header followed by strings and counts in the order they
+ * are written by Save. Each string is preceded by its length.
+ */
+struct CacheHeader {
+	char magic[8];
+	unsigned int version;
+	unsigned int byteOrder;
+};
+
+/// Size and modification time of a file or "-" when it does not exist.
+static std::string FileStamp(const FilePath &path) {
+	if (!path.Exists())
+		return "-";
+	char stamp[100];
+	sprintf(stamp, "%ld %ld", path.GetFileLength(), static_cast<long>(path.ModifiedTime()));
+	return stamp;
+}
+
+/// Names of the properties files in a directory as any of them may be imported.
+static std::string PropertiesFilesIn(FilePath directory) {
+	FilePathSet directories;
+	FilePathSet files;
+	directory.List(directories, files);
+	std::vector<std::string> names;
+	for (size_t i = 0; i < files.size(); i++) {
+		if (IsPropertiesFile(files[i]))
+			names.push_back(files[i].Name().AsUTF8());
+	}
+	std::sort(names.begin(), names.end());
+	std::string listing;
+	for (size_t j = 0; j < names.size(); j++) {
+		listing += names[j];
+		listing += '\n';
+	}
+	return listing;
+}
+
+namespace {
+
+class CacheWriter {
+public:
+	std::string data;
+	void AddCount(size_t count) {
+		const unsigned int value = static_cast<unsigned int>(count);
+		data.append(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+	void AddString(const char *s, size_t len) {
+		AddCount(len);
+		data.append(s, len);
+	}
+	void AddString(const std::string &s) {
+		AddString(s.c_str(), s.length());
+	}
+};
+
+/// Reads the strings and counts of a cache file, failing rather than reading past its end.
+class CacheReader {
+	const char *pos;
+	const char *end;
+public:
+	bool ok;
+	CacheReader(const char *data, size_t size) : pos(data), end(data + size), ok(true) {
+	}
+	size_t Count() {
+		unsigned int value = 0;
+		if (ok && (static_cast<size_t>(end - pos) >= sizeof(value))) {
+			memcpy(&value, pos, sizeof(value));
+			pos += sizeof(value);
+		} else {
+			ok = false;
+		}
+		return value;
+	}
+	const char *String(size_t &len) {
+		len = Count();
+		if (!ok || (static_cast<size_t>(end - pos) < len)) {
+			ok = false;
+			len = 0;
+			return "";
+		}
+		const char *s = pos;
+		pos += len;
+		return s;
+	}
+	std::string String() {
+		size_t len = 0;
+		const char *s = String(len);
+		return std::string(s, len);
+	}
+	bool AtEnd() const {
+		return pos == end;
+	}
+};
+
+}
+
+/**
+ * Set the property sets and import list from the cache file if the files they were read
+ * from and the properties tested while reading them are unchanged.
+ * The expanded values of the properties tested are taken from @a propsConditions.
+ */
+bool PropertiesCache::Load(const FilePath &cacheFile, const PropSetFile &propsConditions,
+	const std::vector<PropSetFile *> &sets, std::vector<FilePath> &importFiles) {
+	MappedFile file;
+	if (!file.Open(cacheFile.AsInternal()))
+		return false;
+	if (file.Size() < sizeof(CacheHeader))
+		return false;
+	CacheHeader header;
+	memcpy(&header, file.Data(), sizeof(header));
+	if ((memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0) ||
+		(header.version != cacheVersion) ||
+		(header.byteOrder != cacheByteOrder))
+		return false;
+	CacheReader reader(file.Data() + sizeof(header), file.Size() - sizeof(header));
+	// Parsing may differ in other versions
+	if (reader.String() != VERSION_SCITE)
+		return false;
+	excludes = reader.String().c_str();
+	includes = reader.String().c_str();
+	lazy = reader.Count() != 0;
+
+	conditions.clear();
+	const size_t conditionsCount = reader.Count();
+	for (size_t c = 0; reader.ok && (c < conditionsCount); c++) {
+		std::string key = reader.String();
+		if (reader.String() != propsConditions.GetExpanded(key.c_str()).c_str())
+			return false;
+		conditions.insert(key);
+	}
+
+	filesRead.clear();
+	const size_t filesCount = reader.Count();
+	for (size_t f = 0; reader.ok && (f < filesCount); f++) {
+		FilePath path(GUI::StringFromUTF8(reader.String().c_str()));
+		if (reader.String() != FileStamp(path))
+			return false;
+		filesRead.push_back(path);
+	}
+
+	directories.clear();
+	const size_t directoriesCount = reader.Count();
+	for (size_t d = 0; reader.ok && (d < directoriesCount); d++) {
+		FilePath directory(GUI::StringFromUTF8(reader.String().c_str()));
+		if (reader.String() != PropertiesFilesIn(directory))
+			return false;
+		directories.push_back(directory);
+	}
+
+	std::vector<FilePath> imports;
+	const size_t importsCount = reader.Count();
+	for (size_t i = 0; reader.ok && (i < importsCount); i++)
+		imports.push_back(FilePath(GUI::StringFromUTF8(reader.String().c_str())));
+
+	if (!reader.ok || (reader.Count() != sets.size()))
+		return false;
+	for (size_t s = 0; reader.ok && (s < sets.size()); s++) {
+		sets[s]->Clear();
+		const size_t pairs = reader.Count();
+		for (size_t p = 0; reader.ok && (p < pairs); p++) {
+			size_t lenKey = 0;
+			const char *key = reader.String(lenKey);
+			size_t lenVal = 0;
+			const char *val = reader.String(lenVal);
+			if (reader.ok && lenKey)
+				sets[s]->Set(key, val, lenKey, lenVal);
+		}
+		const size_t deferredCount = reader.Count();
+		for (size_t d = 0; reader.ok && (d < deferredCount); d++) {
+			DeferredImport deferred;
+			deferred.path = FilePath(GUI::StringFromUTF8(reader.String().c_str()));
+			deferred.directoryForImports = FilePath(GUI::StringFromUTF8(reader.String().c_str()));
+			const size_t lexersCount = reader.Count();
+			for (size_t l = 0; reader.ok && (l < lexersCount); l++)
+				deferred.lexers.insert(reader.String());
+			deferred.keys = reader.String();
+			deferred.order = reader.Count();
+			sets[s]->AddDeferredImport(deferred);
+		}
+		const size_t keyOrderCount = reader.Count();
+		for (size_t k = 0; reader.ok && (k < keyOrderCount); k++) {
+			const std::string key = reader.String();
+			sets[s]->SetKeyOrder(key, reader.Count());
+		}
+	}
+	if (!reader.ok || !reader.AtEnd()) {
+		for (size_t s = 0; s < sets.size(); s++)
+			sets[s]->Clear();
+		return false;
+	}
+	importFiles = imports;
+	return true;
+}
+
+/**
+ * Write the property sets, the import list and what they were read from to a cache file.
+ * The file is written under a temporary name then renamed so that other
+ * instances never see a partial file.
+ */
+bool PropertiesCache::Save(const FilePath &cacheFile, const PropSetFile &propsConditions,
+	const std::vector<PropSetFile *> &sets, const std::vector<FilePath> &importFiles) const {
+	CacheHeader header;
+	memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+	header.version = cacheVersion;
+	header.byteOrder = cacheByteOrder;
+	CacheWriter writer;
+	writer.data.append(reinterpret_cast<const char *>(&header), sizeof(header));
+	writer.AddString(VERSION_SCITE);
+	writer.AddString(excludes.c_str());
+	writer.AddString(includes.c_str());
+	writer.AddCount(lazy ? 1 : 0);
+
+	writer.AddCount(conditions.size());
+	for (std::set<std::string>::const_iterator it = conditions.begin(); it != conditions.end(); ++it) {
+		writer.AddString(*it);
+		writer.AddString(propsConditions.GetExpanded(it->c_str()).c_str());
+	}
+
+	writer.AddCount(filesRead.size());
+	for (size_t f = 0; f < filesRead.size(); f++) {
+		writer.AddString(filesRead[f].AsUTF8());
+		writer.AddString(FileStamp(filesRead[f]));
+	}
+
+	writer.AddCount(directories.size());
+	for (size_t d = 0; d < directories.size(); d++) {
+		writer.AddString(directories[d].AsUTF8());
+		writer.AddString(PropertiesFilesIn(directories[d]));
+	}
+
+	writer.AddCount(importFiles.size());
+	for (size_t i = 0; i < importFiles.size(); i++)
+		writer.AddString(importFiles[i].AsUTF8());
+
+	writer.AddCount(sets.size());
+	for (size_t s = 0; s < sets.size(); s++) {
+		std::vector<std::pair<const char *, const char *> > pairs;
+		const char *key;
+		const char *val;
+		if (sets[s]->GetFirst(key, val)) {
+			do {
+				pairs.push_back(std::make_pair(key, val));
+			} while (sets[s]->GetNext(key, val));
+		}
+		writer.AddCount(pairs.size());
+		for (size_t p = 0; p < pairs.size(); p++) {
+			writer.AddString(pairs[p].first, strlen(pairs[p].first));
+			writer.AddString(pairs[p].second, strlen(pairs[p].second));
+		}
+		const std::vector<DeferredImport> &deferredImports = sets[s]->DeferredImports();
+		writer.AddCount(deferredImports.size());
+		for (size_t d = 0; d < deferredImports.size(); d++) {
+			writer.AddString(deferredImports[d].path.AsUTF8());
+			writer.AddString(deferredImports[d].directoryForImports.AsUTF8());
+			writer.AddCount(deferredImports[d].lexers.size());
+			for (std::set<std::string>::const_iterator it = deferredImports[d].lexers.begin();
+				it != deferredImports[d].lexers.end(); ++it)
+				writer.AddString(*it);
+			writer.AddString(deferredImports[d].keys);
+			writer.AddCount(deferredImports[d].order);
+		}
+		const std::map<std::string, size_t> &keyOrder = sets[s]->KeyOrder();
+		writer.AddCount(keyOrder.size());
+		for (std::map<std::string, size_t>::const_iterator it = keyOrder.begin(); it != keyOrder.end(); ++it) {
+			writer.AddString(it->first);
+			writer.AddCount(it->second);
+		}
+	}
+
+	GUI::gui_string tempName = cacheFile.AsInternal();
+	tempName += GUI_TEXT(".new");
+	const FilePath tempFile(tempName);
+	FILE *fp = tempFile.Open(GUI_TEXT("wb"));
+	if (!fp)
+		return false;
+	bool ok = fwrite(writer.data.c_str(), 1, writer.data.length(), fp) == writer.data.length();
+	if (fclose(fp) != 0)
+		ok = false;
+	if (ok) {
+		cacheFile.Remove();
+		ok = tempFile.Rename(cacheFile);
+	}
+	if (!ok)
+		tempFile.Remove();
+	return ok;
+}
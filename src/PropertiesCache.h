@@ -0,0 +1,36 @@
+// SciTE - Scintilla based Text Editor
+/** @file PropertiesCache.h
+ ** Definition of a file holding property sets already read from properties files.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef PROPERTIESCACHE_H
+#define PROPERTIESCACHE_H
+
+/**
+ * A file holding the contents of property sets along with the list of files they imported
+ * so that they can be used without reading and parsing the properties files.
+ * The file also records what the property sets were read from: the size and modification
+ * time of each file read, the properties files present in each directory that imports
+ * come from and the values of the properties tested by "if" lines. It is only used while
+ * all of these are unchanged. Language files whose reading was deferred are recorded
+ * with the set that deferred them.
+ */
+class PropertiesCache {
+public:
+	SString excludes;	///< imports.exclude used when reading
+	SString includes;	///< imports.include used when reading
+	bool lazy;	///< imports.lazy used when reading
+	std::set<std::string> conditions;	///< Properties tested by "if" lines
+	std::vector<FilePath> filesRead;
+	std::vector<FilePath> directories;	///< Directories imports come from
+	PropertiesCache() : lazy(false) {
+	}
+	bool Load(const FilePath &cacheFile, const PropSetFile &propsConditions,
+		const std::vector<PropSetFile *> &sets, std::vector<FilePath> &importFiles);
+	bool Save(const FilePath &cacheFile, const PropSetFile &propsConditions,
+		const std::vector<PropSetFile *> &sets, const std::vector<FilePath> &importFiles) const;
+};
+
+#endif
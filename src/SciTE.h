@@ -113,6 +113,8 @@
 #define IDM_SELECTTOPREVMATCHPPC	261
 #define IDM_NEXTMATCHPPC	262
 #define IDM_SELECTTONEXTMATCHPPC	263
+#define IDM_GOTODEFINITION	264
+#define IDM_LISTTAGS	265
 
 // Tools
 #define IDM_COMPILE			301
@@ -71,6 +71,12 @@
 #include "Cookie.h"
 #include "Worker.h"
 #include "FileWorker.h"
+#include "WordIndex.h"
+#include "FuzzyMatch.h"
+#include "MappedFile.h"
+#include "APICache.h"
+#include "TagFile.h"
+#include "ImportPrefetch.h"
 #include "SciTEBase.h"
 
 Searcher::Searcher() {
@@ -177,6 +183,15 @@ SciTEBase::SciTEBase(Extension *ext) : apis(true), extender(ext) {
 	callTipUseEscapes = false;
 	callTipIgnoreCase = false;
 	autoCCausedByOnlyOne = false;
+	autoCompleteFuzzy = false;
+	autoCompleteFuzzyMaxItems = 100;
+	autoCFuzzy = false;
+	apiCandidates = 0;
+	apiCache = 0;
+	symbolIndex = new SymbolIndex();
+	autoCompleteAllBuffers = false;
+	tagsRefresher = 0;
+	tagsRefreshPending = false;
 	startCalltipWord = 0;
 	currentCallTip = 0;
 	maxCallTips = 1;
@@ -209,8 +224,15 @@ SciTEBase::SciTEBase(Extension *ext) : apis(true), extender(ext) {
 
 	propsStatus.superPS = &props;
 
+	importPrefetch = new ImportPrefetch(this, importThreads);
+	filter.prefetch = importPrefetch;
+
 	needReadProperties = false;
 	quitting = false;
+	undoRedoLazy = false;
+	stylingBufferSize = StyleWriter::defaultStyleBufferSize;
+	stylingTrace = false;
+	stylerActive = 0;
 
 	timerMask = 0;
 	delayBeforeAutoSave = 0;
@@ -218,8 +240,20 @@ SciTEBase::SciTEBase(Extension *ext) : apis(true), extender(ext) {
 
 SciTEBase::~SciTEBase() {
 	TimerEnd(timerAutoSave);
+	// The platform part of this object has gone so a running tags command must not post to it.
+	// A command that does not finish soon is left to run with its refresher.
+	if (tagsRefresher && tagsRefresher->Stop(2.0))
+		delete tagsRefresher;
+	tagsRefresher = 0;
 	if (extender)
 		extender->Finalise();
+	DiscardWordIndices();
+	delete symbolIndex;
+	delete apiCandidates;
+	apis.Clear();
+	delete apiCache;
+	filter.prefetch = 0;
+	delete importPrefetch;
 	delete []languageMenu;
 	delete []shortCutItemList;
 	popup.Destroy();
@@ -238,6 +272,13 @@ void SciTEBase::WorkerCommand(int cmd, Worker *pWorker) {
 	case WORK_FILEPROGRESS:
  		UpdateProgress(pWorker);
 		break;
+	case WORK_TAGSREFRESHED:
+		TagsRefreshed(static_cast<TagsRefresher *>(pWorker));
+		break;
+	case WORK_EXTENSION:
+		if (extender)
+			extender->OnWorker(pWorker);
+		break;
 	}
 }
 
@@ -1479,61 +1520,75 @@ void SciTEBase::FillFunctionDefinition(int pos /*= -1*/) {
 	if (pos > 0) {
 		lastPosCallTip = pos;
 	}
+	SString definition;
 	if (apis) {
 		char *words = GetNearestWords(currentCallTipWord.c_str(), currentCallTipWord.length(),
 			calltipParametersStart.c_str(), callTipIgnoreCase, true);
-		if (!words)
-			return;
-		// Counts how many call tips
-		const char *spacePos = strchr(words, ' ');
-		maxCallTips = 1;
-		while (spacePos) {
-			maxCallTips++;
-			spacePos = strchr(spacePos + 1, ' ');
-		}
-		delete []words;
-
-		// Should get current api definition
-		const char *word = apis.GetNearestWord(currentCallTipWord.c_str(), currentCallTipWord.length(),
-		        callTipIgnoreCase, calltipWordCharacters, currentCallTip);
-		if (word) {
-			functionDefinition = word;
-			if (maxCallTips > 1) {
-				functionDefinition.insert(0, "\001");
+		if (words) {
+			// Counts how many call tips
+			const char *spacePos = strchr(words, ' ');
+			maxCallTips = 1;
+			while (spacePos) {
+				maxCallTips++;
+				spacePos = strchr(spacePos + 1, ' ');
 			}
+			delete []words;
 
-			if (calltipEndDefinition != "") {
-				int posEndDef = functionDefinition.search(calltipEndDefinition.c_str());
-				if (maxCallTips > 1) {
-					if ((posEndDef > 1) &&
-					        ((posEndDef + calltipEndDefinition.length()) < functionDefinition.length())) {
-						functionDefinition.insert(posEndDef + calltipEndDefinition.length(), "\n\002");
-					} else {
-						functionDefinition.append("\n\002");
-					}
+			// Should get current api definition
+			const char *word = apis.GetNearestWord(currentCallTipWord.c_str(), currentCallTipWord.length(),
+			        callTipIgnoreCase, calltipWordCharacters, currentCallTip);
+			if (word)
+				definition = word;
+		}
+	}
+	if ((definition.length() == 0) && autoCompleteAllBuffers) {
+		// Functions defined in open documents
+		std::vector<std::string> signatures = symbolIndex->Signatures(currentCallTipWord.c_str(),
+			currentCallTipWord.length(), calltipParametersStart.c_str());
+		if (!signatures.empty()) {
+			maxCallTips = static_cast<int>(signatures.size());
+			if (currentCallTip >= maxCallTips)
+				currentCallTip = 0;
+			definition = signatures[currentCallTip].c_str();
+		}
+	}
+	if (definition.length()) {
+		functionDefinition = definition;
+		if (maxCallTips > 1) {
+			functionDefinition.insert(0, "\001");
+		}
+
+		if (calltipEndDefinition != "") {
+			int posEndDef = functionDefinition.search(calltipEndDefinition.c_str());
+			if (maxCallTips > 1) {
+				if ((posEndDef > 1) &&
+				        ((posEndDef + calltipEndDefinition.length()) < functionDefinition.length())) {
+					functionDefinition.insert(posEndDef + calltipEndDefinition.length(), "\n\002");
 				} else {
-					if ((posEndDef > 1) &&
-					        ((posEndDef + calltipEndDefinition.length()) < functionDefinition.length())) {
-						functionDefinition.insert(posEndDef + calltipEndDefinition.length(), "\n");
-					}
+					functionDefinition.append("\n\002");
 				}
-			} else if (maxCallTips > 1) {
-				functionDefinition.insert(1, "\002");
-			}
-
-			SString definitionForDisplay;
-			if (callTipUseEscapes) {
-				char *sUnslashed = StringDup(functionDefinition.c_str());
-				UnSlash(sUnslashed);
-				definitionForDisplay = sUnslashed;
-				delete []sUnslashed;
 			} else {
-				definitionForDisplay = functionDefinition;
+				if ((posEndDef > 1) &&
+				        ((posEndDef + calltipEndDefinition.length()) < functionDefinition.length())) {
+					functionDefinition.insert(posEndDef + calltipEndDefinition.length(), "\n");
+				}
 			}
+		} else if (maxCallTips > 1) {
+			functionDefinition.insert(1, "\002");
+		}
 
-			wEditor.CallString(SCI_CALLTIPSHOW, lastPosCallTip - currentCallTipWord.length(), definitionForDisplay.c_str());
-			ContinueCallTip();
+		SString definitionForDisplay;
+		if (callTipUseEscapes) {
+			char *sUnslashed = StringDup(functionDefinition.c_str());
+			UnSlash(sUnslashed);
+			definitionForDisplay = sUnslashed;
+			delete []sUnslashed;
+		} else {
+			definitionForDisplay = functionDefinition;
 		}
+
+		wEditor.CallString(SCI_CALLTIPSHOW, lastPosCallTip - currentCallTipWord.length(), definitionForDisplay.c_str());
+		ContinueCallTip();
 	}
 }
 
@@ -1676,6 +1731,8 @@ bool SciTEBase::StartAutoComplete() {
 			calltipParametersStart.c_str(), autoCompleteIgnoreCase);
 		if (words) {
 			EliminateDuplicateWords(words);
+			autoCFuzzy = false;
+			wEditor.Call(SCI_AUTOCSETAUTOHIDE, 1);
 			wEditor.Call(SCI_AUTOCSETSEPARATOR, ' ');
 			wEditor.CallString(SCI_AUTOCSHOW, root.length(), words);
 			delete []words;
@@ -1684,6 +1741,86 @@ bool SciTEBase::StartAutoComplete() {
 	return true;
 }
 
+WordIndex *SciTEBase::DocumentWordIndex() {
+	sptr_t doc = wEditor.CallReturnPointer(SCI_GETDOCPOINTER);
+	WordIndex *&index = wordIndices[doc];
+	if (!index)
+		index = new WordIndex(autoCompleteAllBuffers ? symbolIndex : 0);
+	index->SetWordCharacters(wordCharacters.c_str());
+	if (autoCompleteAllBuffers)
+		index->SetParameterCharacters(calltipParametersStart.c_str(), calltipParametersEnd.c_str());
+	if (!index->IsBuilt()) {
+		// One pass over the document then kept up to date by UpdateWordIndex
+		const char *text = reinterpret_cast<const char *>(
+			wEditor.CallReturnPointer(SCI_GETCHARACTERPOINTER));
+		index->Build(text, LengthDocument());
+	}
+	return index;
+}
+
+void SciTEBase::UpdateWordIndex(const SCNotification *notification) {
+	if (wordIndices.empty() && !autoCompleteAllBuffers)
+		return;
+	std::map<sptr_t, WordIndex *>::iterator it =
+		wordIndices.find(wEditor.CallReturnPointer(SCI_GETDOCPOINTER));
+	if ((it == wordIndices.end()) || !it->second->IsBuilt()) {
+		// Every document contributes to the shared index so build it now, after the change
+		if (autoCompleteAllBuffers && notification->text)
+			DocumentWordIndex();
+		return;
+	}
+	WordIndex *index = it->second;
+	if (!notification->text) {
+		// Deletions made without undo collection do not report their text
+		index->Clear();
+		return;
+	}
+	// Words may be joined or split at the modification so reindex the whole
+	// words around it, reconstructing how they were before the change.
+	// Signatures lie within a line so, when they are shared, reindex the whole lines
+	// touched by the change as a signature may start anywhere before it.
+	const bool insertion = (notification->modificationType & SC_MOD_INSERTTEXT) != 0;
+	const int position = notification->position;
+	const int lengthAdded = insertion ? notification->length : 0;
+	int start = position;
+	int end = position + lengthAdded;
+	if (autoCompleteAllBuffers) {
+		start = wEditor.Call(SCI_POSITIONFROMLINE, wEditor.Call(SCI_LINEFROMPOSITION, start));
+		end = wEditor.Call(SCI_GETLINEENDPOSITION, wEditor.Call(SCI_LINEFROMPOSITION, end));
+	}
+	TextReader acc(wEditor);
+	while ((start > 0) && index->IsWordCharacter(acc.SafeGetCharAt(start - 1, '\0')))
+		start--;
+	while (index->IsWordCharacter(acc.SafeGetCharAt(end, '\0')))
+		end++;
+	SString before = GetRange(wEditor, start, position);
+	SString after = GetRange(wEditor, position + lengthAdded, end);
+	std::string textOld(before.c_str(), before.length());
+	std::string textNew(textOld);
+	if (insertion)
+		textNew.append(notification->text, notification->length);
+	else
+		textOld.append(notification->text, notification->length);
+	textOld.append(after.c_str(), after.length());
+	textNew.append(after.c_str(), after.length());
+	index->Remove(textOld.c_str(), textOld.length());
+	index->Insert(textNew.c_str(), textNew.length());
+}
+
+void SciTEBase::DiscardWordIndex(sptr_t doc) {
+	std::map<sptr_t, WordIndex *>::iterator it = wordIndices.find(doc);
+	if (it != wordIndices.end()) {
+		delete it->second;
+		wordIndices.erase(it);
+	}
+}
+
+void SciTEBase::DiscardWordIndices() {
+	for (std::map<sptr_t, WordIndex *>::iterator it = wordIndices.begin(); it != wordIndices.end(); ++it)
+		delete it->second;
+	wordIndices.clear();
+}
+
 bool SciTEBase::StartAutoCompleteWord(bool onlyOneWord) {
 	SString line = GetLine();
 	int current = GetCaretInLine();
@@ -1700,72 +1837,181 @@ bool SciTEBase::StartAutoCompleteWord(bool onlyOneWord) {
 	if (startword == current || allNumber)
 		return true;
 	SString root = line.substr(startword, current - startword);
-	int doclen = LengthDocument();
-	Sci_TextToFind ft = {{0, 0}, 0, {0, 0}};
-	ft.lpstrText = const_cast<char *>(root.c_str());
-	ft.chrg.cpMin = 0;
-	ft.chrg.cpMax = doclen;
-	ft.chrgText.cpMin = 0;
-	ft.chrgText.cpMax = 0;
-	const int flags = SCFIND_WORDSTART | (autoCompleteIgnoreCase ? 0 : SCFIND_MATCHCASE);
-	int posCurrentWord = wEditor.Call(SCI_GETCURRENTPOS) - static_cast<int>(root.length());
-	unsigned int minWordLength = 0;
-	unsigned int nwords = 0;
+	WordIndex *index = DocumentWordIndex();
 
-	// wordsNear contains a list of words separated by single spaces and with a space
-	// at the start and end. This makes it easy to search for words.
-	SString wordsNear;
-	wordsNear.setsizegrowth(1000);
-	wordsNear.append("\n");
-
-	int posFind = wEditor.CallString(SCI_FINDTEXT, flags, reinterpret_cast<char *>(&ft));
+	// The word being typed is in the index so leave it out unless it also occurs elsewhere.
+	int posCurrentWord = wEditor.Call(SCI_GETCURRENTPOS) - static_cast<int>(root.length());
+	int endCurrentWord = posCurrentWord + static_cast<int>(root.length());
 	TextReader acc(wEditor);
-	while (posFind >= 0 && posFind < doclen) {	// search all the document
-		int wordEnd = posFind + static_cast<int>(root.length());
-		if (posFind != posCurrentWord) {
-			while (wordCharacters.contains(acc.SafeGetCharAt(wordEnd)))
-				wordEnd++;
-			unsigned int wordLength = wordEnd - posFind;
-			if (wordLength > root.length()) {
-				SString word = GetRange(wEditor, posFind, wordEnd);
-				word.insert(0, "\n");
-				word.append("\n");
-				if (!wordsNear.contains(word.c_str())) {	// add a new entry
-					wordsNear += word.c_str() + 1;
-					if (minWordLength < wordLength)
-						minWordLength = wordLength;
-
-					nwords++;
-					if (onlyOneWord && nwords > 1) {
-						return true;
-					}
-				}
-			}
+	while (wordCharacters.contains(acc.SafeGetCharAt(endCurrentWord)))
+		endCurrentWord++;
+	SString wordCurrent = GetRange(wEditor, posCurrentWord, endCurrentWord);
+	bool excludeCurrent = index->Count(wordCurrent.c_str()) == 1;
+
+	std::vector<std::string> candidates;
+	if (autoCompleteAllBuffers) {
+		// Words of other documents too
+		excludeCurrent = excludeCurrent && (symbolIndex->Count(wordCurrent.c_str()) == 1);
+		candidates = symbolIndex->Complete(root.c_str(), root.length(),
+			autoCompleteIgnoreCase, onlyOneWord ? 3 : 0);
+	} else {
+		candidates = index->Complete(root.c_str(), root.length(),
+			autoCompleteIgnoreCase, onlyOneWord ? 3 : 0);
+	}
+	std::string acText;
+	unsigned int nwords = 0;
+	for (std::vector<std::string>::const_iterator it = candidates.begin(); it != candidates.end(); ++it) {
+		if (excludeCurrent && (*it == wordCurrent.c_str()))
+			continue;
+		nwords++;
+		if (onlyOneWord && nwords > 1) {
+			return true;
 		}
-		ft.chrg.cpMin = wordEnd;
-		posFind = wEditor.CallString(SCI_FINDTEXT, flags, reinterpret_cast<char *>(&ft));
-	}
-	size_t length = wordsNear.length();
-	if ((length > 2) && (!onlyOneWord || (minWordLength > root.length()))) {
-		// Protect spaces by temporrily transforming to \001
-		wordsNear.substitute(' ', '\001');
-		StringList wl(true);
-		wl.Set(wordsNear.c_str());
-		char *words = wl.GetNearestWords("", 0, autoCompleteIgnoreCase);
-		SString acText(words);
-		// Use \n as word separator
-		acText.substitute(' ', '\n');
-		// Return spaces from \001
-		acText.substitute('\001', ' ');
+		// Use \n as word separator so that words may contain spaces
+		if (!acText.empty())
+			acText += '\n';
+		acText += *it;
+	}
+	if (nwords > 0) {
+		autoCFuzzy = false;
+		wEditor.Call(SCI_AUTOCSETAUTOHIDE, 1);
 		wEditor.Call(SCI_AUTOCSETSEPARATOR, '\n');
 		wEditor.CallString(SCI_AUTOCSHOW, root.length(), acText.c_str());
-		delete []words;
 	} else {
 		wEditor.Call(SCI_AUTOCCANCEL);
 	}
 	return true;
 }
 
+/**
+ * The names defined by the API files, up to the start of their parameters,
+ * prepared for fuzzy matching.
+ */
+const FuzzyCandidates &SciTEBase::APICandidates() {
+	SString ends = calltipParametersStart;
+	ends += "(";
+	if (apiCandidates && (apiCandidatesEnds == ends))
+		return *apiCandidates;
+	if (!apiCandidates)
+		apiCandidates = new FuzzyCandidates();
+	apiCandidates->Clear();
+	apiCandidatesEnds = ends;
+	for (int i = 0; i < apis.len; i++) {
+		const char *word = apis.words[i];
+		size_t len = 0;
+		while (word[len] && !ends.contains(word[len]))
+			len++;
+		while ((len > 0) && (word[len - 1] == ' '))
+			len--;
+		if (len > 0)
+			apiCandidates->Add(word, len);
+	}
+	return *apiCandidates;
+}
+
+/**
+ * Show the API names and document words that contain the characters before
+ * the caret in order, best matches first.
+ * As the list is not sorted, Scintilla is not allowed to search or hide it and
+ * the characters typed are replaced by AutoCompleteSelected.
+ */
+bool SciTEBase::StartAutoCompleteFuzzy() {
+	SString line = GetLine();
+	int current = GetCaretInLine();
+
+	int startword = current;
+	while ((startword > 0) &&
+	        (wordCharacters.contains(line[startword - 1]) ||
+	         calltipWordCharacters.contains(line[startword - 1]))) {
+		startword--;
+	}
+	if (startword == current) {
+		wEditor.Call(SCI_AUTOCCANCEL);
+		return true;
+	}
+	SString root = line.substr(startword, current - startword);
+	FuzzyPattern pattern(root.c_str(), root.length());
+	FuzzyRanking ranking(pattern, autoCRecent);
+	if (apis)
+		ranking.Consider(APICandidates());
+
+	WordIndex *index = DocumentWordIndex();
+	int posCurrentWord = wEditor.Call(SCI_GETCURRENTPOS) - static_cast<int>(root.length());
+	int endCurrentWord = posCurrentWord + static_cast<int>(root.length());
+	TextReader acc(wEditor);
+	while (wordCharacters.contains(acc.SafeGetCharAt(endCurrentWord)))
+		endCurrentWord++;
+	SString wordCurrent = GetRange(wEditor, posCurrentWord, endCurrentWord);
+	bool excludeCurrent = index->Count(wordCurrent.c_str()) == 1;
+	std::vector<std::string> best;
+	if (autoCompleteAllBuffers) {
+		excludeCurrent = excludeCurrent && (symbolIndex->Count(wordCurrent.c_str()) == 1);
+		best = symbolIndex->Rank(ranking, excludeCurrent ? wordCurrent.c_str() : "",
+			autoCompleteFuzzyMaxItems);
+	} else {
+		const WordIndex::WordEntries &words = index->Words();
+		for (WordIndex::WordEntries::const_iterator it = words.begin(); it != words.end(); ++it) {
+			const std::string &word = it->first;
+			if (excludeCurrent && (word == wordCurrent.c_str()))
+				continue;
+			ranking.Consider(word.c_str(), word.length(), it->second.mask);
+		}
+		best = ranking.Best(autoCompleteFuzzyMaxItems);
+	}
+	if (best.empty()) {
+		wEditor.Call(SCI_AUTOCCANCEL);
+		return true;
+	}
+	if ((best.size() == 1) && props.GetInt("autocomplete.choose.single")) {
+		autoCFuzzy = true;
+		AutoCompleteSelected(best[0].c_str());
+		return true;
+	}
+	std::string acText;
+	for (std::vector<std::string>::const_iterator it = best.begin(); it != best.end(); ++it) {
+		if (!acText.empty())
+			acText += '\n';
+		acText += *it;
+	}
+	autoCFuzzy = true;
+	wEditor.Call(SCI_AUTOCSETAUTOHIDE, 0);
+	wEditor.Call(SCI_AUTOCSETSEPARATOR, '\n');
+	// Nothing counts as entered so the best match, first in the list, is selected
+	wEditor.CallString(SCI_AUTOCSHOW, 0, acText.c_str());
+	wEditor.CallString(SCI_AUTOCSELECT, 0, "");
+	return true;
+}
+
+/**
+ * Remember the chosen completion so it ranks higher in fuzzy lists and, as
+ * Scintilla does not know what a fuzzy list replaces, insert it here.
+ */
+void SciTEBase::AutoCompleteSelected(const char *text) {
+	const size_t maxRecent = 16;
+	std::vector<std::string>::iterator it = std::find(autoCRecent.begin(), autoCRecent.end(), text);
+	if (it != autoCRecent.end())
+		autoCRecent.erase(it);
+	autoCRecent.insert(autoCRecent.begin(), text);
+	if (autoCRecent.size() > maxRecent)
+		autoCRecent.pop_back();
+
+	if (autoCFuzzy) {
+		autoCFuzzy = false;
+		wEditor.Call(SCI_AUTOCCANCEL);
+		wEditor.Call(SCI_AUTOCSETAUTOHIDE, 1);
+		int current = wEditor.Call(SCI_GETCURRENTPOS);
+		int start = current;
+		TextReader acc(wEditor);
+		while ((start > 0) &&
+		        (wordCharacters.contains(acc.SafeGetCharAt(start - 1)) ||
+		         calltipWordCharacters.contains(acc.SafeGetCharAt(start - 1)))) {
+			start--;
+		}
+		wEditor.Call(SCI_SETSEL, start, current);
+		wEditor.CallString(SCI_REPLACESEL, 0, text);
+	}
+}
+
 bool SciTEBase::PerformInsertAbbreviation() {
 	SString data = propsAbbrev.Get(abbrevInsert.c_str());
 	size_t dataLength = data.length();
@@ -2738,6 +2984,8 @@ void SciTEBase::CharAdded(char ch) {
 				if (autoCompleteStartCharacters.contains(ch)) {
 					StartAutoComplete();
 				}
+			} else if (autoCFuzzy) {
+				StartAutoCompleteFuzzy();
 			} else if (autoCCausedByOnlyOne) {
 				StartAutoCompleteWord(true);
 			}
@@ -3279,6 +3527,14 @@ void SciTEBase::MenuCommand(int cmdID, int source) {
 	case IDM_SELECTTONEXTMATCHPPC:
 		GoMatchingPreprocCond(IDM_NEXTMATCHPPC, true);
 		break;
+
+	case IDM_GOTODEFINITION:
+		GoToDefinition();
+		break;
+
+	case IDM_LISTTAGS:
+		ListTags();
+		break;
 	case IDM_SHOWCALLTIP:
 		if (wEditor.Call(SCI_CALLTIPACTIVE)) {
 			currentCallTip = (currentCallTip + 1 == maxCallTips) ? 0 : currentCallTip + 1;
@@ -3289,12 +3545,18 @@ void SciTEBase::MenuCommand(int cmdID, int source) {
 		break;
 	case IDM_COMPLETE:
 		autoCCausedByOnlyOne = false;
-		StartAutoComplete();
+		if (autoCompleteFuzzy)
+			StartAutoCompleteFuzzy();
+		else
+			StartAutoComplete();
 		break;
 
 	case IDM_COMPLETEWORD:
 		autoCCausedByOnlyOne = false;
-		StartAutoCompleteWord(false);
+		if (autoCompleteFuzzy)
+			StartAutoCompleteFuzzy();
+		else
+			StartAutoCompleteWord(false);
 		break;
 
 	case IDM_ABBREV:
@@ -3880,14 +4142,29 @@ void SciTEBase::Notify(SCNotification *notification) {
 					int endStyled = wEditor.Call(SCI_GETENDSTYLED);
 					int lineEndStyled = wEditor.Call(SCI_LINEFROMPOSITION, endStyled);
 					endStyled = wEditor.Call(SCI_POSITIONFROMLINE, lineEndStyled);
-					StyleWriter styler(wEditor);
+					StyleWriter styler(wEditor, stylingBufferSize);
 					int styleStart = 0;
 					if (endStyled > 0)
 						styleStart = styler.StyleAt(endStyled - 1);
 					styler.SetCodePage(codePage);
+					// Reading in place is safe as the styler is told of changes to the text and of
+					// messages from the script which may move the gap. Styling started while styling
+					// copies instead as its reads would move the gap under the outer styler.
+					StyleWriter *stylerOuter = stylerActive;
+					styler.SetDirectAccess(!stylerOuter);
+					stylerActive = &styler;
 					extender->OnStyle(endStyled, notification->position - endStyled,
 					        styleStart, &styler);
 					styler.Flush();
+					stylerActive = stylerOuter;
+					if (stylerOuter)
+						stylerOuter->DocumentModified();
+					if (stylingTrace) {
+						char trace[200];
+						sprintf(trace, "Styled %d to %d with %d messages\n",
+							endStyled, notification->position, styler.MessagesSent());
+						OutputAppendString(trace);
+					}
 				}
 			}
 		}
@@ -3967,8 +4244,13 @@ void SciTEBase::Notify(SCNotification *notification) {
 		break;
 
 	case SCN_MODIFIED:
-		if (notification->nmhdr.idFrom == IDM_SRCWIN)
+		if (notification->nmhdr.idFrom == IDM_SRCWIN) {
 			CurrentBuffer()->DocumentModified();
+			if (stylerActive && (notification->modificationType & (SC_MOD_INSERTTEXT | SC_MOD_DELETETEXT)))
+				stylerActive->DocumentModified();
+			if (notification->modificationType & (SC_MOD_INSERTTEXT | SC_MOD_DELETETEXT))
+				UpdateWordIndex(notification);
+		}
 		if (notification->modificationType & SC_LASTSTEPINUNDOREDO) {
 			//when the user hits undo or redo, several normal insert/delete
 			//notifications may fire, but we will end up here in the end
@@ -3976,8 +4258,10 @@ void SciTEBase::Notify(SCNotification *notification) {
 			EnableAMenuItem(IDM_REDO, CallFocused(SCI_CANREDO));
 		} else if (notification->modificationType & (SC_MOD_INSERTTEXT | SC_MOD_DELETETEXT)) {
 			//this will be called a lot, and usually means "typing".
-			EnableAMenuItem(IDM_UNDO, true);
-			EnableAMenuItem(IDM_REDO, false);
+			if (!undoRedoLazy) {
+				EnableAMenuItem(IDM_UNDO, true);
+				EnableAMenuItem(IDM_REDO, false);
+			}
 			if (CurrentBuffer()->findMarks == Buffer::fmMarked) {
 				CurrentBuffer()->findMarks = Buffer::fmModified;
 			}
@@ -4008,8 +4292,22 @@ void SciTEBase::Notify(SCNotification *notification) {
 		}
 		break;
 
+	case SCN_AUTOCSELECTION:
+		if (notification->nmhdr.idFrom == IDM_SRCWIN)
+			AutoCompleteSelected(notification->text);
+		break;
+
+	case SCN_AUTOCCANCELLED:
+		if ((notification->nmhdr.idFrom == IDM_SRCWIN) && autoCFuzzy) {
+			autoCFuzzy = false;
+			wEditor.Call(SCI_AUTOCSETAUTOHIDE, 1);
+		}
+		break;
+
 	case SCN_USERLISTSELECTION: {
-			if (notification->wParam == 2)
+			if (notification->wParam == 1)
+				ContinueTagsList(notification->text);
+			else if (notification->wParam == 2)
 				ContinueMacroList(notification->text);
 			else if (extender && notification->wParam > 2)
 				extender->OnUserListSelection(static_cast<int>(notification->wParam), notification->text);
@@ -4705,11 +5003,58 @@ bool SciTEBase::ProcessCommandLine(GUI::gui_string &args, int phase) {
 }
 
 // Implement ExtensionAPI methods
+/**
+ * Forget the styles or lexer settings last sent to a window when they are changed
+ * some other way so that they are all sent when the properties are next read.
+ */
+void SciTEBase::ForgetAppliedSettings(GUI::ScintillaWindow &win, unsigned int msg) {
+	switch (msg) {
+	case SCI_STYLECLEARALL:
+	case SCI_STYLERESETDEFAULT:
+	case SCI_STYLESETFORE:
+	case SCI_STYLESETBACK:
+	case SCI_STYLESETBOLD:
+	case SCI_STYLESETWEIGHT:
+	case SCI_STYLESETITALIC:
+	case SCI_STYLESETSIZE:
+	case SCI_STYLESETSIZEFRACTIONAL:
+	case SCI_STYLESETFONT:
+	case SCI_STYLESETEOLFILLED:
+	case SCI_STYLESETUNDERLINE:
+	case SCI_STYLESETCASE:
+	case SCI_STYLESETCHARACTERSET:
+	case SCI_STYLESETVISIBLE:
+	case SCI_STYLESETCHANGEABLE:
+	case SCI_STYLESETHOTSPOT:
+		if (&win == &wEditor)
+			stylesAppliedEditor.Clear();
+		else
+			stylesAppliedOutput.Clear();
+		break;
+	case SCI_SETLEXER:
+	case SCI_SETLEXERLANGUAGE:
+	case SCI_LOADLEXERLIBRARY:
+	case SCI_PRIVATELEXERCALL:
+	case SCI_SETKEYWORDS:
+	case SCI_SETPROPERTY:
+		if (&win == &wEditor)
+			CurrentBuffer()->lexerApplied.Clear();
+		else
+			lexerAppliedOutput.Clear();
+		break;
+	}
+}
+
 sptr_t SciTEBase::Send(Pane p, unsigned int msg, uptr_t wParam, sptr_t lParam) {
-	if (p == paneEditor)
-		return wEditor.Call(msg, wParam, lParam);
-	else
-		return wOutput.Call(msg, wParam, lParam);
+	GUI::ScintillaWindow &win = (p == paneEditor) ? wEditor : wOutput;
+	// Extensions may change the settings behind ReadProperties' back
+	ForgetAppliedSettings(win, msg);
+	const sptr_t result = win.Call(msg, wParam, lParam);
+	// Messages may move the gap or change the text without notification, such as after
+	// the modification event mask is changed, so the styler must read the document again
+	if (stylerActive && (p == paneEditor))
+		stylerActive->DocumentModified();
+	return result;
 }
 
 char *SciTEBase::Range(Pane p, int start, int end) {
@@ -4727,6 +5072,8 @@ void SciTEBase::Remove(Pane p, int start, int end) {
 	if (p == paneEditor) {
 		wEditor.Call(SCI_SETSEL, start, end);
 		wEditor.Call(SCI_CLEAR);
+		if (stylerActive)
+			stylerActive->DocumentModified();
 	} else {
 		wOutput.Call(SCI_SETSEL, start, end);
 		wOutput.Call(SCI_CLEAR);
@@ -4734,10 +5081,13 @@ void SciTEBase::Remove(Pane p, int start, int end) {
 }
 
 void SciTEBase::Insert(Pane p, int pos, const char *s) {
-	if (p == paneEditor)
+	if (p == paneEditor) {
 		wEditor.CallString(SCI_INSERTTEXT, pos, s);
-	else
+		if (stylerActive)
+			stylerActive->DocumentModified();
+	} else {
 		wOutput.CallString(SCI_INSERTTEXT, pos, s);
+	}
 }
 
 void SciTEBase::Trace(const char *s) {
@@ -4756,12 +5106,14 @@ void SciTEBase::SetProperty(const char *key, const char *val) {
 	SString value = props.GetExpanded(key);
 	if (value != val) {
 		props.Set(key, val);
+		propertiesChanged.insert(key);
 		needReadProperties = true;
 	}
 }
 
 void SciTEBase::UnsetProperty(const char *key) {
 	props.Unset(key);
+	propertiesChanged.insert(key);
 	needReadProperties = true;
 }
 
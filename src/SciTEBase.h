@@ -10,6 +10,7 @@ extern const GUI::gui_char appName[];
 extern const GUI::gui_char propUserFileName[];
 extern const GUI::gui_char propGlobalFileName[];
 extern const GUI::gui_char propAbbrevFileName[];
+extern const GUI::gui_char propCacheFileName[];
 
 #ifdef WIN32
 #ifdef _MSC_VER
@@ -88,6 +89,30 @@ public:
 };
 
 struct FileWorker;
+class WordIndex;
+class SymbolIndex;
+class FuzzyCandidates;
+class APICache;
+struct TagsRefresher;
+class ImportPrefetch;
+
+/**
+ * The lexer, keyword lists and lexer properties last sent for a document.
+ * The lexer and its settings belong to the document in Scintilla so are still in place
+ * when switching back to it and only those settings that differ need to be sent again.
+ */
+class LexerSettings {
+	sptr_t doc;
+	SString language;
+	std::map<int, std::string> keyWords;
+	std::map<std::string, std::string> properties;
+public:
+	LexerSettings() : doc(0) {}
+	void Clear();
+	void Use(sptr_t doc_, const SString &language_);
+	bool SetKeyWords(int keyWordSet, const SString &keyWords_);
+	bool SetProperty(const char *key, const SString &value);
+};
 
 class Buffer : public RecentFile {
 public:
@@ -106,6 +131,7 @@ public:
 	std::vector<int> bookmarks;
 	FileWorker *pFileWorker;
 	PropSetFile props;
+	LexerSettings lexerApplied;	///< Lexer settings sent for doc
 	enum FutureDo { fdNone=0, fdFinishSave=1 } futureDo;
 	Buffer() :
 			RecentFile(), doc(0), isDirty(false), isReadOnly(false), useMonoFont(false), lifeState(empty),
@@ -128,6 +154,7 @@ public:
 		bookmarks.clear();
 		pFileWorker = 0;
 		futureDo = fdNone;
+		lexerApplied.Clear();
 	}
 
 	void SetTimeFromFile() {
@@ -264,6 +291,36 @@ public:
 	bool IsBold() const;
 };
 
+/**
+ * The messages that set the styles of a window, recorded rather than sent so they
+ * can be compared with those sent for the previous buffer. Switching between buffers
+ * of the same language produces the same messages and they need not be sent again.
+ */
+class StyleMessages {
+	struct Message {
+		unsigned int msg;
+		uptr_t wParam;
+		sptr_t lParam;
+		bool isString;	///< lParam is text
+		std::string text;
+		bool operator==(const Message &other) const {
+			return (msg == other.msg) && (wParam == other.wParam) &&
+				(lParam == other.lParam) && (isString == other.isString) && (text == other.text);
+		}
+	};
+	std::vector<Message> messages;
+public:
+	void Clear() {
+		messages.clear();
+	}
+	void Send(unsigned int msg, uptr_t wParam=0, sptr_t lParam=0);
+	void SendString(unsigned int msg, uptr_t wParam, const char *text);
+	bool operator==(const StyleMessages &other) const {
+		return messages == other.messages;
+	}
+	void Apply(GUI::ScintillaWindow &win) const;
+};
+
 struct StyleAndWords {
 	int styleNumber;
 	SString words;
@@ -291,15 +348,30 @@ struct CurrentWordHighlight {
 	}
 };
 
+/**
+ * The translations read from the locale file. Each text translated is remembered with
+ * its result so that asking for it again does not allocate. The results are kept
+ * until the translations or the text for missing translations change.
+ */
 class Localization : public PropSetFile, public ILocalize {
 	SString missing;
+	struct Translation {
+		std::string text;
+		bool retainIfNotFound;
+		GUI::gui_string translated;
+	};
+	typedef std::multimap<unsigned int, Translation> Translations;
+	Translations translations;	///< By hash of the text
+	unsigned int translationsChanges;	///< Changes() when translations were last valid
+	GUI::gui_string Translate(const char *s, bool retainIfNotFound);
 public:
 	bool read;
-	Localization() : PropSetFile(true), read(false) {
+	Localization() : PropSetFile(true), translationsChanges(0), read(false) {
 	}
-	GUI::gui_string Text(const char *s, bool retainIfNotFound=true);
+	const GUI::gui_string &Text(const char *s, bool retainIfNotFound=true);
 	void SetMissing(const SString &missing_) {
 		missing = missing_;
+		translations.clear();
 	}
 };
 
@@ -377,7 +449,9 @@ protected:
 	enum { importMax = 50 };
 	std::vector<FilePath> importFiles;
 	enum { importCmdID = IDM_IMPORT };
+	enum { importThreads = 4 };
 	ImportFilter filter;
+	ImportPrefetch *importPrefetch;	///< Reads imported files on other threads
 
 	enum { indicatorMatch = INDIC_CONTAINER, indicatorHightlightCurrentWord, indicatorSentinel };
 	enum { markerBookmark = 1 };
@@ -401,7 +475,20 @@ protected:
 	int lexLPeg;
 	StringList apis;
 	SString apisFileNames;
+	APICache *apiCache;	///< Mapped file that apis may point into
 	SString functionDefinition;
+	std::map<sptr_t, WordIndex *> wordIndices;	///< Words of each document, built on first use
+	SymbolIndex *symbolIndex;	///< Words and signatures of the documents in wordIndices
+	bool autoCompleteAllBuffers;
+	FuzzyCandidates *apiCandidates;	///< Names from apis for fuzzy completion, built on first use
+	SString apiCandidatesEnds;	///< Characters that ended the names in apiCandidates
+	TagsRefresher *tagsRefresher;	///< Running tags.refresh.command
+	bool tagsRefreshPending;	///< Run tags.refresh.command again when tagsRefresher finishes
+	FilePath tagsListedFile;	///< Tags file of the tags in tagsListed
+	std::map<std::string, std::string> tagsListed;	///< Tag lines shown in the tags list by list item
+	LexerSettings lexerAppliedOutput;	///< Lexer settings sent for the output pane
+	StyleMessages stylesAppliedEditor;	///< Styles sent to wEditor
+	StyleMessages stylesAppliedOutput;	///< Styles sent to wOutput
 
 	enum { diagnosticStyleStart=256, diagnosticStyleEnd=diagnosticStyleStart+4-1};
 
@@ -453,7 +540,17 @@ protected:
 	enum { toolMax = 50 };
 	Extension *extender;
 	bool needReadProperties;
+	std::set<std::string> propertiesChanged;	///< By extensions since properties were read
+	// What parts of ReadProperties read so that changes repeat only the parts affected
+	PropertyReads readsOther;
+	PropertyReads readsKeyWords;
+	PropertyReads readsForwarded;
+	PropertyReads readsStyles;
 	bool quitting;
+	bool undoRedoLazy;
+	int stylingBufferSize;
+	bool stylingTrace;
+	StyleWriter *stylerActive;	///< While a script styles the document
 
 	int timerMask;
 	enum { timerAutoSave=1 };
@@ -479,6 +576,10 @@ protected:
 	bool callTipUseEscapes;
 	bool callTipIgnoreCase;
 	bool autoCCausedByOnlyOne;
+	bool autoCompleteFuzzy;
+	int autoCompleteFuzzyMaxItems;
+	bool autoCFuzzy;	///< The autocompletion list shown is ranked by FuzzyRanking
+	std::vector<std::string> autoCRecent;	///< Most recently chosen completions first
 	SString calltipWordCharacters;
 	SString calltipParametersStart;
 	SString calltipParametersEnd;
@@ -565,6 +666,7 @@ protected:
 
 	void ReadGlobalPropFile();
 	void ReadAbbrevPropFile();
+	void ImportDeferredProperties(const char *lexer);
 	void ReadLocalPropFile();
 	void ReadDirectoryPropFile();
 
@@ -667,6 +769,7 @@ protected:
 	virtual FilePath GetSciteUserHome() = 0;
 	FilePath GetDefaultPropertiesFileName();
 	FilePath GetUserPropertiesFileName();
+	FilePath GetPropertiesCacheFileName();
 	FilePath GetDirectoryPropertiesFileName();
 	FilePath GetLocalPropertiesFileName();
 	FilePath GetAbbrevPropertiesFileName();
@@ -729,6 +832,14 @@ protected:
 	SString FindOpenXmlTag(const char sel[], int nSize);
 	void GoMatchingBrace(bool select);
 	void GoMatchingPreprocCond(int direction, bool select);
+	FilePath TagsFilePath();
+	void GoToDefinition();
+	void ShowTagsList(const std::vector<std::string> &tags, const FilePath &tagsPath);
+	void ListTags();
+	void GoToTag(const std::string &tagLine, const FilePath &tagsPath);
+	void ContinueTagsList(const char *text);
+	void RefreshTags();
+	void TagsRefreshed(TagsRefresher *pRefresher);
 	virtual void FindReplace(bool replace) = 0;
 	void OutputAppendString(const char *s, int len = -1);
 	virtual void OutputAppendStringSynchronised(const char *s, int len = -1);
@@ -744,7 +855,14 @@ protected:
 	void ContinueCallTip();
 	virtual void EliminateDuplicateWords(char *words);
 	virtual bool StartAutoComplete();
+	WordIndex *DocumentWordIndex();
+	void UpdateWordIndex(const SCNotification *notification);
+	void DiscardWordIndex(sptr_t doc);
+	void DiscardWordIndices();
 	virtual bool StartAutoCompleteWord(bool onlyOneWord);
+	const FuzzyCandidates &APICandidates();
+	bool StartAutoCompleteFuzzy();
+	void AutoCompleteSelected(const char *text);
 	virtual bool StartExpandAbbreviation();
 	bool PerformInsertAbbreviation();
 	virtual bool StartInsertAbbreviation();
@@ -860,13 +978,19 @@ protected:
 	SString ExtensionFileName();
 	const char *GetNextPropItem(const char *pStart, char *pPropItem, int maxLen);
 	void ForwardPropertyToEditor(const char *key);
+	void ForwardPropertiesToEditor();
+	void ReadKeyWordsProperties();
 	void DefineMarker(int marker, int markerType, Colour fore, Colour back, Colour backSelected);
+	std::string APICacheFileName(const SString &apiFileNames);
 	void ReadAPI(const SString &fileNameForExtension);
 	SString FindLanguageProperty(const char *pattern, const char *defaultValue = "");
 	virtual void ReadProperties();
-	void SetOneStyle(GUI::ScintillaWindow &win, int style, const StyleDefinition &sd);
-	void SetStyleBlock(GUI::ScintillaWindow &win, const char *lang, int start, int last);
-	void SetStyleFor(GUI::ScintillaWindow &win, const char *language);
+	void ReadChangedProperties();
+	void SetOneStyle(StyleMessages &styles, int style, const StyleDefinition &sd);
+	void SetStyleBlock(StyleMessages &styles, const char *lang, int start, int last);
+	void SetStyleFor(GUI::ScintillaWindow &win, StyleMessages &styles, const char *language);
+	void ApplyStyles(GUI::ScintillaWindow &win, const StyleMessages &styles, StyleMessages &stylesApplied);
+	void ForgetAppliedSettings(GUI::ScintillaWindow &win, unsigned int msg);
 	void ReloadProperties();
 
 	void CheckReload();
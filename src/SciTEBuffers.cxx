@@ -69,6 +69,7 @@
 #include "Cookie.h"
 #include "Worker.h"
 #include "FileWorker.h"
+#include "StartupProfile.h"
 #include "SciTEBase.h"
 
 const GUI::gui_char defaultSessionFileName[] = GUI_TEXT("SciTE.session");
@@ -393,6 +394,7 @@ void SciTEBase::SwitchDocumentAt(int index, sptr_t pdoc) {
 	sptr_t pdocOld = buffers.buffers[index].doc;
 	buffers.buffers[index].doc = pdoc;
 	if (pdocOld) {
+		DiscardWordIndex(pdocOld);
 		wEditor.Call(SCI_RELEASEDOCUMENT, 0, pdocOld);
 	}
 	if (index == buffers.Current()) {
@@ -625,6 +627,7 @@ void SciTEBase::RestoreFromSession(const Session &session) {
 }
 
 void SciTEBase::RestoreSession() {
+	StartupPhase phase("RestoreSession");
 	if (props.GetInt("save.find") != 0) {
 		for (int i = 0;; i++) {
 			SString propKey = IndexPropKey("search", i, "findwhat");
@@ -1173,7 +1176,7 @@ void SciTEBase::SetBuffersMenu() {
 			}
 
 			if (buffers.buffers[pos].IsUntitled()) {
-				GUI::gui_string untitled = localiser.Text("Untitled");
+				const GUI::gui_string &untitled = localiser.Text("Untitled");
 				entry += untitled;
 				titleTab += untitled;
 			} else {
@@ -1414,7 +1417,7 @@ void SciTEBase::RemoveToolsMenu() {
 
 void SciTEBase::SetMenuItemLocalised(int menuNumber, int position, int itemID,
         const char *text, const char *mnemonic) {
-	GUI::gui_string localised = localiser.Text(text);
+	const GUI::gui_string &localised = localiser.Text(text);
 	SetMenuItem(menuNumber, position, itemID, localised.c_str(), GUI::StringFromUTF8(mnemonic).c_str());
 }
 
@@ -65,16 +65,20 @@
 #include "Cookie.h"
 #include "Worker.h"
 #include "FileWorker.h"
+#include "TagFile.h"
 #include "SciTEBase.h"
 #include "Utf8_16.h"
 
 #if defined(GTK)
 const GUI::gui_char propUserFileName[] = GUI_TEXT(".SciTEUser.properties");
+const GUI::gui_char propCacheFileName[] = GUI_TEXT(".SciTEProperties.cache");
 #elif defined(__APPLE__)
 const GUI::gui_char propUserFileName[] = GUI_TEXT("SciTEUser.properties");
+const GUI::gui_char propCacheFileName[] = GUI_TEXT("SciTEProperties.cache");
 #else
 // Windows
 const GUI::gui_char propUserFileName[] = GUI_TEXT("SciTEUser.properties");
+const GUI::gui_char propCacheFileName[] = GUI_TEXT("SciTEProperties.cache");
 #endif
 const GUI::gui_char propGlobalFileName[] = GUI_TEXT("SciTEGlobal.properties");
 const GUI::gui_char propAbbrevFileName[] = GUI_TEXT("abbrev.properties");
@@ -296,6 +300,7 @@ void SciTEBase::OpenFile(long fileSize, bool suppressMessage, bool asynchronous)
 	if (asynchronous) {
 		// Turn grey while loading
 		wEditor.Call(SCI_STYLESETBACK, STYLE_DEFAULT, 0xEEEEEE);
+		ForgetAppliedSettings(wEditor, SCI_STYLESETBACK);
 		wEditor.Call(SCI_SETREADONLY, 1);
 		assert(CurrentBuffer()->pFileWorker == NULL);
 		ILoader *pdocLoad = reinterpret_cast<ILoader *>(wEditor.CallReturnPointer(SCI_CREATELOADER, fileSize + 1000));
@@ -414,6 +419,11 @@ void SciTEBase::CompleteOpen(OpenCompletion oc) {
 
 	CurrentBuffer()->CompleteLoading();
 
+	if (autoCompleteAllBuffers) {
+		// Contribute this document's words to completion in other documents
+		DocumentWordIndex();
+	}
+
 	Redraw();
 }
 
@@ -441,6 +451,7 @@ void SciTEBase::TextWritten(FileWorker *pFileWorker) {
 			if (!buffers.GetVisible(iBuffer)) {
 				buffers.RemoveInvisible(iBuffer);
 			}
+			RefreshTags();
 			if (iBuffer == buffers.Current()) {
 				wEditor.Call(SCI_SETSAVEPOINT);
 				wEditor.Call(SCI_SETREADONLY, CurrentBuffer()->isReadOnly);
@@ -726,6 +737,165 @@ bool SciTEBase::OpenSelected() {
 	return false;
 }
 
+/**
+ * Find the tags file named by tags.file or else the file called "tags" in the
+ * directory of the current file or the nearest of its parents that has one.
+ */
+FilePath SciTEBase::TagsFilePath() {
+	SString tagsFile = props.GetExpanded("tags.file");
+	if (tagsFile.length()) {
+		FilePath path(GUI::StringFromUTF8(tagsFile.c_str()));
+		if (!path.IsAbsolute())
+			path = FilePath(filePath.Directory(), path);
+		return path.Exists() ? path : FilePath();
+	}
+	FilePath directory = filePath.Directory();
+	while (directory.IsSet()) {
+		FilePath path(directory, FilePath(GUI_TEXT("tags")));
+		if (path.Exists())
+			return path;
+		if (directory.IsRoot())
+			break;
+		directory = directory.Directory();
+	}
+	return FilePath();
+}
+
+/**
+ * Menu command "Go to Definition": go to the tag with the name of the word at the
+ * caret or let the user choose when there are several.
+ */
+void SciTEBase::GoToDefinition() {
+	SString word = SelectionWord();
+	if (word.length() == 0)
+		return;
+	FilePath tagsPath = TagsFilePath();
+	std::vector<std::string> tags;
+	if (tagsPath.IsSet())
+		tags = TagFile(tagsPath).Find(word.c_str(), word.length(), false, props.GetInt("tags.max.items", 1000));
+	if (tags.empty()) {
+		WarnUser(warnNotFound);
+		FindMessageBox("Can not find the definition of '^0'.", &word);
+	} else if (tags.size() == 1) {
+		GoToTag(tags[0], tagsPath);
+	} else {
+		ShowTagsList(tags, tagsPath);
+	}
+}
+
+void SciTEBase::ShowTagsList(const std::vector<std::string> &tags, const FilePath &tagsPath) {
+	tagsListed.clear();
+	tagsListedFile = tagsPath;
+	std::string items;
+	for (std::vector<std::string>::const_iterator it = tags.begin(); it != tags.end(); ++it) {
+		TagEntry tag;
+		if (!tag.Parse(it->c_str(), it->length()))
+			continue;
+		std::string item = tag.name;
+		if (tag.kind.length())
+			item += " [" + tag.kind + "]";
+		item += " " + tag.file;
+		// Identical items can not be told apart so only the first is shown
+		if (tagsListed.insert(std::pair<std::string, std::string>(item, *it)).second) {
+			if (items.length())
+				items += '\n';
+			items += item;
+		}
+	}
+	if (items.length()) {
+		wEditor.Call(SCI_AUTOCSETSEPARATOR, '\n');
+		wEditor.CallString(SCI_USERLISTSHOW, 1, items.c_str()); //listtype=1
+	}
+}
+
+/**
+ * Menu command "Tags...": list the tags whose names start with the word at the caret.
+ */
+void SciTEBase::ListTags() {
+	FilePath tagsPath = TagsFilePath();
+	if (!tagsPath.IsSet()) {
+		WarnUser(warnNotFound);
+		return;
+	}
+	SString word = SelectionWord();
+	std::vector<std::string> tags = TagFile(tagsPath).Find(word.c_str(), word.length(), true,
+		props.GetInt("tags.max.items", 1000));
+	if (tags.empty())
+		WarnUser(warnNotFound);
+	else
+		ShowTagsList(tags, tagsPath);
+}
+
+/**
+ * Open the file of a tag and go to its line, found by line number or by searching
+ * for the text of its pattern. Other patterns fall back to finding the tag's name.
+ */
+void SciTEBase::GoToTag(const std::string &tagLine, const FilePath &tagsPath) {
+	TagEntry tag;
+	if (!tag.Parse(tagLine.c_str(), tagLine.length()))
+		return;
+	FilePath path(GUI::StringFromUTF8(tag.file.c_str()));
+	if (!path.IsAbsolute())
+		path = FilePath(tagsPath.Directory(), path);
+	if (!Open(path, ofSynchronous))
+		return;
+	int line = tag.Line();
+	std::string pattern = tag.Pattern();
+	if ((line == 0) && pattern.length()) {
+		wEditor.Call(SCI_SETTARGETSTART, 0);
+		wEditor.Call(SCI_SETTARGETEND, LengthDocument());
+		wEditor.Call(SCI_SETSEARCHFLAGS, SCFIND_MATCHCASE);
+		int posFind = wEditor.CallString(SCI_SEARCHINTARGET, pattern.length(), pattern.c_str());
+		if (posFind >= 0)
+			line = wEditor.Call(SCI_LINEFROMPOSITION, posFind) + 1;
+	}
+	if (line > 0) {
+		GotoLineEnsureVisible(line - 1);
+	} else {
+		findWhat = tag.name.c_str();
+		FindNext(false);
+	}
+}
+
+/**
+ * User has chosen a tag in the list.
+ */
+void SciTEBase::ContinueTagsList(const char *text) {
+	std::map<std::string, std::string>::const_iterator it = tagsListed.find(text);
+	if (it != tagsListed.end())
+		GoToTag(it->second, tagsListedFile);
+}
+
+/**
+ * Run tags.refresh.command on a thread so the tags file is rewritten without
+ * waiting. If it is already running, run it again when it finishes.
+ */
+void SciTEBase::RefreshTags() {
+	SString command = props.GetExpanded("tags.refresh.command");
+	if (command.length() == 0)
+		return;
+	if (tagsRefresher) {
+		tagsRefreshPending = true;
+		return;
+	}
+	FilePath tagsPath = TagsFilePath();
+	FilePath directory = tagsPath.IsSet() ? tagsPath.Directory() : filePath.Directory();
+	tagsRefresher = new TagsRefresher(this, GUI::StringFromUTF8(command.c_str()), directory.AsInternal());
+	if (!PerformOnNewThread(tagsRefresher)) {
+		delete tagsRefresher;
+		tagsRefresher = 0;
+	}
+}
+
+void SciTEBase::TagsRefreshed(TagsRefresher *pRefresher) {
+	delete pRefresher;
+	tagsRefresher = 0;
+	if (tagsRefreshPending) {
+		tagsRefreshPending = false;
+		RefreshTags();
+	}
+}
+
 void SciTEBase::Revert() {
 	RecentFile rf = GetFilePosition();
 	OpenFile(filePath.GetFileLength(), false, false);
@@ -982,6 +1152,8 @@ bool SciTEBase::SaveBuffer(FilePath saveName, SaveFlags sf) {
 					}
 				}
 				convert.fclose();
+				if (retVal)
+					RefreshTags();
 			}
 		}
 	}
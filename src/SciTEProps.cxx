@@ -66,6 +66,12 @@ const GUI::gui_char menuAccessIndicator[] = GUI_TEXT("&");
 #include "JobQueue.h"
 #include "Cookie.h"
 #include "Worker.h"
+#include "FuzzyMatch.h"
+#include "MappedFile.h"
+#include "APICache.h"
+#include "PropertiesCache.h"
+#include "ImportPrefetch.h"
+#include "StartupProfile.h"
 #include "SciTEBase.h"
 
 void SciTEBase::SetImportMenu() {
@@ -121,6 +127,8 @@ const GUI::gui_char propDirectoryFileName[] = GUI_TEXT("SciTEDirectory.propertie
 Read global and user properties files.
 */
 void SciTEBase::ReadGlobalPropFile() {
+	StartupPhase phase("ReadGlobalPropFile");
+	importPrefetch->Forget();
 #if defined(__unix__)
 	extern char **environ;
 	char **e=environ;
@@ -138,37 +146,90 @@ void SciTEBase::ReadGlobalPropFile() {
 		}
 	}
 
-	SString excludes;
-	SString includes;
+	FilePath propfileBase = GetDefaultPropertiesFileName();
+	FilePath propfileUser = GetUserPropertiesFileName();
+	FilePath propfileCache = GetPropertiesCacheFileName();
+	std::vector<PropSetFile *> propsCached;
+	propsCached.push_back(&propsBase);
+	propsCached.push_back(&propsUser);
+
+	// The cache is only good when it was read with the import filter that its properties give
+	PropertiesCache cache;
+	if (cache.Load(propfileCache, propsEmbed, propsCached, importFiles) &&
+		(props.Get("imports.exclude") == cache.excludes) &&
+		(props.Get("imports.include") == cache.includes) &&
+		((props.GetInt("imports.lazy") != 0) == cache.lazy)) {
+		filter.SetFilter(cache.excludes.c_str(), cache.includes.c_str());
+		filter.lazy = cache.lazy;
+	} else {
+		SString excludes;
+		SString includes;
+		bool lazy = false;
 
-	for (int attempt=0; attempt<2; attempt++) {
+		PropSetFile::CollectConditions(&cache.conditions);
+		for (int attempt=0; attempt<2; attempt++) {
 
-		SString excludesRead = props.Get("imports.exclude");
-		SString includesRead = props.Get("imports.include");
-		if ((attempt > 0) && ((excludesRead == excludes) && (includesRead == includes)))
-			break;
+			SString excludesRead = props.Get("imports.exclude");
+			SString includesRead = props.Get("imports.include");
+			bool lazyRead = props.GetInt("imports.lazy") != 0;
+			if ((attempt > 0) && ((excludesRead == excludes) && (includesRead == includes) && (lazyRead == lazy)))
+				break;
+
+			excludes = excludesRead;
+			includes = includesRead;
+			lazy = lazyRead;
 
-		excludes = excludesRead;
-		includes = includesRead;
+			filter.SetFilter(excludes.c_str(), includes.c_str());
+			filter.lazy = lazy;
 
-		filter.SetFilter(excludes.c_str(), includes.c_str());
+			importFiles.clear();
 
-		importFiles.clear();
+			// The user file is read on another thread while the global file is read here
+			importPrefetch->Request(propfileUser);
 
-		propsBase.Clear();
-		FilePath propfileBase = GetDefaultPropertiesFileName();
-		propsBase.Read(propfileBase, propfileBase.Directory(), filter, &importFiles);
+			propsBase.Clear();
+			propsBase.Read(propfileBase, propfileBase.Directory(), filter, &importFiles);
 
-		propsUser.Clear();
-		FilePath propfileUser = GetUserPropertiesFileName();
-		propsUser.Read(propfileUser, propfileUser.Directory(), filter, &importFiles);
+			propsUser.Clear();
+			propsUser.Read(propfileUser, propfileUser.Directory(), filter, &importFiles);
+		}
+		PropSetFile::CollectConditions(0);
+
+		if (props.GetInt("properties.cache")) {
+			cache.excludes = excludes;
+			cache.includes = includes;
+			cache.lazy = lazy;
+			cache.filesRead.clear();
+			cache.filesRead.push_back(propfileBase);
+			cache.filesRead.push_back(propfileUser);
+			cache.filesRead.insert(cache.filesRead.end(), importFiles.begin(), importFiles.end());
+			cache.directories.clear();
+			cache.directories.push_back(propfileBase.Directory());
+			if (!(propfileUser.Directory() == propfileBase.Directory()))
+				cache.directories.push_back(propfileUser.Directory());
+			cache.Save(propfileCache, propsEmbed, propsCached, importFiles);
+		} else if (propfileCache.Exists()) {
+			propfileCache.Remove();
+		}
 	}
 
 	if (!localiser.read) {
+		StartupPhase phaseLocalization("ReadLocalization");
 		ReadLocalization();
 	}
 }
 
+/**
+ * Read the language files deferred by imports.lazy that set properties for @a lexer
+ * into each property set that deferred them.
+ */
+void SciTEBase::ImportDeferredProperties(const char *lexer) {
+	if (!*lexer)
+		return;
+	for (PropSetFile *psf = &props; psf; psf = psf->superPS)
+		psf->ImportDeferred(lexer, filter);
+}
+
 void SciTEBase::ReadAbbrevPropFile() {
 	propsAbbrev.Clear();
 	propsAbbrev.Read(pathAbbreviations, pathAbbreviations.Directory(), filter, &importFiles);
@@ -406,51 +467,118 @@ bool StyleDefinition::IsBold() const {
 	return weight > SC_WEIGHT_NORMAL;
 }
 
-void SciTEBase::SetOneStyle(GUI::ScintillaWindow &win, int style, const StyleDefinition &sd) {
+void StyleMessages::Send(unsigned int msg, uptr_t wParam, sptr_t lParam) {
+	Message message;
+	message.msg = msg;
+	message.wParam = wParam;
+	message.lParam = lParam;
+	message.isString = false;
+	messages.push_back(message);
+}
+
+void StyleMessages::SendString(unsigned int msg, uptr_t wParam, const char *text) {
+	Send(msg, wParam, 0);
+	messages.back().isString = true;
+	messages.back().text = text;
+}
+
+void StyleMessages::Apply(GUI::ScintillaWindow &win) const {
+	for (std::vector<Message>::const_iterator it = messages.begin(); it != messages.end(); ++it) {
+		if (it->isString)
+			win.CallString(it->msg, it->wParam, it->text.c_str());
+		else
+			win.Call(it->msg, it->wParam, it->lParam);
+	}
+}
+
+void LexerSettings::Clear() {
+	doc = 0;
+	language = "";
+	keyWords.clear();
+	properties.clear();
+}
+
+/**
+ * Forget the settings when they were sent for another document or for another lexer
+ * as a new lexer starts without keywords or properties.
+ */
+void LexerSettings::Use(sptr_t doc_, const SString &language_) {
+	if ((doc != doc_) || (language != language_)) {
+		Clear();
+		doc = doc_;
+		language = language_;
+	}
+}
+
+/// Record the keywords, returning true if they differ from those sent before.
+bool LexerSettings::SetKeyWords(int keyWordSet, const SString &keyWords_) {
+	std::map<int, std::string>::iterator it = keyWords.find(keyWordSet);
+	if ((it != keyWords.end()) && (it->second == keyWords_.c_str()))
+		return false;
+	keyWords[keyWordSet] = keyWords_.c_str();
+	return true;
+}
+
+/// Record the property, returning true if it differs from that sent before.
+bool LexerSettings::SetProperty(const char *key, const SString &value) {
+	std::map<std::string, std::string>::iterator it = properties.find(key);
+	if ((it != properties.end()) && (it->second == value.c_str()))
+		return false;
+	properties[key] = value.c_str();
+	return true;
+}
+
+void SciTEBase::SetOneStyle(StyleMessages &styles, int style, const StyleDefinition &sd) {
 	if (sd.specified & StyleDefinition::sdItalics)
-		win.Send(SCI_STYLESETITALIC, style, sd.italics ? 1 : 0);
+		styles.Send(SCI_STYLESETITALIC, style, sd.italics ? 1 : 0);
 	if (sd.specified & StyleDefinition::sdWeight)
-		win.Send(SCI_STYLESETWEIGHT, style, sd.weight);
+		styles.Send(SCI_STYLESETWEIGHT, style, sd.weight);
 	if (sd.specified & StyleDefinition::sdFont)
-		win.SendPointer(SCI_STYLESETFONT, style,
-			const_cast<char *>(sd.font.c_str()));
+		styles.SendString(SCI_STYLESETFONT, style, sd.font.c_str());
 	if (sd.specified & StyleDefinition::sdFore)
-		win.Send(SCI_STYLESETFORE, style, sd.ForeAsLong());
+		styles.Send(SCI_STYLESETFORE, style, sd.ForeAsLong());
 	if (sd.specified & StyleDefinition::sdBack)
-		win.Send(SCI_STYLESETBACK, style, sd.BackAsLong());
+		styles.Send(SCI_STYLESETBACK, style, sd.BackAsLong());
 	if (sd.specified & StyleDefinition::sdSize)
-		win.Send(SCI_STYLESETSIZEFRACTIONAL, style, sd.FractionalSize());
+		styles.Send(SCI_STYLESETSIZEFRACTIONAL, style, sd.FractionalSize());
 	if (sd.specified & StyleDefinition::sdEOLFilled)
-		win.Send(SCI_STYLESETEOLFILLED, style, sd.eolfilled ? 1 : 0);
+		styles.Send(SCI_STYLESETEOLFILLED, style, sd.eolfilled ? 1 : 0);
 	if (sd.specified & StyleDefinition::sdUnderlined)
-		win.Send(SCI_STYLESETUNDERLINE, style, sd.underlined ? 1 : 0);
+		styles.Send(SCI_STYLESETUNDERLINE, style, sd.underlined ? 1 : 0);
 	if (sd.specified & StyleDefinition::sdCaseForce)
-		win.Send(SCI_STYLESETCASE, style, sd.caseForce);
+		styles.Send(SCI_STYLESETCASE, style, sd.caseForce);
 	if (sd.specified & StyleDefinition::sdVisible)
-		win.Send(SCI_STYLESETVISIBLE, style, sd.visible ? 1 : 0);
+		styles.Send(SCI_STYLESETVISIBLE, style, sd.visible ? 1 : 0);
 	if (sd.specified & StyleDefinition::sdChangeable)
-		win.Send(SCI_STYLESETCHANGEABLE, style, sd.changeable ? 1 : 0);
-	win.Send(SCI_STYLESETCHARACTERSET, style, characterSet);
+		styles.Send(SCI_STYLESETCHANGEABLE, style, sd.changeable ? 1 : 0);
+	styles.Send(SCI_STYLESETCHARACTERSET, style, characterSet);
 }
 
-void SciTEBase::SetStyleBlock(GUI::ScintillaWindow &win, const char *lang, int start, int last) {
+void SciTEBase::SetStyleBlock(StyleMessages &styles, const char *lang, int start, int last) {
 	for (int style = start; style <= last; style++) {
 		if (style != STYLE_DEFAULT) {
 			char key[200];
 			sprintf(key, "style.%s.%0d", lang, style-start);
 			SString sval = props.GetExpanded(key);
 			if (sval.length()) {
-				SetOneStyle(win, style, sval.c_str());
+				SetOneStyle(styles, style, sval.c_str());
 			}
 		}
 	}
 }
 
-void SciTEBase::SetStyleFor(GUI::ScintillaWindow &win, const char *lang) {
+void SciTEBase::SetStyleFor(GUI::ScintillaWindow &win, StyleMessages &styles, const char *lang) {
 	int maxStyle = (1 << win.Call(SCI_GETSTYLEBITS)) - 1;
 	if (maxStyle < STYLE_LASTPREDEFINED)
 		maxStyle = STYLE_LASTPREDEFINED;
-	SetStyleBlock(win, lang, 0, maxStyle);
+	SetStyleBlock(styles, lang, 0, maxStyle);
+}
+
+void SciTEBase::ApplyStyles(GUI::ScintillaWindow &win, const StyleMessages &styles, StyleMessages &stylesApplied) {
+	if (!(styles == stylesApplied)) {
+		styles.Apply(win);
+		stylesApplied = styles;
+	}
 }
 
 SString SciTEBase::ExtensionFileName() {
@@ -477,10 +605,12 @@ SString SciTEBase::ExtensionFileName() {
 void SciTEBase::ForwardPropertyToEditor(const char *key) {
 	if (props.Exists(key)) {
 		SString value = props.GetExpanded(key);
-		wEditor.CallString(SCI_SETPROPERTY,
-						 reinterpret_cast<uptr_t>(key), value.c_str());
-		wOutput.CallString(SCI_SETPROPERTY,
-						 reinterpret_cast<uptr_t>(key), value.c_str());
+		if (CurrentBuffer()->lexerApplied.SetProperty(key, value))
+			wEditor.CallString(SCI_SETPROPERTY,
+							 reinterpret_cast<uptr_t>(key), value.c_str());
+		if (lexerAppliedOutput.SetProperty(key, value))
+			wOutput.CallString(SCI_SETPROPERTY,
+							 reinterpret_cast<uptr_t>(key), value.c_str());
 	}
 }
 
@@ -502,15 +632,49 @@ static long FileLength(const char *path) {
 	return len;
 }
 
+/**
+ * Name a cache file for a set of API files, distinguished by a hash of their names.
+ * Caching is off unless api.cache.directory is set.
+ */
+std::string SciTEBase::APICacheFileName(const SString &apiFileNames) {
+	SString directory = props.GetExpanded("api.cache.directory");
+	if (directory.length() == 0)
+		return std::string();
+	// FNV-1a
+	unsigned int hash = 2166136261u;
+	for (size_t i = 0; i < apiFileNames.length(); i++) {
+		hash ^= static_cast<unsigned char>(apiFileNames[i]);
+		hash *= 16777619u;
+	}
+	char name[100];
+	sprintf(name, "SciTE-%08x.apicache", hash);
+	FilePath cacheFile(GUI::StringFromUTF8(directory.c_str()), GUI::StringFromUTF8(name));
+	return cacheFile.AsUTF8();
+}
+
 void SciTEBase::ReadAPI(const SString &fileNameForExtension) {
 	SString sApiFileNames = props.GetNewExpand("api.",
 	                        fileNameForExtension.c_str());
 	size_t nameLength = sApiFileNames.length();
 	if (nameLength) {
+		std::string cacheFileName = APICacheFileName(sApiFileNames);
 		sApiFileNames.substitute(';', '\0');
 		const char *apiFileName = sApiFileNames.c_str();
 		const char *nameEnd = apiFileName + nameLength;
 
+		std::string signature;
+		if (!cacheFileName.empty()) {
+			std::vector<std::string> apiFileNames;
+			for (; apiFileName < nameEnd; apiFileName += strlen(apiFileName) + 1)
+				apiFileNames.push_back(apiFileName);
+			signature = APICache::Signature(apiFileNames);
+			if (!apiCache)
+				apiCache = new APICache();
+			if (apiCache->Load(cacheFileName.c_str(), signature, apis))
+				return;
+			apiFileName = sApiFileNames.c_str();
+		}
+
 		size_t tlen = 0;    // total api length
 
 		// Calculate total length
@@ -538,6 +702,8 @@ void SciTEBase::ReadAPI(const SString &fileNameForExtension) {
 					apiFileName += strlen(apiFileName) + 1;
 				}
 				apis.SetFromAllocated();
+				if (!cacheFileName.empty() && !signature.empty())
+					APICache::Save(cacheFileName.c_str(), signature, apis);
 			}
 		}
 	}
@@ -656,6 +822,14 @@ static const char *propertiesToForward[] = {
 	0,
 };
 
+void SciTEBase::ForwardPropertiesToEditor() {
+	readsForwarded.Clear();
+	RecordingReads recording(readsForwarded);
+	for (size_t i=0; propertiesToForward[i]; i++) {
+		ForwardPropertyToEditor(propertiesToForward[i]);
+	}
+}
+
 /* XPM */
 static const char *bookmarkBluegem[] = {
 /* width height num_colors chars_per_pixel */
@@ -756,6 +930,10 @@ SString SciTEBase::GetFileNameProperty(const char *name) {
 }
 
 void SciTEBase::ReadProperties() {
+	StartupPhase phase("ReadProperties");
+	readsOther.Clear();
+	RecordingReads recording(readsOther);
+
 	if (extender)
 		extender->Clear();
 
@@ -766,6 +944,8 @@ void SciTEBase::ReadProperties() {
 	if (modulePath.length())
 	    wEditor.CallString(SCI_LOADLEXERLIBRARY, 0, modulePath.c_str());
 	language = props.GetNewExpand("lexer.", fileNameForExtension.c_str());
+	ImportDeferredProperties(language.c_str());
+	ImportDeferredProperties("errorlist");
 	if (language.length()) {
 		if (language.startswith("script_")) {
 			wEditor.Call(SCI_SETLEXER, SCLEX_CONTAINER);
@@ -797,28 +977,26 @@ void SciTEBase::ReadProperties() {
 
 	wOutput.Call(SCI_SETLEXER, SCLEX_ERRORLIST);
 
-	SString kw0 = props.GetNewExpand("keywords.", fileNameForExtension.c_str());
-	wEditor.CallString(SCI_SETKEYWORDS, 0, kw0.c_str());
+	// Only send the lexer settings that differ from those already sent for the document
+	LexerSettings &lexerApplied = CurrentBuffer()->lexerApplied;
+	lexerApplied.Use(wEditor.Call(SCI_GETDOCPOINTER), language);
+	lexerAppliedOutput.Use(wOutput.Call(SCI_GETDOCPOINTER), "errorlist");
 
-	for (int wl = 1; wl <= KEYWORDSET_MAX; wl++) {
-		SString kwk(wl+1);
-		kwk += '.';
-		kwk.insert(0, "keywords");
-		SString kw = props.GetNewExpand(kwk.c_str(), fileNameForExtension.c_str());
-		wEditor.CallString(SCI_SETKEYWORDS, wl, kw.c_str());
-	}
+	ReadKeyWordsProperties();
 
 	FilePath homepath = GetSciteDefaultHome();
 	props.Set("SciteDefaultHome", homepath.AsUTF8().c_str());
 	homepath = GetSciteUserHome();
 	props.Set("SciteUserHome", homepath.AsUTF8().c_str());
 
-	for (size_t i=0; propertiesToForward[i]; i++) {
-		ForwardPropertyToEditor(propertiesToForward[i]);
-	}
+	ForwardPropertiesToEditor();
 
 	if (apisFileNames != props.GetNewExpand("api.",	fileNameForExtension.c_str())) {
 		apis.Clear();
+		if (apiCache)
+			apiCache->Close();
+		delete apiCandidates;
+		apiCandidates = 0;
 		ReadAPI(fileNameForExtension);
 		apisFileNames = props.GetNewExpand("api.", fileNameForExtension.c_str());
 	}
@@ -1038,6 +1216,15 @@ void SciTEBase::ReadProperties() {
 	wEditor.Call(SCI_AUTOCSETIGNORECASE, autoCompleteIgnoreCase ? 1 : 0);
 	wOutput.Call(SCI_AUTOCSETIGNORECASE, 1);
 
+	autoCompleteFuzzy = FindLanguageProperty("autocomplete.*.fuzzy") == "1";
+	autoCompleteFuzzyMaxItems = props.GetInt("autocomplete.fuzzy.max.items", 100);
+	bool allBuffers = props.GetInt("autocomplete.all.buffers") != 0;
+	if (allBuffers != autoCompleteAllBuffers) {
+		// Indices feed the shared index or not depending on this setting
+		DiscardWordIndices();
+		autoCompleteAllBuffers = allBuffers;
+	}
+
 	int autoCChooseSingle = props.GetInt("autocomplete.choose.single");
 	wEditor.Call(SCI_AUTOCSETCHOOSESINGLE, autoCChooseSingle);
 
@@ -1187,13 +1374,17 @@ void SciTEBase::ReadProperties() {
 	// To put the folder markers in the line number region
 	//wEditor.Call(SCI_SETMARGINMASKN, 0, SC_MASK_FOLDERS);
 
-	wEditor.Call(SCI_SETMODEVENTMASK, SC_MOD_CHANGEFOLD);
+	// Insert/delete notifications keep the word index of the document up to date
+	wEditor.Call(SCI_SETMODEVENTMASK, SC_MOD_CHANGEFOLD | SC_MOD_INSERTTEXT | SC_MOD_DELETETEXT);
+
+	stylingBufferSize = props.GetInt("styling.buffer.size", StyleWriter::defaultStyleBufferSize);
+	stylingTrace = props.GetInt("styling.trace") != 0;
 
-	if (0==props.GetInt("undo.redo.lazy")) {
+	undoRedoLazy = props.GetInt("undo.redo.lazy") != 0;
+	if (!undoRedoLazy) {
 		// Trap for insert/delete notifications (also fired by undo
 		// and redo) so that the buttons can be enabled if needed.
-		wEditor.Call(SCI_SETMODEVENTMASK, SC_MOD_INSERTTEXT | SC_MOD_DELETETEXT
-			| SC_LASTSTEPINUNDOREDO | wEditor.Call(SCI_GETMODEVENTMASK, 0));
+		wEditor.Call(SCI_SETMODEVENTMASK, SC_LASTSTEPINUNDOREDO | wEditor.Call(SCI_GETMODEVENTMASK, 0));
 
 		//SC_LASTSTEPINUNDOREDO is probably not needed in the mask; it
 		//doesn't seem to fire as an event of its own; just modifies the
@@ -1380,9 +1571,60 @@ void SciTEBase::ReadProperties() {
 
 	firstPropertiesRead = false;
 	needReadProperties = false;
+	propertiesChanged.clear();
+}
+
+void SciTEBase::ReadKeyWordsProperties() {
+	readsKeyWords.Clear();
+	RecordingReads recording(readsKeyWords);
+
+	SString fileNameForExtension = ExtensionFileName();
+	LexerSettings &lexerApplied = CurrentBuffer()->lexerApplied;
+
+	SString kw0 = props.GetNewExpand("keywords.", fileNameForExtension.c_str());
+	if (lexerApplied.SetKeyWords(0, kw0))
+		wEditor.CallString(SCI_SETKEYWORDS, 0, kw0.c_str());
+
+	for (int wl = 1; wl <= KEYWORDSET_MAX; wl++) {
+		SString kwk(wl+1);
+		kwk += '.';
+		kwk.insert(0, "keywords");
+		SString kw = props.GetNewExpand(kwk.c_str(), fileNameForExtension.c_str());
+		if (lexerApplied.SetKeyWords(wl, kw))
+			wEditor.CallString(SCI_SETKEYWORDS, wl, kw.c_str());
+	}
+}
+
+/**
+ * Apply the properties changed by extensions since properties were read by repeating
+ * only the parts of ReadProperties that read them or properties referring to them.
+ * Properties that ReadProperties did not read are looked up when they are used.
+ */
+void SciTEBase::ReadChangedProperties() {
+	if (firstPropertiesRead) {
+		ReadProperties();
+		return;
+	}
+	std::set<std::string> changed;
+	changed.swap(propertiesChanged);
+	props.AddReferrers(changed);
+	if (readsOther.IncludesAny(changed, props)) {
+		ReadProperties();
+		return;
+	}
+	if (readsKeyWords.IncludesAny(changed, props))
+		ReadKeyWordsProperties();
+	if (readsForwarded.IncludesAny(changed, props))
+		ForwardPropertiesToEditor();
+	if (readsStyles.IncludesAny(changed, props))
+		ReadFontProperties();
+	needReadProperties = false;
 }
 
 void SciTEBase::ReadFontProperties() {
+	readsStyles.Clear();
+	RecordingReads recording(readsStyles);
+
 	char key[200];
 	SString sval;
 	const char *languageName = language.c_str();
@@ -1400,42 +1642,46 @@ void SciTEBase::ReadFontProperties() {
 
 	// Set styles
 	// For each window set the global default style, then the language default style, then the other global styles, then the other language styles
+	// The messages are only sent when they differ from those last sent to the window
 
-	wEditor.Call(SCI_STYLERESETDEFAULT, 0, 0);
-	wOutput.Call(SCI_STYLERESETDEFAULT, 0, 0);
+	StyleMessages stylesEditor;
+	StyleMessages stylesOutput;
+
+	stylesEditor.Send(SCI_STYLERESETDEFAULT, 0, 0);
+	stylesOutput.Send(SCI_STYLERESETDEFAULT, 0, 0);
 
 	sprintf(key, "style.%s.%0d", "*", STYLE_DEFAULT);
 	sval = props.GetNewExpand(key);
-	SetOneStyle(wEditor, STYLE_DEFAULT, sval.c_str());
-	SetOneStyle(wOutput, STYLE_DEFAULT, sval.c_str());
+	SetOneStyle(stylesEditor, STYLE_DEFAULT, sval.c_str());
+	SetOneStyle(stylesOutput, STYLE_DEFAULT, sval.c_str());
 
 	sprintf(key, "style.%s.%0d", languageName, STYLE_DEFAULT);
 	sval = props.GetNewExpand(key);
-	SetOneStyle(wEditor, STYLE_DEFAULT, sval.c_str());
+	SetOneStyle(stylesEditor, STYLE_DEFAULT, sval.c_str());
 
-	wEditor.Call(SCI_STYLECLEARALL, 0, 0);
+	stylesEditor.Send(SCI_STYLECLEARALL, 0, 0);
 
-	SetStyleFor(wEditor, "*");
-	SetStyleFor(wEditor, languageName);
+	SetStyleFor(wEditor, stylesEditor, "*");
+	SetStyleFor(wEditor, stylesEditor, languageName);
 	if (props.GetInt("error.inline")) {
-		wEditor.Send(SCI_STYLESETFORE, diagnosticStyleEnd, 0);	// Ensure styles allocated
-		SetStyleBlock(wEditor, "error", diagnosticStyleStart, diagnosticStyleEnd);
+		stylesEditor.Send(SCI_STYLESETFORE, diagnosticStyleEnd, 0);	// Ensure styles allocated
+		SetStyleBlock(stylesEditor, "error", diagnosticStyleStart, diagnosticStyleEnd);
 	}
 
 	// Turn grey while loading
 	if (CurrentBuffer()->lifeState == Buffer::reading)
-		wEditor.Call(SCI_STYLESETBACK, STYLE_DEFAULT, 0xEEEEEE);
+		stylesEditor.Send(SCI_STYLESETBACK, STYLE_DEFAULT, 0xEEEEEE);
 
-	wOutput.Call(SCI_STYLECLEARALL, 0, 0);
+	stylesOutput.Send(SCI_STYLECLEARALL, 0, 0);
 
 	sprintf(key, "style.%s.%0d", "errorlist", STYLE_DEFAULT);
 	sval = props.GetNewExpand(key);
-	SetOneStyle(wOutput, STYLE_DEFAULT, sval.c_str());
+	SetOneStyle(stylesOutput, STYLE_DEFAULT, sval.c_str());
 
-	wOutput.Call(SCI_STYLECLEARALL, 0, 0);
+	stylesOutput.Send(SCI_STYLECLEARALL, 0, 0);
 
-	SetStyleFor(wOutput, "*");
-	SetStyleFor(wOutput, "errorlist");
+	SetStyleFor(wOutput, stylesOutput, "*");
+	SetStyleFor(wOutput, stylesOutput, "errorlist");
 
 	if (CurrentBuffer()->useMonoFont) {
 		sval = props.GetExpanded("font.monospace");
@@ -1443,14 +1689,17 @@ void SciTEBase::ReadFontProperties() {
 		for (int style = 0; style <= STYLE_MAX; style++) {
 			if (style != STYLE_LINENUMBER) {
 				if (sd.specified & StyleDefinition::sdFont) {
-					wEditor.CallString(SCI_STYLESETFONT, style, sd.font.c_str());
+					stylesEditor.SendString(SCI_STYLESETFONT, style, sd.font.c_str());
 				}
 				if (sd.specified & StyleDefinition::sdSize) {
-					wEditor.Call(SCI_STYLESETSIZEFRACTIONAL, style, sd.FractionalSize());
+					stylesEditor.Send(SCI_STYLESETSIZEFRACTIONAL, style, sd.FractionalSize());
 				}
 			}
 		}
 	}
+
+	ApplyStyles(wEditor, stylesEditor, stylesAppliedEditor);
+	ApplyStyles(wOutput, stylesOutput, stylesAppliedOutput);
 }
 
 // Properties that are interactively modifiable are only read from the properties file once.
@@ -1484,7 +1733,7 @@ void SciTEBase::SetPropertiesInitial() {
 	focusOnReplace = props.GetInt("find.replacewith.focus", 1);
 }
 
-GUI::gui_string Localization::Text(const char *s, bool retainIfNotFound) {
+GUI::gui_string Localization::Translate(const char *s, bool retainIfNotFound) {
 	const char *utfEllipse = "\xe2\x80\xa6";	// A UTF-8 ellipse
 	SString translation = s;
 	int ellipseIndicator = translation.remove("...");
@@ -1526,6 +1775,37 @@ GUI::gui_string Localization::Text(const char *s, bool retainIfNotFound) {
 	return GUI::StringFromUTF8(s);
 }
 
+/// FNV-1a hash of a NUL terminated string.
+static unsigned int HashText(const char *s) {
+	unsigned int hash = 2166136261u;
+	for (; *s; s++) {
+		hash ^= static_cast<unsigned char>(*s);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Translate @a s, returning a string that stays valid until the translations change.
+ */
+const GUI::gui_string &Localization::Text(const char *s, bool retainIfNotFound) {
+	if (translationsChanges != Changes()) {
+		translations.clear();
+		translationsChanges = Changes();
+	}
+	const unsigned int hash = HashText(s);
+	std::pair<Translations::iterator, Translations::iterator> range = translations.equal_range(hash);
+	for (Translations::iterator it = range.first; it != range.second; ++it) {
+		if ((it->second.retainIfNotFound == retainIfNotFound) && (it->second.text == s))
+			return it->second.translated;
+	}
+	Translation translation;
+	translation.text = s;
+	translation.retainIfNotFound = retainIfNotFound;
+	translation.translated = Translate(s, retainIfNotFound);
+	return translations.insert(std::make_pair(hash, translation))->second.translated;
+}
+
 GUI::gui_string SciTEBase::LocaliseMessage(const char *s, const GUI::gui_char *param0, const GUI::gui_char *param1, const GUI::gui_char *param2) {
 	GUI::gui_string translation = localiser.Text(s);
 	if (param0)
@@ -1644,6 +1924,10 @@ FilePath SciTEBase::GetUserPropertiesFileName() {
 	return FilePath(GetSciteUserHome(), propUserFileName);
 }
 
+FilePath SciTEBase::GetPropertiesCacheFileName() {
+	return FilePath(GetSciteUserHome(), propCacheFileName);
+}
+
 FilePath SciTEBase::GetLocalPropertiesFileName() {
 	return FilePath(filePath.Directory(), propLocalFileName);
 }
@@ -0,0 +1,156 @@
+// SciTE - Scintilla based Text Editor
+/** @file StartupProfile.cxx
+ ** Implementation of the timing of the phases of starting SciTE.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+// Turn off MS dislike of POSIX
+#pragma warning(disable: 4996)
+#endif
+
+#include "Scintilla.h"
+
+#include "GUI.h"
+#include "StartupProfile.h"
+#include "SciTE.h"
+
+namespace {
+
+struct Phase {
+	std::string name;
+	std::string detail;
+	double start;
+	double duration;
+	int depth;
+};
+
+// Returned by Begin when not profiling so End ignores it
+const size_t noPhase = static_cast<size_t>(-1);
+
+// Started during static initialization so is close to the start of the process
+GUI::ElapsedTime sinceStart;
+bool checked = false;
+bool enabled = false;
+bool reported = false;
+int depth = 0;
+std::vector<Phase> phases;
+
+double Now() {
+	// Copy so that the clock is not reset
+	GUI::ElapsedTime clock = sinceStart;
+	return clock.Duration();
+}
+
+void AppendJSONString(std::string &s, const std::string &text) {
+	s += '\"';
+	for (size_t i = 0; i < text.length(); i++) {
+		const unsigned char ch = static_cast<unsigned char>(text[i]);
+		if ((ch == '\"') || (ch == '\\')) {
+			s += '\\';
+			s += ch;
+		} else if (ch < 0x20) {
+			char escaped[10];
+			sprintf(escaped, "\\u%04x", ch);
+			s += escaped;
+		} else {
+			s += ch;
+		}
+	}
+	s += '\"';
+}
+
+void AppendMilliseconds(std::string &s, double seconds) {
+	char number[40];
+	sprintf(number, "%.3f", seconds * 1000.0);
+	s += number;
+}
+
+}
+
+bool StartupProfile::Enabled() {
+	if (!checked) {
+		checked = true;
+		const char *destination = getenv("SCITE_PROFILE_STARTUP");
+		enabled = destination && *destination;
+	}
+	return enabled && !reported;
+}
+
+/// Start timing a phase, returning the value to pass to End when it finishes.
+size_t StartupProfile::Begin(const char *name, const char *detail) {
+	if (!Enabled())
+		return noPhase;
+	Phase phase;
+	phase.name = name;
+	if (detail)
+		phase.detail = detail;
+	phase.depth = depth++;
+	phase.duration = 0.0;
+	phase.start = Now();
+	phases.push_back(phase);
+	return phases.size() - 1;
+}
+
+void StartupProfile::End(size_t phase) {
+	if ((phase == noPhase) || (phase >= phases.size()) || reported)
+		return;
+	phases[phase].duration = Now() - phases[phase].start;
+	depth--;
+}
+
+/**
+ * Write the phases as JSON then stop profiling. Times are in milliseconds with "start"
+ * relative to the start of the process and "total" the time until the report.
+ */
+void StartupProfile::Report() {
+	if (!Enabled())
+		return;
+	const double total = Now();
+	reported = true;
+	std::string json = "{\n\"version\": ";
+	AppendJSONString(json, VERSION_SCITE);
+	json += ",\n\"total\": ";
+	AppendMilliseconds(json, total);
+	json += ",\n\"phases\": [";
+	for (size_t i = 0; i < phases.size(); i++) {
+		json += (i == 0) ? "\n" : ",\n";
+		json += "{\"name\": ";
+		AppendJSONString(json, phases[i].name);
+		if (phases[i].detail.length()) {
+			json += ", \"detail\": ";
+			AppendJSONString(json, phases[i].detail);
+		}
+		json += ", \"start\": ";
+		AppendMilliseconds(json, phases[i].start);
+		json += ", \"duration\": ";
+		AppendMilliseconds(json, phases[i].duration);
+		char depthText[40];
+		sprintf(depthText, ", \"depth\": %d}", phases[i].depth);
+		json += depthText;
+	}
+	json += "\n]\n}\n";
+	phases.clear();
+
+	const std::string destination = getenv("SCITE_PROFILE_STARTUP");
+	if ((destination == "-") || (destination == "1") || (destination == "stderr")) {
+		fputs(json.c_str(), stderr);
+		fflush(stderr);
+	} else {
+		FILE *fp = fopen(destination.c_str(), "wb");
+		if (fp) {
+			fwrite(json.c_str(), 1, json.length(), fp);
+			fclose(fp);
+		} else {
+			fprintf(stderr, "SciTE: can not write startup profile to %s\n", destination.c_str());
+		}
+	}
+}
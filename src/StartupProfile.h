@@ -0,0 +1,42 @@
+// SciTE - Scintilla based Text Editor
+/** @file StartupProfile.h
+ ** Definition of the timing of the phases of starting SciTE.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef STARTUPPROFILE_H
+#define STARTUPPROFILE_H
+
+/**
+ * Records when each phase of starting up began and how long it took, measured from
+ * when the process started on a clock that does not follow changes to the time of day.
+ * Phases may nest, such as each properties file read inside ReadGlobalPropFile.
+ * Only active when the SCITE_PROFILE_STARTUP environment variable is set and then
+ * only until Report writes the phases as JSON: to stderr when the variable is "-",
+ * "1" or "stderr", otherwise to the file it names.
+ */
+class StartupProfile {
+public:
+	static bool Enabled();
+	static size_t Begin(const char *name, const char *detail=0);
+	static void End(size_t phase);
+	static void Report();
+};
+
+/// Times the phase for the lifetime of this object.
+class StartupPhase {
+	size_t phase;
+	// Private so StartupPhase objects can not be copied
+	StartupPhase(const StartupPhase &);
+	StartupPhase &operator=(const StartupPhase &);
+public:
+	explicit StartupPhase(const char *name, const char *detail=0) :
+		phase(StartupProfile::Begin(name, detail)) {
+	}
+	~StartupPhase() {
+		StartupProfile::End(phase);
+	}
+};
+
+#endif
@@ -15,7 +15,7 @@ unsigned int UnSlashLowOctal(char *s);
 
 class ILocalize {
 public:
-	virtual GUI::gui_string Text(const char *s, bool retainIfNotFound=true) = 0;
+	virtual const GUI::gui_string &Text(const char *s, bool retainIfNotFound=true) = 0;
 };
 
 /**
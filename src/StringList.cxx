@@ -91,7 +91,8 @@ static char **ArrayFromStringList(char *StringList, int *len, bool onlyLineEnds
 
 void StringList::Clear() {
 	if (words) {
-		delete []list;
+		if (!listExternal)
+			delete []list;
 		delete []words;
 		delete []wordsNoCase;
 	}
@@ -101,6 +102,7 @@ void StringList::Clear() {
 	len = 0;
 	sorted = false;
 	sortedNoCase = false;
+	listExternal = false;
 }
 
 void StringList::Set(const char *s) {
@@ -146,6 +148,44 @@ static void SortStringListNoCase(char **wordsNoCase, unsigned int len) {
 	      slCmpStringNoCase);
 }
 
+/**
+ * Use words that are already split and sorted, both with and without case.
+ * The list is not copied or freed so must outlive this object.
+ */
+void StringList::SetFromSorted(char *list_, char **words_, char **wordsNoCase_, int len_) {
+	Clear();
+	list = list_;
+	listExternal = true;
+	words = words_;
+	wordsNoCase = wordsNoCase_;
+	len = len_;
+	sorted = true;
+	sortedNoCase = true;
+	Sort();
+}
+
+/**
+ * Sort now rather than on first use and find where each initial character starts.
+ */
+void StringList::Sort() {
+	if (0 == words)
+		return;
+	if (!sorted) {
+		sorted = true;
+		SortStringList(words, len);
+	}
+	for (unsigned int k = 0; k < (sizeof(starts) / sizeof(starts[0])); k++)
+		starts[k] = -1;
+	for (int l = len - 1; l >= 0; l--) {
+		unsigned char indexChar = words[l][0];
+		starts[indexChar] = l;
+	}
+	if (!sortedNoCase) {
+		sortedNoCase = true;
+		SortStringListNoCase(wordsNoCase, len);
+	}
+}
+
 bool StringList::InList(const char *s) {
 	if (0 == words)
 		return false;
@@ -15,10 +15,11 @@ public:
 	bool onlyLineEnds;	///< Delimited by any white space or only line ends
 	bool sorted;
 	bool sortedNoCase;
+	bool listExternal;	///< list is owned elsewhere, such as by a mapped cache file
 	int starts[256];
 	StringList(bool onlyLineEnds_ = false) :
 		words(0), wordsNoCase(0), list(0), len(0), onlyLineEnds(onlyLineEnds_),
-		sorted(false), sortedNoCase(false) {}
+		sorted(false), sortedNoCase(false), listExternal(false) {}
 	~StringList() { Clear(); }
 	operator bool() const { return len ? true : false; }
 	char *operator[](int ind) { return words[ind]; }
@@ -26,6 +27,8 @@ public:
 	void Set(const char *s);
 	char *Allocate(int size);
 	void SetFromAllocated();
+	void SetFromSorted(char *list_, char **words_, char **wordsNoCase_, int len_);
+	void Sort();
 	bool InList(const char *s);
 	//bool InListAbbreviated(const char *s, const char marker);
 	const char *GetNearestWord(const char *wordStart, size_t searchLen,
@@ -5,6 +5,8 @@
 // Copyright 1998-2010 by Neil Hodgson <neilh@scintilla.org>
 // The License.txt file describes the conditions under which this software may be distributed.
 
+#include <string.h>
+
 #include <string>
 
 #include "Scintilla.h"
@@ -17,18 +19,41 @@ bool TextReader::InternalIsLeadByte(char ch) const {
 
 void TextReader::Fill(int position) {
 	if (lenDoc == -1)
-		lenDoc = sw.Call(SCI_GETTEXTLENGTH, 0, 0);
-	startPos = position - slopSize;
-	if (startPos + bufferSize > lenDoc)
-		startPos = lenDoc - bufferSize;
+		lenDoc = Call(SCI_GETTEXTLENGTH, 0, 0);
+	const int size = directAccess ? directSize : bufferSize;
+	startPos = position - size / 8;
+	if (startPos + size > lenDoc)
+		startPos = lenDoc - size;
 	if (startPos < 0)
 		startPos = 0;
-	endPos = startPos + bufferSize;
+	endPos = startPos + size;
 	if (endPos > lenDoc)
 		endPos = lenDoc;
 
+	if (directAccess) {
+		// Only moves the gap when it is inside the window
+		messagesSent++;
+		text = reinterpret_cast<const char *>(
+			sw.CallReturnPointer(SCI_GETRANGEPOINTER, startPos, endPos - startPos));
+		if (text)
+			return;
+		// Scintilla without SCI_GETRANGEPOINTER returns 0 so copy instead
+		directAccess = false;
+		Fill(position);
+		return;
+	}
+
+	text = buf;
 	Sci_TextRange tr = {{startPos, endPos}, buf};
-	sw.Call(SCI_GETTEXTRANGE, 0, reinterpret_cast<sptr_t>(&tr));
+	Call(SCI_GETTEXTRANGE, 0, reinterpret_cast<sptr_t>(&tr));
+}
+
+/// Forget what was read as it may have moved or changed.
+void TextReader::DocumentModified() {
+	startPos = extremePosition;
+	endPos = 0;
+	lenDoc = -1;
+	text = buf;
 }
 
 bool TextReader::Match(int pos, const char *s) {
@@ -40,39 +65,45 @@ bool TextReader::Match(int pos, const char *s) {
 	return true;
 }
 
+/// Copy the text from @a start up to @a end into @a destination which must have room for a terminating NUL.
+void TextReader::GetRange(int start, int end, char *destination) {
+	Sci_TextRange tr = {{start, end}, destination};
+	Call(SCI_GETTEXTRANGE, 0, reinterpret_cast<sptr_t>(&tr));
+}
+
 char TextReader::StyleAt(int position) {
-	return static_cast<char>(sw.Call(
+	return static_cast<char>(Call(
 		SCI_GETSTYLEAT, position, 0));
 }
 
 int TextReader::GetLine(int position) {
-	return sw.Call(SCI_LINEFROMPOSITION, position, 0);
+	return Call(SCI_LINEFROMPOSITION, position, 0);
 }
 
 int TextReader::LineStart(int line) {
-	return sw.Call(SCI_POSITIONFROMLINE, line, 0);
+	return Call(SCI_POSITIONFROMLINE, line, 0);
 }
 
 int TextReader::LevelAt(int line) {
-	return sw.Call(SCI_GETFOLDLEVEL, line, 0);
+	return Call(SCI_GETFOLDLEVEL, line, 0);
 }
 
 int TextReader::Length() {
 	if (lenDoc == -1)
-		lenDoc = sw.Call(SCI_GETTEXTLENGTH, 0, 0);
+		lenDoc = Call(SCI_GETTEXTLENGTH, 0, 0);
 	return lenDoc;
 }
 
 int TextReader::GetLineState(int line) {
-	return sw.Call(SCI_GETLINESTATE, line);
+	return Call(SCI_GETLINESTATE, line);
 }
 
 int StyleWriter::SetLineState(int line, int state) {
-	return sw.Call(SCI_SETLINESTATE, line, state);
+	return Call(SCI_SETLINESTATE, line, state);
 }
 
 void StyleWriter::StartAt(unsigned int start, char chMask) {
-	sw.Call(SCI_STARTSTYLING, start, chMask);
+	Call(SCI_STARTSTYLING, start, chMask);
 }
 
 void StyleWriter::StartSegment(unsigned int pos) {
@@ -82,28 +113,27 @@ void StyleWriter::StartSegment(unsigned int pos) {
 void StyleWriter::ColourTo(unsigned int pos, int chAttr) {
 	// Only perform styling if non empty range
 	if (pos != startSeg - 1) {
-		if (validLen + (pos - startSeg + 1) >= bufferSize)
+		if (validLen + (pos - startSeg + 1) >= static_cast<unsigned int>(styleBufSize))
 			Flush();
-		if (validLen + (pos - startSeg + 1) >= bufferSize) {
+		if (validLen + (pos - startSeg + 1) >= static_cast<unsigned int>(styleBufSize)) {
 			// Too big for buffer so send directly
-			sw.Call(SCI_SETSTYLING, pos - startSeg + 1, chAttr);
+			Call(SCI_SETSTYLING, pos - startSeg + 1, chAttr);
 		} else {
-			for (unsigned int i = startSeg; i <= pos; i++) {
-				styleBuf[validLen++] = static_cast<char>(chAttr);
-			}
+			memset(styleBuf + validLen, chAttr, pos - startSeg + 1);
+			validLen += pos - startSeg + 1;
 		}
 	}
 	startSeg = pos+1;
 }
 
 void StyleWriter::SetLevel(int line, int level) {
-	sw.Call(SCI_SETFOLDLEVEL, line, level);
+	Call(SCI_SETFOLDLEVEL, line, level);
 }
 
 void StyleWriter::Flush() {
-	startPos = extremePosition;
-	lenDoc = -1;
+	DocumentModified();
 	if (validLen > 0) {
+		messagesSent++;
 		sw.SendPointer(SCI_SETSTYLINGEX, validLen, styleBuf);
 		validLen = 0;
 	}
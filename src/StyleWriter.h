@@ -18,31 +18,43 @@ protected:
 	/** @a bufferSize is a trade off between time taken to copy the characters
 	 * and retrieval overhead.
 	 * @a slopSize positions the buffer before the desired position
-	 * in case there is some backtracking. */
-	enum {bufferSize=4000, slopSize=bufferSize/8};
+	 * in case there is some backtracking.
+	 * @a directSize is the size of the window read in place from the document
+	 * which costs no copying so can be much larger. */
+	enum {bufferSize=4000, slopSize=bufferSize/8, directSize=0x10000};
 	char buf[bufferSize+1];
+	const char *text;	///< Either buf or a window in the document when reading directly
 	int startPos;
 	int endPos;
 	int codePage;
 
 	GUI::ScintillaWindow &sw;
 	int lenDoc;
+	bool directAccess;
+	int messagesSent;
 
 	bool InternalIsLeadByte(char ch) const;
 	void Fill(int position);
+	int Call(unsigned int msg, uptr_t wParam=0, sptr_t lParam=0) {
+		messagesSent++;
+		return sw.Call(msg, wParam, lParam);
+	}
 public:
 	TextReader(GUI::ScintillaWindow &sw_) :
+		text(buf),
 		startPos(extremePosition),
 		endPos(0),
 		codePage(0),
 		sw(sw_),
-		lenDoc(-1) {
+		lenDoc(-1),
+		directAccess(false),
+		messagesSent(0) {
 	}
 	char operator[](int position) {
 		if (position < startPos || position >= endPos) {
 			Fill(position);
 		}
-		return buf[position - startPos];
+		return text[position - startPos];
 	}
 	/** Safe version of operator[], returning a defined value for invalid position. */
 	char SafeGetCharAt(int position, char chDefault=' ') {
@@ -53,7 +65,7 @@ public:
 				return chDefault;
 			}
 		}
-		return buf[position - startPos];
+		return text[position - startPos];
 	}
 	bool IsLeadByte(char ch) const {
 		return codePage && InternalIsLeadByte(ch);
@@ -61,7 +73,19 @@ public:
 	void SetCodePage(int codePage_) {
 		codePage = codePage_;
 	}
+	/** Read the document in place rather than copying it. Only safe when the
+	 * caller calls DocumentModified whenever text is inserted or deleted or the
+	 * gap may have moved, as when anything else reads the document in place. */
+	void SetDirectAccess(bool directAccess_) {
+		directAccess = directAccess_;
+		DocumentModified();
+	}
+	void DocumentModified();
+	int MessagesSent() const {
+		return messagesSent;
+	}
 	bool Match(int pos, const char *s);
+	void GetRange(int start, int end, char *destination);
 	char StyleAt(int position);
 	int GetLine(int position);
 	int LineStart(int line);
@@ -76,14 +100,22 @@ class StyleWriter : public TextReader {
 	StyleWriter(const StyleWriter &source);
 	StyleWriter &operator=(const StyleWriter &);
 protected:
-	char styleBuf[bufferSize];
+	char *styleBuf;
+	int styleBufSize;
 	int validLen;
 	unsigned int startSeg;
 public:
-	StyleWriter(GUI::ScintillaWindow &sw_) :
+	enum {defaultStyleBufferSize=0x10000};
+	StyleWriter(GUI::ScintillaWindow &sw_, int styleBufSize_=defaultStyleBufferSize) :
 		TextReader(sw_),
+		styleBuf(0),
+		styleBufSize(styleBufSize_ > bufferSize ? styleBufSize_ : static_cast<int>(bufferSize)),
 		validLen(0),
 		startSeg(0) {
+		styleBuf = new char[styleBufSize];
+	}
+	~StyleWriter() {
+		delete []styleBuf;
 	}
 	void Flush();
 	int SetLineState(int line, int state);
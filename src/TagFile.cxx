@@ -0,0 +1,296 @@
+// SciTE - Scintilla based Text Editor
+/** @file TagFile.cxx
+ ** Implementation of lookup of symbols in tags files written by ctags.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#if defined(__unix__)
+
+#include <unistd.h>
+
+#else
+
+#undef _WIN32_WINNT
+#define _WIN32_WINNT  0x0500
+#ifdef _MSC_VER
+// windows.h, et al, use a lot of nameless struct/unions - can't fix it, so allow it
+#pragma warning(disable: 4201)
+#endif
+#include <windows.h>
+#ifdef _MSC_VER
+// okay, that's done, don't allow it in our code
+#pragma warning(default: 4201)
+#endif
+
+#endif
+
+#include "Scintilla.h"
+#include "ILexer.h"
+
+#include "GUI.h"
+#include "SString.h"
+#include "FilePath.h"
+#include "Cookie.h"
+#include "Mutex.h"
+#include "Worker.h"
+#include "FileWorker.h"
+#include "MappedFile.h"
+#include "TagFile.h"
+
+static inline unsigned char MakeUpperCase(unsigned char ch) {
+	if (ch < 'a' || ch > 'z')
+		return ch;
+	else
+		return static_cast<unsigned char>(ch - 'a' + 'A');
+}
+
+static inline bool IsEndName(char ch) {
+	return (ch == '\t') || (ch == '\r') || (ch == '\n');
+}
+
+/**
+ * The lines of a tags file: pseudo tags starting with "!_TAG_" then one line
+ * for each tag starting with its name and a tab.
+ */
+class TagLines {
+	const char *data;
+	size_t size;
+public:
+	int sorted;	///< 0 when unsorted, 1 when sorted, 2 when sorted ignoring case
+	size_t start;	///< Position of the first tag after the pseudo tags
+
+	TagLines(const char *data_, size_t size_);
+	size_t NextLine(size_t pos) const {
+		const void *eol = memchr(data + pos, '\n', size - pos);
+		return eol ? static_cast<const char *>(eol) - data + 1 : size;
+	}
+	size_t LineEnd(size_t line) const;
+	size_t NameLength(size_t line) const;
+	int Compare(size_t line, const char *name, size_t lenName) const;
+	size_t LowerBound(const char *name, size_t lenName) const;
+	bool SameName(size_t line, const char *name, size_t lenName) const {
+		return (NameLength(line) == lenName) && (memcmp(data + line, name, lenName) == 0);
+	}
+	std::string Text(size_t line) const {
+		return std::string(data + line, data + LineEnd(line));
+	}
+};
+
+TagLines::TagLines(const char *data_, size_t size_) : data(data_), size(size_), sorted(0), start(0) {
+	// Files without pseudo tags may not be sorted so are searched from end to end
+	static const char pseudoTag[] = "!_TAG_";
+	static const char sortedTag[] = "!_TAG_FILE_SORTED\t";
+	const size_t lenPseudoTag = strlen(pseudoTag);
+	const size_t lenSortedTag = strlen(sortedTag);
+	while ((start + lenPseudoTag <= size) && (memcmp(data + start, pseudoTag, lenPseudoTag) == 0)) {
+		if ((start + lenSortedTag < size) && (memcmp(data + start, sortedTag, lenSortedTag) == 0)) {
+			const char chSorted = data[start + lenSortedTag];
+			if ((chSorted == '1') || (chSorted == '2'))
+				sorted = chSorted - '0';
+		}
+		start = NextLine(start);
+	}
+}
+
+size_t TagLines::LineEnd(size_t line) const {
+	size_t end = NextLine(line);
+	while ((end > line) && ((data[end - 1] == '\n') || (data[end - 1] == '\r')))
+		end--;
+	return end;
+}
+
+size_t TagLines::NameLength(size_t line) const {
+	size_t pos = line;
+	while ((pos < size) && !IsEndName(data[pos]))
+		pos++;
+	return pos - line;
+}
+
+/**
+ * Compare the start of the name of the tag at @a line with @a name, in the order
+ * ctags sorted the file, returning 0 when the tag's name starts with @a name.
+ */
+int TagLines::Compare(size_t line, const char *name, size_t lenName) const {
+	for (size_t i = 0; i < lenName; i++) {
+		// The end of a name sorts before any character of a longer name
+		if ((line + i >= size) || IsEndName(data[line + i]))
+			return -1;
+		unsigned char chTag = static_cast<unsigned char>(data[line + i]);
+		unsigned char chName = static_cast<unsigned char>(name[i]);
+		if (sorted == 2) {
+			chTag = MakeUpperCase(chTag);
+			chName = MakeUpperCase(chName);
+		}
+		if (chTag != chName)
+			return (chTag < chName) ? -1 : 1;
+	}
+	return 0;
+}
+
+/**
+ * Find the first line that does not compare before @a name by bisecting the bytes
+ * of the file then moving to the start of the next line.
+ */
+size_t TagLines::LowerBound(const char *name, size_t lenName) const {
+	// Lines before low compare before name and the line at high, if any, does not
+	size_t low = start;
+	size_t high = size;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		size_t line = ((middle == low) || (data[middle - 1] == '\n')) ? middle : NextLine(middle);
+		if (line >= high)
+			line = low;
+		if (Compare(line, name, lenName) < 0)
+			low = NextLine(line);
+		else
+			high = line;
+	}
+	return low;
+}
+
+bool TagEntry::Parse(const char *line, size_t len) {
+	const char *end = line + len;
+	const char *tabName = static_cast<const char *>(memchr(line, '\t', len));
+	if (!tabName)
+		return false;
+	const char *startFile = tabName + 1;
+	const char *tabFile = static_cast<const char *>(memchr(startFile, '\t', end - startFile));
+	if (!tabFile)
+		return false;
+	name.assign(line, tabName);
+	file.assign(startFile, tabFile);
+	// The address ends with ;" when followed by extension fields
+	const char *startAddress = tabFile + 1;
+	const char *endAddress = end;
+	for (const char *s = startAddress; s + 1 < end; s++) {
+		if ((s[0] == ';') && (s[1] == '\"') && ((s + 2 == end) || (s[2] == '\t'))) {
+			endAddress = s;
+			break;
+		}
+	}
+	address.assign(startAddress, endAddress);
+	kind = "";
+	if (endAddress + 3 < end) {
+		const char *startKind = endAddress + 3;
+		const char *endKind = static_cast<const char *>(memchr(startKind, '\t', end - startKind));
+		kind.assign(startKind, endKind ? endKind : end);
+		if (kind.find("kind:") == 0)
+			kind.erase(0, 5);
+		else if (kind.find(':') != std::string::npos)
+			kind = "";
+	}
+	return true;
+}
+
+/// Return the line number of the tag or 0 when it is found by pattern.
+int TagEntry::Line() const {
+	if (address.empty() || (address.find_first_not_of("0123456789") != std::string::npos))
+		return 0;
+	return atoi(address.c_str());
+}
+
+/**
+ * Return the text of a /^...$/ or ?^...$? search pattern with the anchors and
+ * escapes removed or an empty string when the address is not a pattern.
+ */
+std::string TagEntry::Pattern() const {
+	if ((address.length() < 2) || ((address[0] != '/') && (address[0] != '?')) ||
+		(address[address.length() - 1] != address[0]))
+		return std::string();
+	size_t startPattern = 1;
+	size_t endPattern = address.length() - 1;
+	if (address[startPattern] == '^')
+		startPattern++;
+	if ((endPattern > startPattern) && (address[endPattern - 1] == '$') &&
+		((endPattern - 1 == startPattern) || (address[endPattern - 2] != '\\')))
+		endPattern--;
+	std::string pattern;
+	for (size_t i = startPattern; i < endPattern; i++) {
+		if ((address[i] == '\\') && (i + 1 < endPattern))
+			i++;
+		pattern += address[i];
+	}
+	return pattern;
+}
+
+TagFile::TagFile(const FilePath &path_) : path(path_) {
+}
+
+/**
+ * Return the lines of up to @a maxTags tags named @a name or, when @a prefix is true,
+ * with names starting with @a name. When @a maxTags is 0, return all of them.
+ */
+std::vector<std::string> TagFile::Find(const char *name, size_t lenName, bool prefix, size_t maxTags) const {
+	std::vector<std::string> tags;
+	MappedFile file;
+	if (!file.Open(path.AsInternal()))
+		return tags;
+	TagLines lines(file.Data(), file.Size());
+	size_t line = lines.sorted ? lines.LowerBound(name, lenName) : lines.start;
+	while ((line < file.Size()) && (!maxTags || (tags.size() < maxTags))) {
+		const int comparison = lines.Compare(line, name, lenName);
+		if (comparison == 0) {
+			if (prefix || lines.SameName(line, name, lenName))
+				tags.push_back(lines.Text(line));
+		} else if (lines.sorted && (comparison > 0)) {
+			break;
+		}
+		line = lines.NextLine(line);
+	}
+	return tags;
+}
+
+TagsRefresher::TagsRefresher(WorkerListener *pListener_, const GUI::gui_string &command_, const GUI::gui_string &directory_) :
+	pListener(pListener_), command(command_), directory(directory_), mutex(Mutex::Create()), stopping(false) {
+}
+
+TagsRefresher::~TagsRefresher() {
+	// The thread may still be leaving Execute after telling the listener
+	{
+		Lock lock(mutex);
+	}
+	delete mutex;
+}
+
+void TagsRefresher::Execute() {
+	CommandExecute(command.c_str(), directory.c_str());
+	Lock lock(mutex);
+	completed = true;
+	if (!stopping)
+		pListener->PostOnMainThread(WORK_TAGSREFRESHED, this);
+}
+
+static void WaitBriefly() {
+#ifdef __unix__
+	usleep(1000);
+#else
+	::Sleep(1);
+#endif
+}
+
+/**
+ * Called when the listener is going away so it is not told when the command finishes.
+ * Waits up to @a seconds for the command and returns false if it is still running,
+ * in which case the refresher is still in use and must not be deleted.
+ */
+bool TagsRefresher::Stop(double seconds) {
+	{
+		Lock lock(mutex);
+		stopping = true;
+	}
+	GUI::ElapsedTime waited;
+	while (!FinishedJob()) {
+		if (waited.Duration() > seconds)
+			return false;
+		WaitBriefly();
+	}
+	return true;
+}
@@ -0,0 +1,56 @@
+// SciTE - Scintilla based Text Editor
+/** @file TagFile.h
+ ** Definition of lookup of symbols in tags files written by ctags.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef TAGFILE_H
+#define TAGFILE_H
+
+/// The fields of one line of a tags file.
+struct TagEntry {
+	std::string name;
+	std::string file;
+	std::string address;	///< Line number or search pattern such as /^int main()$/
+	std::string kind;
+
+	bool Parse(const char *line, size_t len);
+	int Line() const;
+	std::string Pattern() const;
+};
+
+/**
+ * A tags file is mapped into memory for each lookup and, when ctags has recorded that
+ * it is sorted, searched by bisection so that even very large files are fast to search
+ * and little of them is read. As the file is only mapped during a lookup, it may
+ * be rewritten at other times.
+ */
+class TagFile {
+	FilePath path;
+public:
+	explicit TagFile(const FilePath &path_);
+	const FilePath &Path() const {
+		return path;
+	}
+	std::vector<std::string> Find(const char *name, size_t lenName, bool prefix, size_t maxTags) const;
+};
+
+/**
+ * Runs a command, such as ctags, on a thread to rewrite a tags file then
+ * tells the listener.
+ */
+struct TagsRefresher : public Worker {
+	WorkerListener *pListener;
+	GUI::gui_string command;
+	GUI::gui_string directory;
+	Mutex *mutex;
+	bool stopping;	///< Guarded by mutex, set when the listener is going away
+
+	TagsRefresher(WorkerListener *pListener_, const GUI::gui_string &command_, const GUI::gui_string &directory_);
+	~TagsRefresher();
+	virtual void Execute();
+	bool Stop(double seconds);
+};
+
+#endif
@@ -0,0 +1,337 @@
+// SciTE - Scintilla based Text Editor
+/** @file WordIndex.cxx
+ ** Implementation of an incrementally maintained index of the words in a document.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+
+#include "Mutex.h"
+#include "FuzzyMatch.h"
+#include "WordIndex.h"
+
+static inline char MakeLowerCase(char ch) {
+	if (ch < 'A' || ch > 'Z')
+		return ch;
+	else
+		return static_cast<char>(ch - 'A' + 'a');
+}
+
+static std::string LowerCased(const std::string &s) {
+	std::string ret(s);
+	for (size_t i = 0; i < ret.length(); i++)
+		ret[i] = MakeLowerCase(ret[i]);
+	return ret;
+}
+
+static bool StartsWith(const std::string &s, const char *prefix, size_t lenPrefix) {
+	return (s.length() >= lenPrefix) && (s.compare(0, lenPrefix, prefix, lenPrefix) == 0);
+}
+
+// Longer bracketed text is unlikely to be a parameter list
+static const size_t maxSignatureLength = 200;
+
+WordIndex::WordIndex(SymbolIndex *shared_) : built(false), shared(shared_) {
+	for (int i = 0; i < 256; i++) {
+		wordChar[i] = false;
+		paramStart[i] = false;
+		paramEnd[i] = false;
+	}
+}
+
+WordIndex::~WordIndex() {
+	Clear();
+}
+
+/**
+ * Words are runs of the given characters. Changing the set of characters
+ * invalidates the index.
+ */
+void WordIndex::SetWordCharacters(const char *wordCharacters_) {
+	if (wordCharacters != wordCharacters_) {
+		wordCharacters = wordCharacters_;
+		for (int i = 0; i < 256; i++)
+			wordChar[i] = false;
+		for (const char *wc = wordCharacters_; *wc; wc++)
+			wordChar[static_cast<unsigned char>(*wc)] = true;
+		Clear();
+	}
+}
+
+/**
+ * Signatures are only found when the characters that start and end parameter
+ * lists are set. Changing them invalidates the index.
+ */
+void WordIndex::SetParameterCharacters(const char *start, const char *end) {
+	std::string parameterCharacters_ = std::string(start) + '\n' + end;
+	if (parameterCharacters != parameterCharacters_) {
+		parameterCharacters = parameterCharacters_;
+		for (int i = 0; i < 256; i++) {
+			paramStart[i] = false;
+			paramEnd[i] = false;
+		}
+		for (const char *ps = start; *ps; ps++)
+			paramStart[static_cast<unsigned char>(*ps)] = true;
+		for (const char *pe = end; *pe; pe++)
+			paramEnd[static_cast<unsigned char>(*pe)] = true;
+		Clear();
+	}
+}
+
+void WordIndex::Clear() {
+	if (shared) {
+		for (WordEntries::const_iterator it = words.begin(); it != words.end(); ++it)
+			shared->RemoveWord(it->first);
+		for (WordCounts::const_iterator its = signatures.begin(); its != signatures.end(); ++its)
+			shared->RemoveSignature(its->first);
+	}
+	built = false;
+	words.clear();
+	folded.clear();
+	signatures.clear();
+}
+
+void WordIndex::AddWord(const std::string &word) {
+	Entry &entry = words[word];
+	if (entry.count++ == 0) {
+		entry.mask = FuzzyCharacterMask(word.c_str(), word.length());
+		folded.insert(std::make_pair(LowerCased(word), word));
+		if (shared)
+			shared->AddWord(word);
+	}
+}
+
+void WordIndex::RemoveWord(const std::string &word) {
+	WordEntries::iterator it = words.find(word);
+	if (it != words.end()) {
+		if (--it->second.count <= 0) {
+			folded.erase(std::make_pair(LowerCased(word), word));
+			words.erase(it);
+			if (shared)
+				shared->RemoveWord(word);
+		}
+	}
+}
+
+void WordIndex::AddSignature(const std::string &signature) {
+	if (signatures[signature]++ == 0) {
+		if (shared)
+			shared->AddSignature(signature);
+	}
+}
+
+void WordIndex::RemoveSignature(const std::string &signature) {
+	WordCounts::iterator it = signatures.find(signature);
+	if (it != signatures.end()) {
+		if (--it->second <= 0) {
+			signatures.erase(it);
+			if (shared)
+				shared->RemoveSignature(signature);
+		}
+	}
+}
+
+static inline bool IsLineEnd(char ch) {
+	return (ch == '\r') || (ch == '\n');
+}
+
+static inline bool IsSpaceOrTab(char ch) {
+	return (ch == ' ') || (ch == '\t');
+}
+
+/**
+ * If the word from @a start to @a end starts a definition like "int max(int a, int b)"
+ * return the end of its parameter list, otherwise 0.
+ * Definitions follow another word on the same line and end their line or are
+ * followed by '{' or ':' which excludes most calls.
+ */
+size_t WordIndex::SignatureEnd(const char *text, size_t len, size_t start, size_t end) const {
+	if ((text[start] >= '0') && (text[start] <= '9'))
+		return 0;
+	size_t before = start;
+	while ((before > 0) && (IsSpaceOrTab(text[before - 1]) ||
+		(text[before - 1] == '*') || (text[before - 1] == '&')))
+		before--;
+	if ((before == start) || (before == 0) || !IsWordCharacter(text[before - 1]))
+		return 0;
+	size_t pos = end;
+	while ((pos < len) && IsSpaceOrTab(text[pos]))
+		pos++;
+	if ((pos >= len) || !paramStart[static_cast<unsigned char>(text[pos])])
+		return 0;
+	int depth = 0;
+	for (; (pos < len) && !IsLineEnd(text[pos]) && (pos - start < maxSignatureLength); pos++) {
+		const unsigned char ch = text[pos];
+		if (paramStart[ch]) {
+			depth++;
+		} else if (paramEnd[ch]) {
+			if (--depth == 0)
+				break;
+		}
+	}
+	if ((pos >= len) || (depth != 0))
+		return 0;
+	const size_t endSignature = pos + 1;
+	pos = endSignature;
+	while ((pos < len) && IsSpaceOrTab(text[pos]))
+		pos++;
+	if ((pos < len) && !IsLineEnd(text[pos]) && (text[pos] != '{') && (text[pos] != ':'))
+		return 0;
+	return endSignature;
+}
+
+void WordIndex::Scan(const char *text, size_t len, bool adding) {
+	const bool findSignatures = !parameterCharacters.empty() && (parameterCharacters[0] != '\n');
+	size_t i = 0;
+	while (i < len) {
+		while ((i < len) && !IsWordCharacter(text[i]))
+			i++;
+		const size_t start = i;
+		while ((i < len) && IsWordCharacter(text[i]))
+			i++;
+		if (i > start) {
+			const std::string word(text + start, i - start);
+			if (adding)
+				AddWord(word);
+			else
+				RemoveWord(word);
+			const size_t endSignature = findSignatures ? SignatureEnd(text, len, start, i) : 0;
+			if (endSignature) {
+				const std::string signature(text + start, endSignature - start);
+				if (adding)
+					AddSignature(signature);
+				else
+					RemoveSignature(signature);
+			}
+		}
+	}
+}
+
+void WordIndex::Build(const char *text, size_t len) {
+	Clear();
+	Insert(text, len);
+	built = true;
+}
+
+void WordIndex::Insert(const char *text, size_t len) {
+	Scan(text, len, true);
+}
+
+void WordIndex::Remove(const char *text, size_t len) {
+	Scan(text, len, false);
+}
+
+int WordIndex::Count(const char *word) const {
+	WordEntries::const_iterator it = words.find(word);
+	return (it != words.end()) ? it->second.count : 0;
+}
+
+/**
+ * Return the words that start with, and are longer than, @a root in sorted order.
+ * When @a maxWords is not 0, stop after that many words.
+ */
+std::vector<std::string> WordIndex::Complete(const char *root, size_t lenRoot, bool ignoreCase, size_t maxWords) const {
+	std::vector<std::string> found;
+	if (ignoreCase) {
+		const std::string rootLower = LowerCased(std::string(root, lenRoot));
+		FoldedWords::const_iterator it = folded.lower_bound(std::make_pair(rootLower, std::string()));
+		for (; (it != folded.end()) && StartsWith(it->first, rootLower.c_str(), lenRoot); ++it) {
+			if (it->second.length() > lenRoot) {
+				found.push_back(it->second);
+				if (maxWords && (found.size() >= maxWords))
+					break;
+			}
+		}
+	} else {
+		WordEntries::const_iterator it = words.lower_bound(std::string(root, lenRoot));
+		for (; (it != words.end()) && StartsWith(it->first, root, lenRoot); ++it) {
+			if (it->first.length() > lenRoot) {
+				found.push_back(it->first);
+				if (maxWords && (found.size() >= maxWords))
+					break;
+			}
+		}
+	}
+	return found;
+}
+
+SymbolIndex::SymbolIndex() : mutex(Mutex::Create()) {
+}
+
+SymbolIndex::~SymbolIndex() {
+	delete mutex;
+}
+
+void SymbolIndex::AddWord(const std::string &word) {
+	Lock lock(mutex);
+	words.AddWord(word);
+}
+
+void SymbolIndex::RemoveWord(const std::string &word) {
+	Lock lock(mutex);
+	words.RemoveWord(word);
+}
+
+void SymbolIndex::AddSignature(const std::string &signature) {
+	Lock lock(mutex);
+	signatures[signature]++;
+}
+
+void SymbolIndex::RemoveSignature(const std::string &signature) {
+	Lock lock(mutex);
+	WordIndex::WordCounts::iterator it = signatures.find(signature);
+	if ((it != signatures.end()) && (--it->second <= 0))
+		signatures.erase(it);
+}
+
+/// The number of documents containing @a word.
+int SymbolIndex::Count(const char *word) {
+	Lock lock(mutex);
+	return words.Count(word);
+}
+
+size_t SymbolIndex::Size() {
+	Lock lock(mutex);
+	return words.Size();
+}
+
+std::vector<std::string> SymbolIndex::Complete(const char *root, size_t lenRoot, bool ignoreCase, size_t maxWords) {
+	Lock lock(mutex);
+	return words.Complete(root, lenRoot, ignoreCase, maxWords);
+}
+
+/**
+ * Add every word except @a exclude to @a ranking and return its best words.
+ * Done while locked as the ranking points into the index.
+ */
+std::vector<std::string> SymbolIndex::Rank(FuzzyRanking &ranking, const std::string &exclude, size_t maxWords) {
+	Lock lock(mutex);
+	const WordIndex::WordEntries &entries = words.Words();
+	for (WordIndex::WordEntries::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+		const std::string &word = it->first;
+		if (word != exclude)
+			ranking.Consider(word.c_str(), word.length(), it->second.mask);
+	}
+	return ranking.Best(maxWords);
+}
+
+/**
+ * The signatures of functions called @a name in sorted order.
+ */
+std::vector<std::string> SymbolIndex::Signatures(const char *name, size_t lenName, const char *parameterStart) {
+	Lock lock(mutex);
+	std::vector<std::string> found;
+	WordIndex::WordCounts::const_iterator it = signatures.lower_bound(std::string(name, lenName));
+	for (; (it != signatures.end()) && StartsWith(it->first, name, lenName); ++it) {
+		const char chNext = it->first[lenName];
+		if (IsSpaceOrTab(chNext) || (chNext && strchr(parameterStart, chNext)))
+			found.push_back(it->first);
+	}
+	return found;
+}
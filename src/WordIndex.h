@@ -0,0 +1,107 @@
+// SciTE - Scintilla based Text Editor
+/** @file WordIndex.h
+ ** Definition of an incrementally maintained index of the words in a document.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef WORDINDEX_H
+#define WORDINDEX_H
+
+class SymbolIndex;
+
+/**
+ * Counts the occurrences of each word of a document so that words starting with
+ * a prefix can be found without searching the document.
+ * The index is filled once with Build and then kept up to date by removing the
+ * text around each modification before it changed and adding the text after.
+ * Function signatures, a word followed by a bracketed parameter list on one line
+ * that appears to be a definition, are counted too.
+ * When there is a shared SymbolIndex, it is told of each word and signature
+ * that enters or leaves this index.
+ */
+class WordIndex {
+public:
+	typedef std::map<std::string, int> WordCounts;
+	struct Entry {
+		int count;
+		unsigned int mask;	///< FuzzyCharacterMask of the word, found once when it is added
+		Entry() : count(0), mask(0) {
+		}
+	};
+	typedef std::map<std::string, Entry> WordEntries;
+private:
+	typedef std::set<std::pair<std::string, std::string> > FoldedWords;
+	bool wordChar[256];
+	bool paramStart[256];
+	bool paramEnd[256];
+	std::string wordCharacters;
+	std::string parameterCharacters;
+	bool built;
+	WordEntries words;
+	FoldedWords folded;	///< (lower case word, word) pairs for case insensitive searches
+	WordCounts signatures;
+	SymbolIndex *shared;
+	void AddSignature(const std::string &signature);
+	void RemoveSignature(const std::string &signature);
+	size_t SignatureEnd(const char *text, size_t len, size_t start, size_t end) const;
+	void Scan(const char *text, size_t len, bool adding);
+	// Private so WordIndex objects can not be copied
+	WordIndex(const WordIndex &);
+	WordIndex &operator=(const WordIndex &);
+public:
+	explicit WordIndex(SymbolIndex *shared_=0);
+	~WordIndex();
+	void SetWordCharacters(const char *wordCharacters_);
+	void SetParameterCharacters(const char *start, const char *end);
+	bool IsWordCharacter(char ch) const {
+		return wordChar[static_cast<unsigned char>(ch)];
+	}
+	bool IsBuilt() const {
+		return built;
+	}
+	void Clear();
+	void Build(const char *text, size_t len);
+	void Insert(const char *text, size_t len);
+	void Remove(const char *text, size_t len);
+	void AddWord(const std::string &word);
+	void RemoveWord(const std::string &word);
+	int Count(const char *word) const;
+	size_t Size() const {
+		return words.size();
+	}
+	const WordEntries &Words() const {
+		return words;
+	}
+	std::vector<std::string> Complete(const char *root, size_t lenRoot, bool ignoreCase, size_t maxWords=0) const;
+};
+
+class FuzzyRanking;
+
+/**
+ * Words and signatures of all the documents with a WordIndex, each counted once for
+ * every document that contains it so a document's contributions disappear with it.
+ * Access is serialised by a mutex so the index may be read from other threads.
+ */
+class SymbolIndex {
+	Mutex *mutex;
+	WordIndex words;
+	WordIndex::WordCounts signatures;
+	// Private so SymbolIndex objects can not be copied
+	SymbolIndex(const SymbolIndex &);
+	SymbolIndex &operator=(const SymbolIndex &);
+public:
+	SymbolIndex();
+	~SymbolIndex();
+	void AddWord(const std::string &word);
+	void RemoveWord(const std::string &word);
+	void AddSignature(const std::string &signature);
+	void RemoveSignature(const std::string &signature);
+	int Count(const char *word);
+	size_t Size();
+	std::vector<std::string> Complete(const char *root, size_t lenRoot, bool ignoreCase, size_t maxWords=0);
+	std::vector<std::string> Rank(FuzzyRanking &ranking, const std::string &exclude, size_t maxWords);
+	std::vector<std::string> Signatures(const char *name, size_t lenName, const char *parameterStart);
+};
+
+#endif
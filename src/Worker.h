@@ -27,5 +27,6 @@ struct Worker {
 };
 
 struct WorkerListener {
+	virtual bool PerformOnNewThread(Worker *pWorker) = 0;
 	virtual void PostOnMainThread(int cmd, Worker *pWorker) = 0;
 };
@@ -622,7 +622,7 @@ void SciTEWin::Command(WPARAM wParam, LPARAM lParam) {
 	case IDM_FINISHEDEXECUTE: {
 			jobQueue.SetExecuting(false);
 			if (needReadProperties)
-				ReadProperties();
+				ReadChangedProperties();
 			CheckMenus();
 			jobQueue.ClearJobs();
 			CheckReload();
@@ -706,7 +706,7 @@ void SciTEWin::ResetExecution() {
 	cmdWorker.Initialise(true);
 	jobQueue.SetExecuting(false);
 	if (needReadProperties)
-		ReadProperties();
+		ReadChangedProperties();
 	CheckReload();
 	CheckMenus();
 	jobQueue.ClearJobs();
@@ -1428,7 +1428,10 @@ void SciTEWin::Run(const GUI::gui_char *cmdLine) {
 	// and the Scintilla control is thus created, allowing to print the file(s).
 	// We don't show it yet, so if it is destroyed (duplicate instance), it will
 	// not flash on the taskbar or on the display.
-	CreateUI();
+	{
+		StartupPhase phase("CreateUI");
+		CreateUI();
+	}
 
 	if (bBatchProcessing) {
 		// Reprocess the command line and read the files
@@ -1460,8 +1463,13 @@ void SciTEWin::Run(const GUI::gui_char *cmdLine) {
 	// The filenames containing spaces must be enquoted.
 	// In case of not using buffers they get closed immediately except
 	// the last one, but they move to the MRU file list
-	ProcessCommandLine(args, 1);
+	{
+		StartupPhase phase("ProcessCommandLine");
+		ProcessCommandLine(args, 1);
+	}
 	Redraw();
+
+	StartupProfile::Report();
 }
 
 /**
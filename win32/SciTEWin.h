@@ -76,6 +76,7 @@ typedef HANDLE HTHEME;
 #include "Cookie.h"
 #include "Worker.h"
 #include "FileWorker.h"
+#include "StartupProfile.h"
 #include "SciTEBase.h"
 #include "SciTEKeys.h"
 #include "UniqueInstance.h"
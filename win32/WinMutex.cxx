@@ -24,3 +24,17 @@ private:
 Mutex *Mutex::Create() {
    return new WinMutex();
 }
+
+class WinEvent : public Event {
+private:
+	HANDLE event;
+	virtual void Signal() { ::SetEvent(event); }
+	virtual bool Wait(int milliseconds) { return ::WaitForSingleObject(event, milliseconds) == WAIT_OBJECT_0; }
+	WinEvent() { event = ::CreateEvent(NULL, FALSE, FALSE, NULL); }
+	virtual ~WinEvent() { ::CloseHandle(event); }
+	friend class Event;
+};
+
+Event *Event::Create() {
+   return new WinEvent();
+}
@@ -65,6 +65,14 @@ OBJS=\
 	PropSetFile.obj \
 	StringHelpers.obj \
 	StringList.obj \
+	ImportPrefetch.obj \
+	StartupProfile.obj \
+	PropertiesCache.obj \
+	TagFile.obj \
+	MappedFile.obj \
+	APICache.obj \
+	FuzzyMatch.obj \
+	WordIndex.obj \
 	SciTEProps.obj \
 	Utf8_16.obj \
 	SciTEWin.obj \
@@ -93,6 +101,14 @@ OBJSSTATIC=\
 	PropSetFile.obj \
 	StringHelpers.obj \
 	StringList.obj \
+	ImportPrefetch.obj \
+	StartupProfile.obj \
+	PropertiesCache.obj \
+	TagFile.obj \
+	MappedFile.obj \
+	APICache.obj \
+	FuzzyMatch.obj \
+	WordIndex.obj \
 	SciTEProps.obj \
 	Utf8_16.obj \
 	Sc1.obj \
@@ -293,6 +309,7 @@ SciTEWin.obj: \
 	../src/SciTE.h \
 	../src/Mutex.h \
 	../src/JobQueue.h \
+	../src/StartupProfile.h \
 	../src/SciTEBase.h \
 	../src/SciTEKeys.h \
 	UniqueInstance.h \
@@ -337,6 +354,7 @@ SciTEWinBar.obj: \
 	../src/SciTE.h \
 	../src/Mutex.h \
 	../src/JobQueue.h \
+	../src/StartupProfile.h \
 	../src/SciTEBase.h \
 	../src/SciTEKeys.h \
 	UniqueInstance.h
@@ -355,6 +373,7 @@ SciTEWinDlg.obj: \
 	../src/SciTE.h \
 	../src/Mutex.h \
 	../src/JobQueue.h \
+	../src/StartupProfile.h \
 	../src/SciTEBase.h \
 	../src/SciTEKeys.h \
 	UniqueInstance.h
@@ -420,6 +439,10 @@ PropSetFile.obj: \
 	../src/GUI.h \
 	../src/SString.h \
 	../src/FilePath.h \
+	../src/StartupProfile.h \
+	../src/Mutex.h \
+	../src/Worker.h \
+	../src/ImportPrefetch.h \
 	../src/PropSetFile.h
 SciTEBase.obj: \
 	../src/SciTEBase.cxx \
@@ -437,6 +460,12 @@ SciTEBase.obj: \
 	../src/Mutex.h \
 	../src/JobQueue.h \
 	../src/Worker.h \
+	../src/WordIndex.h \
+	../src/FuzzyMatch.h \
+	../src/APICache.h \
+	../src/MappedFile.h \
+	../src/TagFile.h \
+	../src/ImportPrefetch.h \
 	../src/SciTEBase.h
 FileWorker.obj: \
 	../src/FileWorker.cxx \
@@ -483,6 +512,7 @@ SciTEBuffers.obj: \
 	../src/SciTE.h \
 	../src/Mutex.h \
 	../src/JobQueue.h \
+	../src/StartupProfile.h \
 	../src/SciTEBase.h
 SciTEIO.obj: \
 	../src/SciTEIO.cxx \
@@ -500,6 +530,7 @@ SciTEIO.obj: \
 	../src/JobQueue.h \
 	../src/SciTEBase.h \
 	../src/Cookie.h \
+	../src/TagFile.h \
 	../src/Utf8_16.h
 SciTEProps.obj: \
 	../src/SciTEProps.cxx \
@@ -517,11 +548,77 @@ SciTEProps.obj: \
 	../src/IFaceTable.h \
 	../src/Mutex.h \
 	../src/JobQueue.h \
+	../src/FuzzyMatch.h \
+	../src/APICache.h \
+	../src/MappedFile.h \
+	../src/PropertiesCache.h \
+	../src/StartupProfile.h \
+	../src/ImportPrefetch.h \
 	../src/SciTEBase.h
 StringList.obj: \
 	../src/StringList.cxx \
 	../src/SString.h \
 	../src/StringList.h
+WordIndex.obj: \
+	../src/WordIndex.cxx \
+	../src/Mutex.h \
+	../src/FuzzyMatch.h \
+	../src/WordIndex.h
+FuzzyMatch.obj: \
+	../src/FuzzyMatch.cxx \
+	../src/FuzzyMatch.h
+APICache.obj: \
+	../src/APICache.cxx \
+	../../scintilla/include/Scintilla.h \
+	../src/GUI.h \
+	../src/SString.h \
+	../src/StringList.h \
+	../src/MappedFile.h \
+	../src/APICache.h
+MappedFile.obj: \
+	../src/MappedFile.cxx \
+	../../scintilla/include/Scintilla.h \
+	../src/GUI.h \
+	../src/MappedFile.h
+TagFile.obj: \
+	../src/TagFile.cxx \
+	../../scintilla/include/Scintilla.h \
+	../../scintilla/include/ILexer.h \
+	../src/GUI.h \
+	../src/SString.h \
+	../src/FilePath.h \
+	../src/Cookie.h \
+	../src/Worker.h \
+	../src/FileWorker.h \
+	../src/MappedFile.h \
+	../src/Mutex.h \
+	../src/TagFile.h
+PropertiesCache.obj: \
+	../src/PropertiesCache.cxx \
+	../../scintilla/include/Scintilla.h \
+	../src/GUI.h \
+	../src/SString.h \
+	../src/FilePath.h \
+	../src/PropSetFile.h \
+	../src/MappedFile.h \
+	../src/PropertiesCache.h \
+	../src/SciTE.h
+StartupProfile.obj: \
+	../src/StartupProfile.cxx \
+	../../scintilla/include/Scintilla.h \
+	../src/GUI.h \
+	../src/StartupProfile.h \
+	../src/SciTE.h
+ImportPrefetch.obj: \
+	../src/ImportPrefetch.cxx \
+	../../scintilla/include/Scintilla.h \
+	../src/GUI.h \
+	../src/SString.h \
+	../src/FilePath.h \
+	../src/PropSetFile.h \
+	../src/Mutex.h \
+	../src/Worker.h \
+	../src/ImportPrefetch.h
 StyleWriter.obj: \
 	../src/StyleWriter.cxx \
 	../../scintilla/include/Scintilla.h \
@@ -535,12 +632,18 @@ Utf8_16.obj: \
 LuaExtension.obj: \
 	../src/LuaExtension.cxx \
 	../../scintilla/include/Scintilla.h \
+	../../scintilla/include/ILexer.h \
 	../src/GUI.h \
 	../src/SString.h \
 	../src/StyleWriter.h \
 	../src/Extender.h \
 	../src/LuaExtension.h \
 	../src/IFaceTable.h \
+	../src/StartupProfile.h \
+	../src/Cookie.h \
+	../src/Mutex.h \
+	../src/Worker.h \
+	../src/FileWorker.h \
 	../src/SciTEKeys.h
 
 IFaceTable.obj: \